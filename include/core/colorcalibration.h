@@ -0,0 +1,109 @@
+#pragma once
+
+#include <QVector>
+#include <QColor>
+#include <QRgb>
+#include <QRgba64>
+#include <QJsonObject>
+
+/**
+ * @brief Ausgabekalibrierung eines Geräts (Gamma, Weißpunkt und Kanalverstärkung)
+ *
+ * Die Einstellungen werden einmalig in Tabellen je Kanal übersetzt: 8 Bit auf 16 Bit für
+ * die genaue Weiterverarbeitung und 8 Bit auf 8 Bit, bereits an die Bitposition des
+ * Kanals im QRgb verschoben. Ein Frame wird so in einem verzweigungsfreien Durchlauf mit
+ * drei Tabellenzugriffen je LED kalibriert. Eine neutrale Kalibrierung wird erkannt und
+ * vom RGBController gar nicht erst angewendet.
+ */
+class ColorCalibration
+{
+public:
+    /**
+     * @brief Einstellungen der Kalibrierung
+     */
+    struct Settings {
+        double gamma = 1.0;             // Exponent auf den normierten Kanalwert
+        QColor whitePoint = Qt::white;  // Ausgabe für reines Weiß
+        double redGain = 1.0;           // Zusätzliche Verstärkung je Kanal (0..1)
+        double greenGain = 1.0;
+        double blueGain = 1.0;
+    };
+    
+    /**
+     * @brief Konstruktor für eine neutrale Kalibrierung
+     */
+    ColorCalibration();
+    
+    /**
+     * @brief Konstruktor
+     * @param settings Einstellungen
+     */
+    explicit ColorCalibration(const Settings &settings);
+    
+    /**
+     * @brief Gibt die Einstellungen zurück
+     * @return Einstellungen
+     */
+    const Settings &settings() const;
+    
+    /**
+     * @brief Prüft, ob die Kalibrierung jeden Wert unverändert lässt
+     * @return true wenn neutral
+     */
+    bool isIdentity() const;
+    
+    /**
+     * @brief Kalibriert eine Farbe
+     * @param color Farbe
+     * @return Kalibrierte Farbe (Alpha bleibt erhalten)
+     */
+    QRgb apply(QRgb color) const;
+    
+    /**
+     * @brief Kalibriert eine Farbe mit 16 Bit pro Kanal
+     *
+     * Zwischen den Einträgen der 16-Bit-Tabellen wird linear interpoliert.
+     * @param color Farbe
+     * @return Kalibrierte Farbe (Alpha bleibt erhalten)
+     */
+    QRgba64 apply(QRgba64 color) const;
+    
+    /**
+     * @brief Kalibriert einen Frame
+     * @param frame Eine Farbe pro LED
+     * @param output Ziel, wird auf die Größe des Frames gebracht (Puffer wird wiederverwendet)
+     */
+    void apply(const QVector<QRgb> &frame, QVector<QRgb> &output) const;
+    
+    /**
+     * @brief Gibt die 16-Bit-Tabelle eines Kanals zurück
+     * @param channel 0 für Rot, 1 für Grün, 2 für Blau
+     * @return 256 Einträge von 0 bis 65535
+     */
+    const quint16 *table16(int channel) const;
+    
+    /**
+     * @brief Speichert die Einstellungen als JSON
+     * @return JSON-Objekt
+     */
+    QJsonObject toJson() const;
+    
+    /**
+     * @brief Liest Einstellungen aus JSON; fehlende Werte bleiben neutral
+     * @param json JSON-Objekt (siehe toJson)
+     * @return Kalibrierung
+     */
+    static ColorCalibration fromJson(const QJsonObject &json);
+
+private:
+    /**
+     * @brief Berechnet die Tabellen aus den Einstellungen
+     */
+    void buildTables();
+
+private:
+    Settings m_settings;
+    bool m_identity;
+    quint16 m_table16[3][256];
+    quint32 m_table8[3][256];   // Bereits an die Bitposition des Kanals verschoben
+};
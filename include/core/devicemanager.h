@@ -2,11 +2,16 @@
 
 #include "devices/irgbdeviceplugin.h"
 #include "devices/irgbdevice.h"
+#include "devices/ihotplugdeviceplugin.h"
 #include "devices/asusdevicemanager.h"
+#include "devices/networkdevicemanager.h"
+#include "devices/serialdevicemanager.h"
+#include "core/pluginmetadatacache.h"
 #include <QObject>
 #include <QList>
 #include <QMap>
 #include <QPluginLoader>
+#include <QThreadPool>
 #include <QDir>
 #include <memory>
 
@@ -34,10 +39,36 @@ public:
 
     /**
      * @brief Lädt alle Plugins aus dem plugins/-Ordner
-     * @return Anzahl der erfolgreich geladenen Plugins
+     *
+     * Die Plugins werden parallel auf einem Thread-Pool geladen und initialisiert.
+     * Geräte werden über deviceDiscovered() gemeldet, sobald das jeweilige Plugin fertig ist;
+     * pluginLoadingFinished() signalisiert das Ende des Ladevorgangs.
+     * @return Anzahl der Plugin-Dateien, deren Laden gestartet wurde
      */
     int loadPlugins();
 
+    /**
+     * @brief Prüft, ob gerade Plugins geladen werden
+     * @return true wenn noch Plugins geladen werden, false wenn nicht
+     */
+    bool isLoadingPlugins() const;
+
+    /**
+     * @brief Aktiviert oder deaktiviert ein Plugin
+     *
+     * Deaktivierte Plugins werden beim nächsten Aufruf von loadPlugins() nicht geladen.
+     * @param fileName Dateiname des Plugins (ohne Pfad)
+     * @param enabled true um zu aktivieren, false um zu deaktivieren
+     */
+    void setPluginEnabled(const QString &fileName, bool enabled);
+
+    /**
+     * @brief Prüft, ob ein Plugin aktiviert ist
+     * @param fileName Dateiname des Plugins (ohne Pfad)
+     * @return true wenn aktiviert, false wenn deaktiviert
+     */
+    bool isPluginEnabled(const QString &fileName) const;
+
     /**
      * @brief Gibt eine Liste aller geladenen Plugins zurück
      * @return Liste von Plugin-Pointern
@@ -72,6 +103,17 @@ public:
      */
     int setEffectForAllDevices(const QString &effectName, const QVariantMap &parameters = QVariantMap());
 
+public slots:
+    /**
+     * @brief Sucht inkrementell nach neuen und entfernten Geräten
+     *
+     * Im Gegensatz zu loadPlugins() bleiben Plugins geladen und unveränderte Geräte
+     * erhalten. Neue Geräte werden über deviceDiscovered(), entfernte über
+     * deviceRemoved() gemeldet.
+     * @return Anzahl der hinzugekommenen und entfernten Geräte
+     */
+    int rescanDevices();
+
 signals:
     /**
      * @brief Signal, das ausgelöst wird, wenn ein neues Plugin geladen wurde
@@ -85,11 +127,65 @@ signals:
      */
     void deviceDiscovered(IRGBDevice *device);
 
+    /**
+     * @brief Signal, das ausgelöst wird, wenn ein Gerät entfernt wurde
+     *
+     * Das Gerät ist während der Signalverarbeitung noch gültig, danach nicht mehr.
+     * @param device Das entfernte Gerät
+     */
+    void deviceRemoved(IRGBDevice *device);
+
+    /**
+     * @brief Signal, das ausgelöst wird, wenn alle Plugins geladen wurden
+     * @param loadedPlugins Anzahl der erfolgreich geladenen Plugins
+     */
+    void pluginLoadingFinished(int loadedPlugins);
+
+private:
+    /**
+     * @brief Lädt und initialisiert ein Plugin (läuft auf einem Pool-Thread)
+     * @param loader Loader für die Plugin-Datei
+     */
+    void loadPluginAsync(QPluginLoader *loader);
+
+    /**
+     * @brief Übernimmt ein fertig geladenes Plugin auf dem Hauptthread
+     * @param loader Loader für die Plugin-Datei
+     * @param devicePlugin Geladenes Plugin oder nullptr bei Fehler
+     * @param initialized Ob initialize() erfolgreich war
+     */
+    void finishPluginLoad(QPluginLoader *loader, IRGBDevicePlugin *devicePlugin, bool initialized);
+
+    /**
+     * @brief Registriert ein Gerät und meldet es über deviceDiscovered()
+     * @param device Das Gerät
+     */
+    void addDevice(IRGBDevice *device);
+
+    /**
+     * @brief Meldet ein Gerät ab und löst deviceRemoved() aus
+     * @param deviceId ID des Geräts
+     */
+    void removeDevice(const QString &deviceId);
+
+    /**
+     * @brief Entlädt alle Plugins und vergisst deren Geräte
+     * @param notify Ob für jedes Gerät deviceRemoved() ausgelöst werden soll
+     */
+    void unloadPlugins(bool notify);
+
 private:
+    PluginMetadataCache *m_metadataCache;
+    QThreadPool m_loaderPool;
+    int m_pendingPlugins;
+    int m_loadedPlugins;
     QList<QPluginLoader*> m_pluginLoaders;
+    QList<QPluginLoader*> m_startedLoaders;    // Im Hintergrund geladen, noch nicht übernommen
     QList<IRGBDevicePlugin*> m_plugins;
     QMap<QString, IRGBDevice*> m_devices;
     
     // ASUS-Gerätemanager für integrierte ASUS-Unterstützung
     AsusDeviceManager* m_asusManager;
+    NetworkDeviceManager* m_networkManager;
+    SerialDeviceManager* m_serialManager;
 };
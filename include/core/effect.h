@@ -5,6 +5,11 @@
 #include <QColor>
 #include <QTimer>
 #include <QVariantMap>
+#include <QVector3D>
+#include <QElapsedTimer>
+#include <type_traits>
+#include "core/expression.h"
+#include "core/effectparameters.h"
 
 /**
  * @brief Basisklasse für RGB-Effekte
@@ -25,7 +30,8 @@ public:
         Breathing,  ///< Pulsierender Effekt
         Rainbow,    ///< Regenbogen-Effekt
         Wave,       ///< Welleneffekt
-        Reactive    ///< Reaktiver Effekt
+        Reactive,   ///< Reaktiver Effekt
+        Expression  ///< Benutzerdefinierter Ausdruck
     };
     
     /**
@@ -58,11 +64,84 @@ public:
      */
     virtual QColor getCurrentColor() const = 0;
     
+    /**
+     * @brief Gibt die Farbe des Effekts mit einer Phasenverschiebung zurück
+     *
+     * Wird für Geräte einer Sync-Gruppe verwendet, die versetzt zueinander laufen sollen.
+     * Effekte ohne periodischen Verlauf geben die aktuelle Farbe zurück.
+     * @param phaseOffset Verschiebung als Anteil einer Periode (0.0 - 1.0)
+     * @return Farbe an der verschobenen Position
+     */
+    virtual QColor getColorAtPhase(qreal phaseOffset) const;
+    
+    /**
+     * @brief Gibt an, ob der Effekt einen periodischen Verlauf hat
+     *
+     * Nur periodische Effekte lassen sich räumlich über ein LED-Layout verteilen.
+     * @return true wenn periodisch, false wenn nicht
+     */
+    virtual bool isPeriodic() const;
+    
+    /**
+     * @brief Tastet eine Periode des aktuellen Frames in eine Farbpalette ab
+     *
+     * Positionsabhängige Ausgabe schlägt pro LED nur noch in dieser Palette nach, der
+     * Effekt selbst wird pro Frame also nur size-mal ausgewertet, unabhängig von der LED-Zahl.
+     * @param palette Zielpuffer mit size Einträgen
+     * @param size Anzahl der Paletteneinträge
+     */
+    void renderPalette(QRgb *palette, int size) const;
+    
+    /**
+     * @brief Gibt an, ob der Effekt jede LED einzeln berechnet
+     * @return true wenn renderFrame() pro LED rendert, false wenn nicht
+     */
+    virtual bool rendersPerLed() const;
+    
+    /**
+     * @brief Berechnet eine Farbe pro LED
+     *
+     * Die Standardimplementierung füllt alle LEDs mit der aktuellen Farbe.
+     * @param frame Zielpuffer mit ledCount Einträgen
+     * @param ledCount Anzahl der LEDs
+     * @param positions Normierte LED-Positionen (0.0 - 1.0) oder nullptr, wenn das Gerät nicht im Layout liegt
+     */
+    virtual void renderFrame(QRgb *frame, int ledCount, const QVector3D *positions) const;
+    
+    /**
+     * @brief Setzt einen externen Eingangswert (z.B. Sensorwerte)
+     *
+     * Die Standardimplementierung ignoriert den Wert.
+     * @param name Name des Eingangs ("cpu", "gpu")
+     * @param value Wert
+     */
+    virtual void setInputValue(const QString &name, qreal value);
+    
     /**
      * @brief Setzt Parameter für den Effekt
+     *
+     * Die Map wird einmalig gegen das Schema des Effekts geprüft und in seine
+     * Parameterstruktur übernommen. Ist ein Wert ungültig, bleibt der Effekt unverändert.
+     * @param parameters Parameter-Map
+     * @return true wenn erfolgreich, false wenn ein Wert ungültig war
+     */
+    virtual bool setParameters(const QVariantMap &parameters) = 0;
+    
+    /**
+     * @brief Setzt alle Parameter auf ihre Standardwerte und übernimmt dann die Map
+     *
+     * Wird beim Wiederverwenden eines Effekts aus einem Pool verwendet, damit er sich
+     * wie ein neu erzeugter Effekt verhält. Ungültige Werte behalten ihren Standardwert.
      * @param parameters Parameter-Map
+     * @return true wenn alle Werte gültig waren, false wenn nicht
+     */
+    virtual bool resetParameters(const QVariantMap &parameters) = 0;
+    
+    /**
+     * @brief Gibt die Parameter für die räumliche Ausgabe zurück
+     * @return Layout-Parameter, bei nicht periodischen Effekten die Standardwerte
      */
-    virtual void setParameters(const QVariantMap &parameters);
+    virtual LayoutParameters getLayoutParameters() const;
     
     /**
      * @brief Startet den Effekt
@@ -80,6 +159,20 @@ public:
      */
     bool isActive() const;
     
+    /**
+     * @brief Prüft, ob der Effekt gerade selbstständig neue Farben erzeugt
+     *
+     * Statische Effekte und abgeklungene reaktive Effekte laufen ohne Timer.
+     * @return true wenn aktiv und der Timer läuft
+     */
+    bool isAnimating() const;
+    
+    /**
+     * @brief Gibt die Anzahl der Verbindungen zum Signal colorChanged zurück
+     * @return Anzahl der verbundenen Empfänger
+     */
+    int getColorReceiverCount() const;
+    
     /**
      * @brief Erstellt einen Effekt basierend auf dem Typ
      * @param type Effekttyp
@@ -89,19 +182,64 @@ public:
      */
     static Effect* createEffect(Type type, const QVariantMap &parameters = QVariantMap(), QObject *parent = nullptr);
     
+    /**
+     * @brief Gibt die aktuellen Parameter des Effekts zurück
+     * @return Parameter-Map mit allen Feldern des Schemas
+     */
+    virtual QVariantMap getParameters() const = 0;
+    
+    /**
+     * @brief Prüft Parameter gegen das Schema eines Effekttyps, ohne einen Effekt zu erzeugen
+     *
+     * Ausdrücke des Ausdruck-Effekts werden dabei probeweise übersetzt.
+     * @param type Effekttyp
+     * @param parameters Parameter-Map
+     * @param errors Wird mit einer Meldung pro ungültigem Wert gefüllt (darf nullptr sein)
+     * @return true wenn gültig, false wenn nicht
+     */
+    static bool validateParameters(Type type, const QVariantMap &parameters, QStringList *errors = nullptr);
+    
     /**
      * @brief Konvertiert einen Effektnamen in einen Effekttyp
+     *
+     * Akzeptiert Anzeigenamen, kanonische IDs und englische Gerätenamen (siehe typeFromId).
      * @param name Name des Effekts
-     * @return Effekttyp
+     * @return Effekttyp, Static wenn der Name unbekannt ist
      */
     static Type typeFromName(const QString &name);
     
     /**
      * @brief Konvertiert einen Effekttyp in einen Effektnamen
      * @param type Effekttyp
-     * @return Name des Effekts
+     * @return Anzeigename des Effekts
      */
     static QString nameFromType(Type type);
+    
+    /**
+     * @brief Gibt die kanonische, sprachunabhängige ID eines Effekttyps zurück
+     * @param type Effekttyp
+     * @return Kanonische ID (z.B. "breathing")
+     */
+    static QString idFromType(Type type);
+    
+    /**
+     * @brief Ermittelt den Effekttyp zu einem beliebigen Effektnamen
+     *
+     * Erkannt werden kanonische IDs ("rainbow"), Anzeigenamen ("Regenbogen") und die
+     * englischen Namen, unter denen Geräte ihre Firmware-Effekte melden ("Rainbow").
+     * Groß-/Kleinschreibung spielt keine Rolle.
+     * @param name Name des Effekts
+     * @param type Wird mit dem Effekttyp gefüllt
+     * @return true wenn der Name erkannt wurde, false wenn nicht
+     */
+    static bool typeFromId(const QString &name, Type *type);
+    
+    /**
+     * @brief Normalisiert einen beliebigen Effektnamen auf seine kanonische ID
+     * @param name Name des Effekts
+     * @return Kanonische ID oder leerer String, wenn der Name unbekannt ist
+     */
+    static QString canonicalId(const QString &name);
 
 signals:
     /**
@@ -114,55 +252,149 @@ protected:
     Type m_type;
     bool m_active;
     QTimer *m_timer;
-    QVariantMap m_parameters;
+};
+
+/**
+ * @brief Basisklasse für Effekte mit typisierter Parameterstruktur
+ *
+ * Hält die Parameter als Struktur und setzt die Umwandlung von und nach QVariantMap
+ * über das Schema der Struktur um. Abgeleitete Effekte reagieren in applyParameters()
+ * auf Änderungen.
+ */
+template <typename Params>
+class TypedEffect : public Effect
+{
+public:
+    using Parameters = Params;
+    
+    /**
+     * @brief Konstruktor
+     * @param type Effekttyp
+     * @param parameters Parameter
+     * @param parent Parent-Objekt
+     */
+    TypedEffect(Type type, const Params &parameters, QObject *parent)
+        : Effect(type, parent)
+        , m_params(parameters)
+    {
+    }
+    
+    /**
+     * @brief Gibt die Parameter als Struktur zurück
+     * @return Parameter
+     */
+    const Params &parameters() const
+    {
+        return m_params;
+    }
+    
+    /**
+     * @brief Setzt die Parameter als Struktur
+     * @param parameters Parameter
+     */
+    void setParameters(const Params &parameters)
+    {
+        Params previous = m_params;
+        m_params = parameters;
+        applyParameters(previous);
+    }
+    
+    bool setParameters(const QVariantMap &parameters) override
+    {
+        Params converted = m_params;
+        QStringList errors;
+        if (!EffectParameters::fromVariantMap(parameters, &converted, &errors)) {
+            qWarning("Effektparameter abgelehnt: %s", qPrintable(errors.join("; ")));
+            return false;
+        }
+        
+        setParameters(converted);
+        return true;
+    }
+    
+    bool resetParameters(const QVariantMap &parameters) override
+    {
+        Params converted;
+        QStringList errors;
+        bool valid = EffectParameters::fromVariantMap(parameters, &converted, &errors);
+        if (!valid) {
+            qWarning("Ungültige Effektparameter, verwende Standardwerte: %s", qPrintable(errors.join("; ")));
+        }
+        
+        setParameters(converted);
+        return valid;
+    }
+    
+    QVariantMap getParameters() const override
+    {
+        return EffectParameters::toVariantMap(m_params);
+    }
+    
+    LayoutParameters getLayoutParameters() const override
+    {
+        if constexpr (std::is_base_of<LayoutParameters, Params>::value) {
+            return m_params;
+        } else {
+            return Effect::getLayoutParameters();
+        }
+    }
+
+protected:
+    /**
+     * @brief Wird nach jeder Parameteränderung aufgerufen
+     * @param previous Parameter vor der Änderung
+     */
+    virtual void applyParameters(const Params &previous)
+    {
+        Q_UNUSED(previous);
+    }
+    
+    Params m_params;
 };
 
 /**
  * @brief Statischer Farbeffekt
  */
-class StaticEffect : public Effect
+class StaticEffect : public TypedEffect<StaticParameters>
 {
     Q_OBJECT
 
 public:
     /**
      * @brief Konstruktor
-     * @param color Farbe
+     * @param parameters Parameter
      * @param parent Parent-Objekt
      */
-    explicit StaticEffect(const QColor &color = Qt::white, QObject *parent = nullptr);
+    explicit StaticEffect(const StaticParameters &parameters = StaticParameters(), QObject *parent = nullptr);
     
     /**
      * @brief Gibt die aktuelle Farbe zurück
      * @return Aktuelle Farbe
      */
     QColor getCurrentColor() const override;
-    
+
+protected:
     /**
-     * @brief Setzt Parameter für den Effekt
-     * @param parameters Parameter-Map
+     * @brief Übernimmt geänderte Parameter in den laufenden Effekt
+     * @param previous Parameter vor der Änderung
      */
-    void setParameters(const QVariantMap &parameters) override;
-
-private:
-    QColor m_color;
+    void applyParameters(const StaticParameters &previous) override;
 };
 
 /**
  * @brief Pulsierender Farbeffekt
  */
-class BreathingEffect : public Effect
+class BreathingEffect : public TypedEffect<BreathingParameters>
 {
     Q_OBJECT
 
 public:
     /**
      * @brief Konstruktor
-     * @param color Farbe
-     * @param speed Geschwindigkeit (ms)
+     * @param parameters Parameter
      * @param parent Parent-Objekt
      */
-    explicit BreathingEffect(const QColor &color = Qt::white, int speed = 2000, QObject *parent = nullptr);
+    explicit BreathingEffect(const BreathingParameters &parameters = BreathingParameters(), QObject *parent = nullptr);
     
     /**
      * @brief Gibt die aktuelle Farbe zurück
@@ -171,16 +403,30 @@ public:
     QColor getCurrentColor() const override;
     
     /**
-     * @brief Setzt Parameter für den Effekt
-     * @param parameters Parameter-Map
+     * @brief Gibt die Farbe mit einer Phasenverschiebung zurück
+     * @param phaseOffset Verschiebung als Anteil einer Periode (0.0 - 1.0)
+     * @return Farbe an der verschobenen Position
      */
-    void setParameters(const QVariantMap &parameters) override;
+    QColor getColorAtPhase(qreal phaseOffset) const override;
+    
+    /**
+     * @brief Gibt an, ob der Effekt einen periodischen Verlauf hat
+     * @return true
+     */
+    bool isPeriodic() const override;
     
     /**
      * @brief Startet den Effekt
      */
     void start() override;
 
+protected:
+    /**
+     * @brief Übernimmt geänderte Parameter in den laufenden Effekt
+     * @param previous Parameter vor der Änderung
+     */
+    void applyParameters(const BreathingParameters &previous) override;
+
 private slots:
     /**
      * @brief Aktualisiert den Effekt
@@ -188,8 +434,6 @@ private slots:
     void update();
 
 private:
-    QColor m_color;
-    int m_speed;
     qreal m_intensity;
     bool m_increasing;
 };
@@ -197,17 +441,17 @@ private:
 /**
  * @brief Regenbogen-Farbeffekt
  */
-class RainbowEffect : public Effect
+class RainbowEffect : public TypedEffect<RainbowParameters>
 {
     Q_OBJECT
 
 public:
     /**
      * @brief Konstruktor
-     * @param speed Geschwindigkeit (ms)
+     * @param parameters Parameter
      * @param parent Parent-Objekt
      */
-    explicit RainbowEffect(int speed = 2000, QObject *parent = nullptr);
+    explicit RainbowEffect(const RainbowParameters &parameters = RainbowParameters(), QObject *parent = nullptr);
     
     /**
      * @brief Gibt die aktuelle Farbe zurück
@@ -216,16 +460,30 @@ public:
     QColor getCurrentColor() const override;
     
     /**
-     * @brief Setzt Parameter für den Effekt
-     * @param parameters Parameter-Map
+     * @brief Gibt die Farbe mit einer Phasenverschiebung zurück
+     * @param phaseOffset Verschiebung als Anteil einer Periode (0.0 - 1.0)
+     * @return Farbe an der verschobenen Position
+     */
+    QColor getColorAtPhase(qreal phaseOffset) const override;
+    
+    /**
+     * @brief Gibt an, ob der Effekt einen periodischen Verlauf hat
+     * @return true
      */
-    void setParameters(const QVariantMap &parameters) override;
+    bool isPeriodic() const override;
     
     /**
      * @brief Startet den Effekt
      */
     void start() override;
 
+protected:
+    /**
+     * @brief Übernimmt geänderte Parameter in den laufenden Effekt
+     * @param previous Parameter vor der Änderung
+     */
+    void applyParameters(const RainbowParameters &previous) override;
+
 private slots:
     /**
      * @brief Aktualisiert den Effekt
@@ -233,26 +491,23 @@ private slots:
     void update();
 
 private:
-    int m_speed;
     int m_hue;
 };
 
 /**
  * @brief Welleneffekt
  */
-class WaveEffect : public Effect
+class WaveEffect : public TypedEffect<WaveParameters>
 {
     Q_OBJECT
 
 public:
     /**
      * @brief Konstruktor
-     * @param color1 Erste Farbe
-     * @param color2 Zweite Farbe
-     * @param speed Geschwindigkeit (ms)
+     * @param parameters Parameter
      * @param parent Parent-Objekt
      */
-    explicit WaveEffect(const QColor &color1 = Qt::blue, const QColor &color2 = Qt::cyan, int speed = 2000, QObject *parent = nullptr);
+    explicit WaveEffect(const WaveParameters &parameters = WaveParameters(), QObject *parent = nullptr);
     
     /**
      * @brief Gibt die aktuelle Farbe zurück
@@ -261,16 +516,30 @@ public:
     QColor getCurrentColor() const override;
     
     /**
-     * @brief Setzt Parameter für den Effekt
-     * @param parameters Parameter-Map
+     * @brief Gibt die Farbe mit einer Phasenverschiebung zurück
+     * @param phaseOffset Verschiebung als Anteil einer Periode (0.0 - 1.0)
+     * @return Farbe an der verschobenen Position
+     */
+    QColor getColorAtPhase(qreal phaseOffset) const override;
+    
+    /**
+     * @brief Gibt an, ob der Effekt einen periodischen Verlauf hat
+     * @return true
      */
-    void setParameters(const QVariantMap &parameters) override;
+    bool isPeriodic() const override;
     
     /**
      * @brief Startet den Effekt
      */
     void start() override;
 
+protected:
+    /**
+     * @brief Übernimmt geänderte Parameter in den laufenden Effekt
+     * @param previous Parameter vor der Änderung
+     */
+    void applyParameters(const WaveParameters &previous) override;
+
 private slots:
     /**
      * @brief Aktualisiert den Effekt
@@ -278,9 +547,6 @@ private slots:
     void update();
 
 private:
-    QColor m_color1;
-    QColor m_color2;
-    int m_speed;
     qreal m_position;
     bool m_forward;
 };
@@ -288,18 +554,17 @@ private:
 /**
  * @brief Reaktiver Effekt
  */
-class ReactiveEffect : public Effect
+class ReactiveEffect : public TypedEffect<ReactiveParameters>
 {
     Q_OBJECT
 
 public:
     /**
      * @brief Konstruktor
-     * @param color Farbe
-     * @param duration Dauer (ms)
+     * @param parameters Parameter
      * @param parent Parent-Objekt
      */
-    explicit ReactiveEffect(const QColor &color = Qt::white, int duration = 500, QObject *parent = nullptr);
+    explicit ReactiveEffect(const ReactiveParameters &parameters = ReactiveParameters(), QObject *parent = nullptr);
     
     /**
      * @brief Gibt die aktuelle Farbe zurück
@@ -307,12 +572,6 @@ public:
      */
     QColor getCurrentColor() const override;
     
-    /**
-     * @brief Setzt Parameter für den Effekt
-     * @param parameters Parameter-Map
-     */
-    void setParameters(const QVariantMap &parameters) override;
-    
     /**
      * @brief Startet den Effekt
      */
@@ -323,6 +582,13 @@ public:
      */
     void trigger();
 
+protected:
+    /**
+     * @brief Übernimmt geänderte Parameter in den laufenden Effekt
+     * @param previous Parameter vor der Änderung
+     */
+    void applyParameters(const ReactiveParameters &previous) override;
+
 private slots:
     /**
      * @brief Aktualisiert den Effekt
@@ -330,9 +596,79 @@ private slots:
     void update();
 
 private:
-    QColor m_color;
-    QColor m_baseColor;
-    int m_duration;
     qreal m_intensity;
     QTimer m_fadeTimer;
 };
+
+/**
+ * @brief Benutzerdefinierter Effekt aus Ausdrücken je Farbkanal
+ *
+ * Die Parameter "red", "green" und "blue" enthalten je einen Ausdruck (siehe
+ * ExpressionProgram), der pro LED einen Wert von 0.0 bis 1.0 liefert. Die Ausdrücke
+ * werden beim Setzen einmalig übersetzt; "interval" legt den Frameabstand in ms fest.
+ */
+class ExpressionEffect : public TypedEffect<ExpressionParameters>
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Konstruktor
+     * @param parameters Parameter
+     * @param parent Parent-Objekt
+     */
+    explicit ExpressionEffect(const ExpressionParameters &parameters = ExpressionParameters(), QObject *parent = nullptr);
+    
+    /**
+     * @brief Gibt die aktuelle Farbe der ersten LED zurück
+     * @return Aktuelle Farbe
+     */
+    QColor getCurrentColor() const override;
+    
+    /**
+     * @brief Gibt an, ob der Effekt jede LED einzeln berechnet
+     * @return true
+     */
+    bool rendersPerLed() const override;
+    
+    /**
+     * @brief Wertet die Ausdrücke für alle LEDs aus
+     * @param frame Zielpuffer mit ledCount Einträgen
+     * @param ledCount Anzahl der LEDs
+     * @param positions Normierte LED-Positionen oder nullptr
+     */
+    void renderFrame(QRgb *frame, int ledCount, const QVector3D *positions) const override;
+    
+    /**
+     * @brief Setzt die Sensorwerte "cpu" und "gpu"
+     * @param name Name des Eingangs
+     * @param value Wert
+     */
+    void setInputValue(const QString &name, qreal value) override;
+    
+    /**
+     * @brief Startet den Effekt
+     */
+    void start() override;
+
+protected:
+    /**
+     * @brief Übernimmt geänderte Parameter in den laufenden Effekt
+     * @param previous Parameter vor der Änderung
+     */
+    void applyParameters(const ExpressionParameters &previous) override;
+
+private slots:
+    /**
+     * @brief Aktualisiert den Effekt
+     */
+    void update();
+
+private:
+    mutable ExpressionProgram m_program;
+    QElapsedTimer m_clock;
+    
+    // Arbeitspuffer für die Auswertung, werden von Frame zu Frame wiederverwendet
+    mutable QVector<float> m_channels;
+    mutable QVector<float> m_positions;
+};
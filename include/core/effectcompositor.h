@@ -0,0 +1,211 @@
+#pragma once
+
+#include "core/effect.h"
+#include "core/ledlayout.h"
+#include <QObject>
+#include <QList>
+#include <QVector>
+#include <QColor>
+#include <QVector3D>
+
+class FrameGovernor;
+
+/**
+ * @brief Mischt mehrere Effektebenen zu einem Frame für ein Gerät
+ *
+ * Über dem Basiseffekt des Geräts (z.B. ein Temperaturverlauf) können beliebig viele
+ * Ebenen liegen (z.B. reaktive Tastendruck-Blitze, eine Helligkeitsmaske). Jede Ebene
+ * rendert in einen eigenen Puffer, der nur neu berechnet wird, wenn sich ihr Effekt
+ * geändert hat. Die Puffer werden byteweise über Mischgewichte verrechnet; die Schleifen
+ * sind so gehalten, dass der Compiler sie vektorisieren kann.
+ */
+class EffectCompositor : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Aufzählung der Mischmodi
+     */
+    enum BlendMode {
+        Normal,     ///< Überdecken
+        Add,        ///< Addieren (gesättigt)
+        Multiply,   ///< Multiplizieren
+        Max         ///< Maximum je Kanal
+    };
+
+    /**
+     * @brief Konstruktor
+     * @param deviceId ID des Geräts, für das gemischt wird
+     * @param ledCount Anzahl der LEDs des Geräts
+     * @param layout LED-Layout für positionsabhängige Ebenen (darf nullptr sein)
+     * @param parent Parent-Objekt
+     */
+    EffectCompositor(const QString &deviceId, int ledCount, LedLayout *layout, QObject *parent = nullptr);
+
+    /**
+     * @brief Destruktor
+     */
+    ~EffectCompositor();
+
+    /**
+     * @brief Setzt den Basisframe unter allen Ebenen
+     * @param frame Eine Farbe pro LED
+     */
+    void setBaseFrame(const QVector<QRgb> &frame);
+
+    /**
+     * @brief Setzt eine einheitliche Basisfarbe unter allen Ebenen
+     * @param color Farbe
+     */
+    void setBaseColor(const QColor &color);
+
+    /**
+     * @brief Fügt eine Ebene oben hinzu
+     * @param effect Effekt der Ebene (geht in den Besitz des Compositors über)
+     * @param mode Mischmodus
+     * @param opacity Deckkraft (0.0 - 1.0)
+     * @return Index der neuen Ebene
+     */
+    int addLayer(Effect *effect, BlendMode mode, qreal opacity = 1.0);
+
+    /**
+     * @brief Entfernt eine Ebene
+     * @param index Index der Ebene
+     * @return true wenn erfolgreich, false wenn der Index ungültig ist
+     */
+    bool removeLayer(int index);
+
+    /**
+     * @brief Setzt eine LED-Maske für eine Ebene
+     * @param index Index der Ebene
+     * @param mask Gewicht pro LED (0 = Ebene unsichtbar, 255 = volle Deckkraft), leer für keine Maske
+     * @return true wenn erfolgreich, false wenn der Index ungültig ist
+     */
+    bool setLayerMask(int index, const QVector<quint8> &mask);
+
+    /**
+     * @brief Setzt die Deckkraft einer Ebene
+     * @param index Index der Ebene
+     * @param opacity Deckkraft (0.0 - 1.0)
+     * @return true wenn erfolgreich, false wenn der Index ungültig ist
+     */
+    bool setLayerOpacity(int index, qreal opacity);
+
+    /**
+     * @brief Legt den Governor fest, der die CPU-Last der Ebenen begrenzt
+     *
+     * Über dem Budget wird nur jeder n-te Frame gemischt und Ebenen pro LED werden mit
+     * geringerer Auflösung berechnet. Ausgegebene und ausgelassene Frames werden gezählt.
+     * @param governor Governor (darf nullptr sein, dann ohne Begrenzung)
+     */
+    void setFrameGovernor(FrameGovernor *governor);
+
+    /**
+     * @brief Reicht einen externen Eingangswert an die Effekte aller Ebenen weiter
+     * @param name Name des Eingangs ("cpu", "gpu")
+     * @param value Wert
+     */
+    void setInputValue(const QString &name, qreal value);
+
+    /**
+     * @brief Gibt die Anzahl der Ebenen zurück
+     * @return Anzahl der Ebenen (ohne Basis)
+     */
+    int getLayerCount() const;
+
+    /**
+     * @brief Prüft, ob eine Ebene gerade animiert
+     * @return true wenn mindestens ein Ebeneneffekt animiert
+     */
+    bool isAnimating() const;
+
+    /**
+     * @brief Gibt den zuletzt gemischten Frame zurück
+     * @return Eine Farbe pro LED
+     */
+    const QVector<QRgb> &getFrame() const;
+
+    /**
+     * @brief Konvertiert einen Namen in einen Mischmodus
+     * @param name Name ("normal", "add", "multiply", "max")
+     * @return Mischmodus, Normal wenn der Name unbekannt ist
+     */
+    static BlendMode blendModeFromName(const QString &name);
+
+signals:
+    /**
+     * @brief Signal, das ausgelöst wird, wenn ein neuer Frame gemischt wurde
+     * @param frame Eine Farbe pro LED
+     */
+    void frameComposed(const QVector<QRgb> &frame);
+
+private slots:
+    /**
+     * @brief Passt die Puffer an eine geänderte LED-Anzahl im Layout an
+     */
+    void onLayoutChanged();
+
+private:
+    /**
+     * @brief Eine Effektebene mit eigenem Puffer
+     */
+    struct Layer {
+        Effect *effect;
+        BlendMode mode;
+        quint8 opacity;
+        QVector<quint8> mask;
+        
+        // Positionsabhängige Ausgabe über das LED-Layout
+        bool spatial;
+        QVector3D direction;
+        qreal periods;
+        LedLayout::PhaseTable phases;
+        
+        QVector<QRgb> buffer;       // Ausgabe des Effekts
+        QVector<quint8> weights;    // Mischgewicht je Farbkanal aus Deckkraft und Maske
+        QVector<QRgb> composite;    // Ergebnis aller Ebenen bis einschließlich dieser
+        bool dirty;
+    };
+
+    /**
+     * @brief Markiert den Compositor als veraltet und plant das Mischen ein
+     */
+    void scheduleCompose();
+
+    /**
+     * @brief Rendert veränderte Ebenen und mischt ab der untersten veränderten Ebene neu
+     */
+    void compose();
+
+    /**
+     * @brief Passt alle Puffer an die aktuelle LED-Anzahl an
+     */
+    void resizeBuffers();
+
+    /**
+     * @brief Rendert den Effekt einer Ebene in ihren Puffer
+     * @param layer Ebene
+     */
+    void renderLayer(Layer *layer);
+
+    /**
+     * @brief Berechnet die Mischgewichte einer Ebene aus Deckkraft und Maske
+     * @param layer Ebene
+     */
+    void updateWeights(Layer *layer);
+
+private:
+    QString m_deviceId;
+    int m_ledCount;
+    LedLayout *m_layout;
+    QList<Layer*> m_layers;
+    QVector<QRgb> m_base;
+    QVector<QRgb> m_palette;
+    bool m_baseDirty;
+    bool m_composeScheduled;
+    FrameGovernor *m_governor;
+    int m_skippedFrames;
+    QVector<QRgb> m_sampledFrame;           // Abgetastete LEDs bei reduzierter Auflösung
+    QVector<QVector3D> m_sampledPositions;
+};
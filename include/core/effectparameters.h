@@ -0,0 +1,278 @@
+#pragma once
+
+#include <QColor>
+#include <QString>
+#include <QStringList>
+#include <QVariant>
+#include <QVariantMap>
+#include <tuple>
+#include <utility>
+
+/**
+ * @brief Typisierte Effektparameter mit Schema zur Übersetzungszeit
+ *
+ * Jeder Effekt besitzt eine eigene Parameterstruktur. Deren statische Funktion schema()
+ * listet alle Felder als Paar aus Name und Member-Zeiger auf. Daraus werden die
+ * Umwandlungen von und nach QVariantMap erzeugt, die nur an der API-Grenze (Profile,
+ * GUI, Plugins) stattfinden. Innerhalb der Effekte sind Parameteränderungen einfache
+ * Schreibzugriffe auf die Struktur.
+ */
+namespace EffectParameters {
+
+/**
+ * @brief Ein Feld des Schemas: Name und Member-Zeiger
+ */
+template <typename Struct, typename T>
+struct Field {
+    const char *name;
+    T Struct::*member;
+};
+
+/**
+ * @brief Erzeugt ein Schemafeld
+ * @param name Name des Parameters in der QVariantMap
+ * @param member Member-Zeiger auf das Feld
+ * @return Schemafeld
+ */
+template <typename Struct, typename T>
+constexpr Field<Struct, T> field(const char *name, T Struct::*member)
+{
+    return Field<Struct, T>{name, member};
+}
+
+/**
+ * @brief Umwandlung eines einzelnen Werts mit Typprüfung
+ */
+template <typename T>
+struct Traits;
+
+template <>
+struct Traits<int> {
+    static bool fromVariant(const QVariant &value, int *out)
+    {
+        bool ok = false;
+        int converted = value.toInt(&ok);
+        if (ok) *out = converted;
+        return ok;
+    }
+    static QVariant toVariant(int value) { return value; }
+};
+
+template <>
+struct Traits<qreal> {
+    static bool fromVariant(const QVariant &value, qreal *out)
+    {
+        bool ok = false;
+        qreal converted = value.toDouble(&ok);
+        if (ok) *out = converted;
+        return ok;
+    }
+    static QVariant toVariant(qreal value) { return value; }
+};
+
+template <>
+struct Traits<bool> {
+    static bool fromVariant(const QVariant &value, bool *out)
+    {
+        if (!value.canConvert<bool>()) return false;
+        *out = value.toBool();
+        return true;
+    }
+    static QVariant toVariant(bool value) { return value; }
+};
+
+template <>
+struct Traits<QString> {
+    static bool fromVariant(const QVariant &value, QString *out)
+    {
+        if (!value.canConvert<QString>()) return false;
+        *out = value.toString();
+        return true;
+    }
+    static QVariant toVariant(const QString &value) { return value; }
+};
+
+template <>
+struct Traits<QColor> {
+    static bool fromVariant(const QVariant &value, QColor *out)
+    {
+        // Profile speichern Farben als Namen ("#rrggbb")
+        QColor color = value.userType() == QMetaType::QColor
+            ? value.value<QColor>()
+            : QColor(value.toString());
+        if (!color.isValid()) return false;
+        *out = color;
+        return true;
+    }
+    static QVariant toVariant(const QColor &value) { return value; }
+};
+
+/**
+ * @brief Wandelt eine QVariantMap in eine Parameterstruktur um
+ *
+ * Nicht enthaltene Felder behalten ihren bisherigen Wert, unbekannte Schlüssel werden
+ * ignoriert. Felder mit ungültigem Wert bleiben unverändert und werden gemeldet.
+ * @param map Parameter-Map
+ * @param params Zielstruktur
+ * @param errors Wird mit einer Meldung pro ungültigem Feld gefüllt (darf nullptr sein)
+ * @return true wenn alle enthaltenen Felder gültig waren, false wenn nicht
+ */
+template <typename Params>
+bool fromVariantMap(const QVariantMap &map, Params *params, QStringList *errors = nullptr)
+{
+    bool valid = true;
+
+    std::apply([&](const auto &... fields) {
+        auto convert = [&](const auto &field) {
+            auto it = map.constFind(QLatin1String(field.name));
+            if (it == map.constEnd()) {
+                return;
+            }
+
+            using FieldType = std::decay_t<decltype(params->*(field.member))>;
+            if (!Traits<FieldType>::fromVariant(it.value(), &(params->*(field.member)))) {
+                valid = false;
+                if (errors) {
+                    errors->append(QString("Ungültiger Wert für Parameter '%1': %2")
+                                   .arg(QLatin1String(field.name), it.value().toString()));
+                }
+            }
+        };
+        (convert(fields), ...);
+    }, Params::schema());
+
+    return valid;
+}
+
+/**
+ * @brief Wandelt eine Parameterstruktur in eine QVariantMap um
+ * @param params Parameterstruktur
+ * @return Parameter-Map mit allen Feldern des Schemas
+ */
+template <typename Params>
+QVariantMap toVariantMap(const Params &params)
+{
+    QVariantMap map;
+
+    std::apply([&](const auto &... fields) {
+        ((map[QLatin1String(fields.name)] = Traits<std::decay_t<decltype(params.*(fields.member))>>::toVariant(params.*(fields.member))), ...);
+    }, Params::schema());
+
+    return map;
+}
+
+} // namespace EffectParameters
+
+/**
+ * @brief Gemeinsame Parameter für die räumliche Ausgabe periodischer Effekte
+ */
+struct LayoutParameters {
+    bool spatial = false;   ///< Über das LED-Layout verteilen
+    qreal direction = 0.0;  ///< Ausbreitungsrichtung in Grad (XY-Ebene)
+    qreal periods = 1.0;    ///< Perioden über das gesamte Layout
+};
+
+/**
+ * @brief Parameter des statischen Effekts
+ */
+struct StaticParameters {
+    QColor color = Qt::white;
+
+    static constexpr auto schema()
+    {
+        using namespace EffectParameters;
+        return std::make_tuple(field("color", &StaticParameters::color));
+    }
+};
+
+/**
+ * @brief Parameter des Atmen-Effekts
+ */
+struct BreathingParameters : LayoutParameters {
+    QColor color = Qt::white;
+    int speed = 2000;
+
+    static constexpr auto schema()
+    {
+        using namespace EffectParameters;
+        return std::make_tuple(field("color", &BreathingParameters::color),
+                               field("speed", &BreathingParameters::speed),
+                               field("spatial", &LayoutParameters::spatial),
+                               field("direction", &LayoutParameters::direction),
+                               field("periods", &LayoutParameters::periods));
+    }
+};
+
+/**
+ * @brief Parameter des Regenbogen-Effekts
+ */
+struct RainbowParameters : LayoutParameters {
+    int speed = 2000;
+
+    static constexpr auto schema()
+    {
+        using namespace EffectParameters;
+        return std::make_tuple(field("speed", &RainbowParameters::speed),
+                               field("spatial", &LayoutParameters::spatial),
+                               field("direction", &LayoutParameters::direction),
+                               field("periods", &LayoutParameters::periods));
+    }
+};
+
+/**
+ * @brief Parameter des Welleneffekts (standardmäßig räumlich)
+ */
+struct WaveParameters : LayoutParameters {
+    QColor color1 = Qt::blue;
+    QColor color2 = Qt::cyan;
+    int speed = 2000;
+
+    WaveParameters() { spatial = true; }
+
+    static constexpr auto schema()
+    {
+        using namespace EffectParameters;
+        return std::make_tuple(field("color1", &WaveParameters::color1),
+                               field("color2", &WaveParameters::color2),
+                               field("speed", &WaveParameters::speed),
+                               field("spatial", &LayoutParameters::spatial),
+                               field("direction", &LayoutParameters::direction),
+                               field("periods", &LayoutParameters::periods));
+    }
+};
+
+/**
+ * @brief Parameter des reaktiven Effekts
+ */
+struct ReactiveParameters {
+    QColor color = Qt::white;
+    QColor baseColor = Qt::black;
+    int duration = 500;
+
+    static constexpr auto schema()
+    {
+        using namespace EffectParameters;
+        return std::make_tuple(field("color", &ReactiveParameters::color),
+                               field("baseColor", &ReactiveParameters::baseColor),
+                               field("duration", &ReactiveParameters::duration));
+    }
+};
+
+/**
+ * @brief Parameter des Ausdruck-Effekts
+ */
+struct ExpressionParameters {
+    QString red = "0.5 + 0.5 * sin(2 * pi * (x - 0.2 * t))";
+    QString green = "0.5 + 0.5 * sin(2 * pi * (x - 0.2 * t) + 2.094)";
+    QString blue = "0.5 + 0.5 * sin(2 * pi * (x - 0.2 * t) + 4.189)";
+    int interval = 33;
+
+    static constexpr auto schema()
+    {
+        using namespace EffectParameters;
+        return std::make_tuple(field("red", &ExpressionParameters::red),
+                               field("green", &ExpressionParameters::green),
+                               field("blue", &ExpressionParameters::blue),
+                               field("interval", &ExpressionParameters::interval));
+    }
+};
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <vector>
+
+/**
+ * @brief Kompilierte Ausdrücke für benutzerdefinierte LED-Effekte
+ *
+ * Ein oder mehrere Ausdrücke (z.B. je einer für Rot, Grün und Blau) werden einmalig in
+ * einen Registercode übersetzt. Die Auswertung läuft anschließend in Blöcken zu
+ * BatchSize LEDs: jeder Befehl verarbeitet einen ganzen Block, sodass die inneren
+ * Schleifen feste Länge haben und vom Compiler vektorisiert werden.
+ *
+ * Verfügbare Variablen: t (Sekunden), i (LED-Index), n (LED-Anzahl), x und y
+ * (Position im Layout, 0.0 - 1.0), cpu und gpu (Temperaturen, 0 - 100) sowie pi.
+ * Operatoren: + - * / % ^, Vergleiche, Bedingung "a ? b : c".
+ * Funktionen: sin, cos, abs, floor, fract, sqrt, min, max, pow, step, clamp, mix.
+ */
+class ExpressionProgram
+{
+public:
+    /**
+     * @brief Aufzählung der Eingangsvariablen
+     */
+    enum Variable {
+        Time,           ///< t: Zeit in Sekunden
+        LedIndex,       ///< i: Index der LED
+        LedCount,       ///< n: Anzahl der LEDs
+        PositionX,      ///< x: Position im Layout
+        PositionY,      ///< y: Position im Layout
+        CpuTemperature, ///< cpu: CPU-Temperatur
+        GpuTemperature, ///< gpu: GPU-Temperatur
+        VariableCount
+    };
+
+    /**
+     * @brief Anzahl der LEDs, die ein Befehl auf einmal verarbeitet
+     */
+    static const int BatchSize = 8;
+
+    /**
+     * @brief Konstruktor
+     */
+    ExpressionProgram();
+
+    /**
+     * @brief Übersetzt Ausdrücke in Registercode
+     *
+     * Bei einem Fehler bleibt das bisherige Programm unverändert.
+     * @param expressions Ein Ausdruck pro Ausgabekanal
+     * @param errorMessage Wird bei einem Fehler mit der Fehlermeldung gefüllt (darf nullptr sein)
+     * @return true wenn erfolgreich, false wenn fehlgeschlagen
+     */
+    bool compile(const QStringList &expressions, QString *errorMessage = nullptr);
+
+    /**
+     * @brief Prüft, ob ein gültiges Programm vorliegt
+     * @return true wenn gültig, false wenn nicht
+     */
+    bool isValid() const;
+
+    /**
+     * @brief Gibt die Anzahl der Ausgabekanäle zurück
+     * @return Anzahl der Ausdrücke
+     */
+    int getOutputCount() const;
+
+    /**
+     * @brief Gibt die Anzahl der Befehle nach der Konstantenfaltung zurück
+     * @return Anzahl der Befehle
+     */
+    int getInstructionCount() const;
+
+    /**
+     * @brief Setzt den Wert einer skalaren Variable (t, cpu, gpu)
+     * @param variable Variable
+     * @param value Wert
+     */
+    void setVariable(Variable variable, float value);
+
+    /**
+     * @brief Wertet das Programm für eine LED-Reihe aus
+     * @param ledCount Anzahl der LEDs
+     * @param x X-Position je LED (darf nullptr sein, dann i / (n - 1))
+     * @param y Y-Position je LED (darf nullptr sein, dann 0)
+     * @param outputs Ein Zielpuffer mit ledCount Einträgen pro Ausgabekanal
+     */
+    void evaluate(int ledCount, const float *x, const float *y, float *const *outputs);
+
+    /**
+     * @brief Ein Befehl des Registercodes
+     */
+    struct Instruction {
+        quint8 op;
+        quint16 dst;
+        quint16 a;
+        quint16 b;
+        quint16 c;
+    };
+
+private:
+    std::vector<Instruction> m_instructions;
+    QVector<quint16> m_outputRegisters;
+    QVector<float> m_scalars;
+
+    // Registerdatei: BatchSize Werte pro Register, Konstanten werden einmalig befüllt
+    std::vector<float> m_registers;
+};
@@ -0,0 +1,123 @@
+#pragma once
+
+#include "devices/ledframeupdate.h"
+#include <QVector>
+#include <QRgb>
+
+/**
+ * @brief Kodiert Frames eines Geräts als Änderung gegenüber dem zuletzt bestätigten Frame
+ *
+ * Für jeden Frame werden die vom Gerät unterstützten Kodierungen geschätzt und die
+ * kleinste gewählt; ist keine kleiner als der ganze Frame, bleibt es beim ganzen Frame.
+ * Nach der Übertragung bestätigt der Aufrufer den Frame mit acknowledge(); scheitert
+ * sie, wird mit invalidate() wieder ein ganzer Frame erzwungen.
+ *
+ * Geschätzte Größen in Byte: ganzer Frame 3 pro LED, Bereich RangeOverhead plus 3 pro
+ * LED, Lauf RunSize. Alle KeyframeInterval Frames wird ein ganzer Frame gesendet, damit
+ * sich verlorene Pakete auf verbindungslosen Strecken nicht dauerhaft auswirken.
+ */
+class FrameEncoder
+{
+public:
+    /**
+     * @brief Geschätzter Kopf eines Bereichs (Start und Länge)
+     */
+    static const int RangeOverhead = 4;
+    
+    /**
+     * @brief Geschätzte Größe eines Laufs (Länge und Farbe)
+     */
+    static const int RunSize = 4;
+    
+    /**
+     * @brief Maximale Länge eines Laufs (Länge minus eins passt in ein Byte)
+     */
+    static const int MaxRunLength = 256;
+    
+    /**
+     * @brief Höchste Anzahl an Frames zwischen zwei ganzen Frames
+     */
+    static const int KeyframeInterval = 120;
+    
+    /**
+     * @brief Zähler für Durchsatzmessungen
+     */
+    struct Statistics {
+        quint64 fullFrames = 0;         // Als ganzer Frame übertragen
+        quint64 rangeFrames = 0;        // Als geänderte Bereiche übertragen
+        quint64 runLengthFrames = 0;    // Lauflängenkodiert übertragen
+        quint64 unchangedFrames = 0;    // Unverändert, nichts übertragen
+        quint64 encodedBytes = 0;       // Geschätzte übertragene Nutzdaten
+        quint64 rawBytes = 0;           // Nutzdaten, wenn immer ganze Frames gesendet würden
+    };
+    
+    /**
+     * @brief Konstruktor
+     * @param encodings Vom Gerät unterstützte Kodierungen (Bitmaske aus LedFrameUpdate::Encoding)
+     */
+    explicit FrameEncoder(int encodings = LedFrameUpdate::Full);
+    
+    /**
+     * @brief Gibt die unterstützten Kodierungen zurück
+     * @return Bitmaske aus LedFrameUpdate::Encoding
+     */
+    int getEncodings() const;
+    
+    /**
+     * @brief Kodiert einen Frame gegenüber dem zuletzt bestätigten
+     *
+     * Der Frame muss bis zum Aufruf von acknowledge() unverändert bleiben.
+     * @param frame Neuer Frame
+     * @return true wenn etwas zu übertragen ist, false wenn der Frame unverändert ist
+     */
+    bool encode(const QVector<QRgb> &frame);
+    
+    /**
+     * @brief Gibt die Kodierung des letzten encode()-Aufrufs zurück
+     * @return Aktualisierung (Puffer werden bei jedem Frame wiederverwendet)
+     */
+    const LedFrameUpdate &update() const;
+    
+    /**
+     * @brief Bestätigt die Übertragung des zuletzt kodierten Frames
+     * @param sentAs Tatsächlich verwendete Kodierung (Full nach einem Rückfall)
+     */
+    void acknowledge(LedFrameUpdate::Encoding sentAs);
+    
+    /**
+     * @brief Verwirft den bestätigten Frame, der nächste wird ganz übertragen
+     */
+    void invalidate();
+    
+    /**
+     * @brief Gibt die Zähler zurück
+     * @return Zähler
+     */
+    const Statistics &statistics() const;
+
+private:
+    /**
+     * @brief Ermittelt die geänderten Bereiche
+     * @param frame Neuer Frame
+     * @param limit Abbruch, sobald die geschätzte Größe dieses Limit erreicht
+     * @return Geschätzte Größe in Byte
+     */
+    int encodeRanges(const QVector<QRgb> &frame, int limit);
+    
+    /**
+     * @brief Zerlegt den Frame in gleichfarbige Läufe
+     * @param frame Neuer Frame
+     * @param limit Abbruch, sobald die geschätzte Größe dieses Limit erreicht
+     * @return Geschätzte Größe in Byte
+     */
+    int encodeRuns(const QVector<QRgb> &frame, int limit);
+
+private:
+    int m_encodings;
+    QVector<QRgb> m_acknowledged;
+    bool m_valid;
+    int m_framesSinceFull;
+    int m_encodedSize;
+    LedFrameUpdate m_update;
+    Statistics m_statistics;
+};
@@ -0,0 +1,146 @@
+#pragma once
+
+#include <QObject>
+#include <QElapsedTimer>
+
+/**
+ * @brief Hält die CPU-Last der Anwendung unter einem festen Anteil eines Kerns
+ *
+ * Der RGBController meldet jeden Effekt-Frame über recordFrame(). Nach jedem Messfenster
+ * von WindowMs wird die CPU-Zeit des ganzen Prozesses (alle Threads, also auch die
+ * Sendethreads der Geräte) ins Verhältnis zur verstrichenen Zeit gesetzt. Liegt sie über
+ * dem Budget, senkt der Governor die Qualität um eine Stufe; liegt sie RampUpWindows
+ * Fenster in Folge unter RampUpThreshold des Budgets, hebt er sie wieder um eine Stufe.
+ *
+ * Jede Stufe verringert die Bildrate (nur jeder n-te Effekt-Frame wird ausgegeben), die
+ * LED-Auflösung (pro LED berechnete Effekte rendern nur jede n-te LED) und die Auflösung
+ * der Palette räumlicher Effekte. Gemessen wird nur, solange Frames entstehen; ohne
+ * Animation verursacht der Governor keine Weckrufe.
+ */
+class FrameGovernor : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Länge eines Messfensters
+     */
+    static const int WindowMs = 1000;
+    
+    /**
+     * @brief Anteil des Budgets, unter dem die Qualität wieder steigen darf
+     */
+    static constexpr double RampUpThreshold = 0.6;
+    
+    /**
+     * @brief Anzahl aufeinanderfolgender Fenster unter der Schwelle vor einem Anstieg
+     */
+    static const int RampUpWindows = 3;
+    
+    /**
+     * @brief Höchste Stufe (0 ist volle Qualität)
+     */
+    static const int MaxLevel = 4;
+    
+    /**
+     * @brief Zähler und letzte Messung
+     */
+    struct Statistics {
+        quint64 windows = 0;            // Ausgewertete Messfenster
+        quint64 overBudgetWindows = 0;  // Fenster über dem Budget
+        quint64 levelChanges = 0;       // Stufenwechsel
+        quint64 renderedFrames = 0;     // Ausgegebene Effekt-Frames
+        quint64 skippedFrames = 0;      // Wegen der Bildrate ausgelassene Effekt-Frames
+        double cpuUsage = 0;            // CPU-Anteil eines Kerns im letzten Fenster
+        qint64 cpuPerFrameUs = 0;       // CPU-Zeit je ausgegebenem Frame im letzten Fenster
+    };
+    
+    /**
+     * @brief Konstruktor
+     * @param parent Parent-Objekt
+     */
+    explicit FrameGovernor(QObject *parent = nullptr);
+    
+    /**
+     * @brief Legt das CPU-Budget fest
+     * @param coreFraction Anteil eines Kerns (z.B. 0.1 für 10 %), 0 schaltet den Governor ab
+     */
+    void setBudget(double coreFraction);
+    
+    /**
+     * @brief Gibt das CPU-Budget zurück
+     * @return Anteil eines Kerns, 0 wenn abgeschaltet
+     */
+    double getBudget() const;
+    
+    /**
+     * @brief Gibt die aktuelle Stufe zurück
+     * @return 0 für volle Qualität bis MaxLevel
+     */
+    int getLevel() const;
+    
+    /**
+     * @brief Gibt an, jeder wievielte Effekt-Frame ausgegeben wird
+     * @return 1 für jeden Frame
+     */
+    int getFrameDivider() const;
+    
+    /**
+     * @brief Gibt an, jede wievielte LED pro LED berechneter Effekte gerendert wird
+     * @return 1 für jede LED
+     */
+    int getLedStep() const;
+    
+    /**
+     * @brief Gibt an, um welchen Faktor die Palette räumlicher Effekte verkleinert wird
+     * @return 1 für volle Auflösung
+     */
+    int getPaletteStep() const;
+    
+    /**
+     * @brief Meldet einen Effekt-Frame und wertet bei Ablauf des Fensters die CPU-Zeit aus
+     * @param rendered true wenn ausgegeben, false wenn wegen der Bildrate ausgelassen
+     */
+    void recordFrame(bool rendered);
+    
+    /**
+     * @brief Gibt die Zähler zurück
+     * @return Zähler
+     */
+    const Statistics &getStatistics() const;
+    
+    /**
+     * @brief Gibt die bisher verbrauchte CPU-Zeit des Prozesses zurück
+     * @return Mikrosekunden, -1 wenn die Plattform keine Messung erlaubt
+     */
+    static qint64 processCpuTimeUs();
+
+signals:
+    /**
+     * @brief Signal, das bei einem Stufenwechsel ausgelöst wird
+     * @param level Neue Stufe
+     * @param cpuUsage CPU-Anteil eines Kerns im auslösenden Fenster
+     */
+    void levelChanged(int level, double cpuUsage);
+
+private:
+    /**
+     * @brief Wertet ein abgelaufenes Messfenster aus
+     * @param elapsedUs Dauer des Fensters
+     */
+    void evaluate(qint64 elapsedUs);
+    
+    /**
+     * @brief Beginnt ein neues Messfenster
+     */
+    void restartWindow();
+
+private:
+    double m_budget;
+    int m_level;
+    int m_quietWindows;
+    QElapsedTimer m_window;
+    qint64 m_windowCpuUs;
+    quint64 m_windowFrames;
+    Statistics m_statistics;
+};
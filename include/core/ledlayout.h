@@ -0,0 +1,146 @@
+#pragma once
+
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QMap>
+#include <QHash>
+#include <QVector>
+#include <QVector3D>
+#include <QJsonObject>
+
+/**
+ * @brief Räumliches Modell der LEDs aller Geräte
+ *
+ * Platziert Geräte und ihre einzelnen LEDs auf einer gemeinsamen 2D/3D-Fläche.
+ * Positionsabhängige Effekte fragen hier pro Gerät eine Phasentabelle ab, die jeder LED
+ * ihre Position entlang einer Richtung als 8-Bit-Index zuordnet. Die Tabelle liegt beim
+ * Aufrufer und wird nur neu berechnet, wenn sich Layout, Richtung oder Perioden ändern;
+ * pro Frame genügt dann ein Tabellenzugriff je LED.
+ */
+class LedLayout : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Phasentabelle eines Geräts samt den Werten, für die sie berechnet wurde
+     */
+    struct PhaseTable {
+        quint64 revision = 0;       // 0: noch nicht berechnet
+        QVector3D direction;
+        qreal periods = 0.0;
+        QVector<quint8> phases;     // Eine Zeile pro LED
+    };
+
+    /**
+     * @brief Konstruktor
+     * @param parent Parent-Objekt
+     */
+    explicit LedLayout(QObject *parent = nullptr);
+
+    /**
+     * @brief Platziert ein Gerät als LED-Reihe
+     * @param deviceId ID des Geräts
+     * @param ledCount Anzahl der LEDs
+     * @param origin Position der ersten LED
+     * @param ledSpacing Abstand von einer LED zur nächsten
+     */
+    void placeDevice(const QString &deviceId, int ledCount, const QVector3D &origin,
+                     const QVector3D &ledSpacing = QVector3D(1.0f, 0.0f, 0.0f));
+
+    /**
+     * @brief Platziert ein Gerät mit expliziten LED-Positionen
+     * @param deviceId ID des Geräts
+     * @param ledPositions Position jeder LED
+     */
+    void placeDeviceLeds(const QString &deviceId, const QVector<QVector3D> &ledPositions);
+
+    /**
+     * @brief Entfernt ein Gerät aus dem Layout
+     * @param deviceId ID des Geräts
+     */
+    void removeDevice(const QString &deviceId);
+
+    /**
+     * @brief Prüft, ob ein Gerät platziert ist
+     * @param deviceId ID des Geräts
+     * @return true wenn platziert, false wenn nicht
+     */
+    bool containsDevice(const QString &deviceId) const;
+
+    /**
+     * @brief Gibt die IDs aller platzierten Geräte zurück
+     * @return Liste von Geräte-IDs
+     */
+    QStringList getDeviceIds() const;
+
+    /**
+     * @brief Gibt die LED-Positionen eines Geräts zurück
+     * @param deviceId ID des Geräts
+     * @return Positionen, leer wenn das Gerät nicht platziert ist
+     */
+    QVector<QVector3D> getLedPositions(const QString &deviceId) const;
+
+    /**
+     * @brief Gibt die auf das gesamte Layout normierten LED-Positionen eines Geräts zurück
+     *
+     * Jede Achse wird auf 0.0 - 1.0 bezogen auf die Ausdehnung aller Geräte abgebildet.
+     * Das Ergebnis wird bis zur nächsten Layoutänderung zwischengespeichert.
+     * @param deviceId ID des Geräts
+     * @return Normierte Positionen, leer wenn das Gerät nicht platziert ist
+     */
+    const QVector<QVector3D> &normalizedPositions(const QString &deviceId);
+    
+    /**
+     * @brief Gibt die Phasentabelle eines Geräts zurück und berechnet sie bei Bedarf neu
+     *
+     * Jede LED erhält ihre Position entlang der Richtung, normiert auf die Ausdehnung des
+     * gesamten Layouts und multipliziert mit der Anzahl der Perioden, als Index 0-255.
+     * Solange Revision, Richtung und Perioden gleich bleiben, wird nur die Tabelle in
+     * table zurückgegeben, ohne zu rechnen oder zu allokieren.
+     * @param deviceId ID des Geräts
+     * @param direction Richtung, in der sich der Effekt ausbreitet
+     * @param periods Anzahl der Effektperioden über das gesamte Layout
+     * @param table Vom Aufrufer gehaltene Tabelle
+     * @return Phasentabelle (eine Zeile pro LED), leer wenn das Gerät nicht platziert ist
+     */
+    const QVector<quint8> &phaseTable(const QString &deviceId, const QVector3D &direction, qreal periods,
+                                      PhaseTable *table) const;
+
+    /**
+     * @brief Gibt die Revision des Layouts zurück; sie ändert sich bei jeder Änderung
+     * @return Revisionszähler
+     */
+    quint64 getRevision() const;
+
+    /**
+     * @brief Serialisiert das Layout
+     * @return JSON-Objekt mit allen Platzierungen
+     */
+    QJsonObject toJson() const;
+
+    /**
+     * @brief Lädt das Layout aus JSON
+     * @param json JSON-Objekt (siehe toJson)
+     * @return true wenn erfolgreich, false wenn fehlgeschlagen
+     */
+    bool fromJson(const QJsonObject &json);
+
+signals:
+    /**
+     * @brief Signal, das nach jeder Änderung des Layouts ausgelöst wird
+     */
+    void layoutChanged();
+
+private:
+    /**
+     * @brief Verwirft alle zwischengespeicherten Positionen und meldet die Änderung
+     */
+    void invalidate();
+
+private:
+    QMap<QString, QVector<QVector3D>> m_ledPositions;
+    QHash<QString, QVector<QVector3D>> m_normalizedPositions;
+    quint64 m_revision;
+};
@@ -0,0 +1,233 @@
+#pragma once
+
+#include "devices/irgbdevice.h"
+#include <QObject>
+#include <QHash>
+#include <QList>
+#include <QVector>
+#include <QElapsedTimer>
+#include <QRgb>
+
+class QTimer;
+
+/**
+ * @brief Plant die Ausgabe von Frames an Geräte nach Fristen (Earliest Deadline First)
+ *
+ * Jedes Gerät meldet über IRGBDevice::getMaxFrameRate() und getOutputLatencyUs(), wie
+ * schnell es Frames annimmt und wie lange die Anzeige dauert. Geräte ohne Begrenzung
+ * erhalten ihre Frames sofort. Für begrenzte Geräte hält der Scheduler höchstens einen
+ * Frame zurück; ein neuerer ersetzt ihn (zusammengefasst statt aufgestaut).
+ *
+ * Ein zurückgehaltener Frame wird frühestens ein Frame-Intervall nach dem letzten
+ * geschrieben. Seine Frist ist dieser Zeitpunkt plus ein Intervall minus die Latenz des
+ * Geräts. Sind mehrere Frames fällig, werden sie nach aufsteigender Frist geschrieben,
+ * sodass langsame Transporte schnelle nicht ausbremsen.
+ *
+ * Latenzausgleich: Jeder Frame erhält einen Anzeigezeitpunkt, standardmäßig jetzt plus
+ * die größte Latenz aller Geräte. Ein Gerät bekommt den Frame um seine eigene Latenz vor
+ * diesem Zeitpunkt; bis dahin wartet er in einer kleinen Vorlaufwarteschlange des Geräts.
+ * So wechseln Geräte mit unterschiedlich langsamen Transporten gleichzeitig die Farbe.
+ */
+class OutputScheduler : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Anfängliche Anzahl an Frames in der Vorlaufwarteschlange eines Geräts
+     *
+     * Reicht sie für den Vorlauf nicht aus, wächst sie bis MaxLookaheadDepth.
+     */
+    static const int LookaheadDepth = 8;
+
+    /**
+     * @brief Maximale Anzahl an Frames in der Vorlaufwarteschlange eines Geräts
+     *
+     * Deckt den größten Vorlauf (MaxPresentationDelayUs) bei rund 250 FPS ab. Bei längerem
+     * Vorlauf oder schnelleren Effekten werden die wartenden Frames gleichmäßig ausgedünnt;
+     * die ältesten, bald fälligen bleiben immer erhalten.
+     */
+    static const int MaxLookaheadDepth = 64;
+
+    /**
+     * @brief Obergrenze für den Ausgleich (größere Latenzen werden gekappt)
+     */
+    static const qint64 MaxPresentationDelayUs = 250000;
+
+    /**
+     * @brief Zähler je Gerät
+     */
+    struct Statistics {
+        quint64 submittedFrames = 0;    // Übergebene Frames
+        quint64 writtenFrames = 0;      // Geschriebene Frames
+        quint64 coalescedFrames = 0;    // Durch einen neueren ersetzte Frames
+        quint64 overflowFrames = 0;     // Beim Ausdünnen der Vorlaufwarteschlange ersetzte Frames
+        qint64 maxLatenessUs = 0;       // Größte Verspätung gegenüber dem geplanten Zeitpunkt
+    };
+
+    /**
+     * @brief Konstruktor
+     * @param parent Parent-Objekt
+     */
+    explicit OutputScheduler(QObject *parent = nullptr);
+
+    /**
+     * @brief Nimmt ein Gerät auf und liest seine Bildrate und Latenz
+     * @param device Gerät
+     */
+    void addDevice(IRGBDevice *device);
+
+    /**
+     * @brief Entfernt ein Gerät und verwirft seine zurückgehaltenen Frames
+     * @param device Gerät
+     */
+    void removeDevice(IRGBDevice *device);
+
+    /**
+     * @brief Ersetzt die vom Gerät gemeldete Latenz, z.B. durch einen gemessenen Wert
+     * @param device Gerät
+     * @param latencyUs Latenz in Mikrosekunden
+     */
+    void setOutputLatency(IRGBDevice *device, int latencyUs);
+
+    /**
+     * @brief Schaltet den Latenzausgleich ein oder aus
+     * @param enabled true um Frames auf einen gemeinsamen Anzeigezeitpunkt zu verzögern
+     */
+    void setLatencyCompensationEnabled(bool enabled);
+
+    /**
+     * @brief Prüft, ob der Latenzausgleich aktiv ist
+     * @return true wenn aktiv
+     */
+    bool isLatencyCompensationEnabled() const;
+
+    /**
+     * @brief Gibt den Vorlauf zwischen Übergabe und Anzeige eines Frames zurück
+     * @return Größte Latenz aller Geräte in Mikrosekunden, 0 ohne Ausgleich
+     */
+    qint64 getPresentationDelayUs() const;
+
+    /**
+     * @brief Gibt den Anzeigezeitpunkt für einen jetzt übergebenen Frame zurück
+     * @return Zeitpunkt in der Zeitbasis des Schedulers (Mikrosekunden)
+     */
+    qint64 presentationTime() const;
+
+    /**
+     * @brief Prüft, ob Frames für ein Gerät zurückgehalten werden können
+     * @param device Gerät
+     * @return true wenn das Gerät eine maximale Bildrate hat oder verzögert wird
+     */
+    bool isDeferred(IRGBDevice *device) const;
+
+    /**
+     * @brief Übergibt einen Frame für ein Gerät
+     *
+     * Darf sofort geschrieben werden, gibt die Funktion true zurück und der Aufrufer
+     * schreibt selbst. Sonst wird der Frame kopiert und später über frameDue() ausgegeben.
+     * @param device Gerät
+     * @param frame Eine Farbe pro LED
+     * @param presentationUs Anzeigezeitpunkt, -1 für presentationTime()
+     * @return true wenn der Aufrufer sofort schreiben soll, false wenn eingeplant
+     */
+    bool submit(IRGBDevice *device, const QVector<QRgb> &frame, qint64 presentationUs = -1);
+
+    /**
+     * @brief Gibt die Zähler eines Geräts zurück
+     * @param device Gerät
+     * @return Zähler (leer für unbekannte Geräte)
+     */
+    Statistics getStatistics(IRGBDevice *device) const;
+
+    /**
+     * @brief Gibt die Anzahl der zurückgehaltenen Frames zurück
+     * @return Anzahl der Geräte mit wartendem Frame
+     */
+    int getPendingCount() const;
+
+signals:
+    /**
+     * @brief Ein zurückgehaltener Frame ist fällig und muss jetzt geschrieben werden
+     * @param device Gerät
+     * @param frame Frame (nur während des Aufrufs gültig)
+     */
+    void frameDue(IRGBDevice *device, const QVector<QRgb> &frame);
+
+private slots:
+    /**
+     * @brief Übernimmt fällige Vorlauf-Frames und schreibt alle fälligen Frames nach Frist
+     */
+    void processDue();
+
+private:
+    /**
+     * @brief Frame in der Vorlaufwarteschlange
+     */
+    struct QueuedFrame {
+        QVector<QRgb> colors;       // Puffer wird wiederverwendet
+        qint64 writeUs = 0;         // Anzeigezeitpunkt minus Latenz des Geräts
+    };
+
+    /**
+     * @brief Ausgabezustand eines Geräts
+     */
+    struct Slot {
+        QVector<QRgb> frame;        // Zurückgehaltener Frame, Puffer wird wiederverwendet
+        bool pending = false;
+        qint64 minIntervalUs = 0;   // 0: unbegrenzt
+        qint64 latencyUs = 0;
+        qint64 lastWriteUs = 0;
+        qint64 releaseUs = 0;       // Frühester Schreibzeitpunkt des wartenden Frames
+        qint64 deadlineUs = 0;      // Frist des wartenden Frames
+        QVector<QueuedFrame> queue; // Ringpuffer, LookaheadDepth bis MaxLookaheadDepth Einträge
+        int queueHead = 0;
+        int queueSize = 0;
+        Statistics statistics;
+    };
+
+    /**
+     * @brief Gibt einen Frame an die Bildratenbegrenzung weiter
+     *
+     * Wird der Frame zurückgehalten, muss der Aufrufer ihn anschließend in slot.frame ablegen.
+     * @param slot Ausgabezustand des Geräts
+     * @param device Gerät
+     * @param time Aktuelle Zeit
+     * @return true wenn sofort geschrieben werden darf, false wenn zurückgehalten
+     */
+    bool dispatch(Slot &slot, IRGBDevice *device, qint64 time);
+
+    /**
+     * @brief Stellt einen Frame in die Vorlaufwarteschlange und vergrößert sie bei Bedarf
+     * @param slot Ausgabezustand des Geräts
+     * @param frame Frame
+     * @param writeUs Schreibzeitpunkt
+     * @param time Aktuelle Zeit
+     */
+    void enqueue(Slot &slot, const QVector<QRgb> &frame, qint64 writeUs, qint64 time);
+
+    /**
+     * @brief Berechnet den Vorlauf aus den Latenzen aller Geräte neu
+     */
+    void updatePresentationDelay();
+
+    /**
+     * @brief Stellt den Timer auf den frühesten Schreibzeitpunkt
+     */
+    void armTimer();
+
+    /**
+     * @brief Gibt die aktuelle Zeit des Schedulers zurück
+     * @return Mikrosekunden seit dem Start
+     */
+    qint64 now() const;
+
+private:
+    QHash<IRGBDevice*, Slot> m_slots;
+    QList<IRGBDevice*> m_pending;
+    QList<IRGBDevice*> m_queued;
+    QTimer *m_timer;
+    QElapsedTimer m_clock;
+    bool m_latencyCompensation;
+    qint64 m_presentationDelayUs;
+};
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QMap>
+#include <QSet>
+#include <QJsonObject>
+#include <QSettings>
+
+/**
+ * @brief Persistenter Cache für Plugin-Metadaten
+ *
+ * Liest die eingebetteten JSON-Metadaten eines Plugins (QPluginLoader::metaData)
+ * einmalig aus und merkt sie sich anhand von Pfad, Änderungszeit und Dateigröße.
+ * Der DeviceManager entscheidet damit, ob eine Bibliothek überhaupt geladen werden muss,
+ * ohne sie per dlopen einzubinden. Außerdem verwaltet der Cache die vom Benutzer
+ * deaktivierten Plugins.
+ */
+class PluginMetadataCache : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Konstruktor
+     * @param parent Parent-Objekt
+     */
+    explicit PluginMetadataCache(QObject *parent = nullptr);
+
+    /**
+     * @brief Destruktor
+     */
+    ~PluginMetadataCache();
+
+    /**
+     * @brief Gibt die Metadaten eines Plugins zurück
+     *
+     * Bei unveränderter Datei kommen die Metadaten aus dem Cache, sonst werden sie
+     * ohne Laden der Bibliothek aus der Datei gelesen.
+     * @param filePath Pfad zur Plugin-Datei
+     * @return Metadaten (Schlüssel "IID", "className", "MetaData" usw.)
+     */
+    QJsonObject metaData(const QString &filePath);
+
+    /**
+     * @brief Prüft, ob eine Datei das IRGBDevicePlugin-Interface implementiert
+     * @param filePath Pfad zur Plugin-Datei
+     * @return true wenn es ein RGB-Geräteplugin ist, false wenn nicht
+     */
+    bool isDevicePlugin(const QString &filePath);
+
+    /**
+     * @brief Prüft, ob ein Plugin aktiviert ist
+     * @param fileName Dateiname des Plugins (ohne Pfad)
+     * @return true wenn aktiviert, false wenn deaktiviert
+     */
+    bool isEnabled(const QString &fileName) const;
+
+    /**
+     * @brief Aktiviert oder deaktiviert ein Plugin
+     * @param fileName Dateiname des Plugins (ohne Pfad)
+     * @param enabled true um zu aktivieren, false um zu deaktivieren
+     */
+    void setEnabled(const QString &fileName, bool enabled);
+
+    /**
+     * @brief Entfernt Einträge für Dateien, die nicht mehr existieren
+     * @param existingPaths Pfade aller aktuell vorhandenen Plugin-Dateien
+     */
+    void prune(const QStringList &existingPaths);
+
+    /**
+     * @brief Speichert den Cache, falls er sich geändert hat
+     */
+    void save();
+
+private:
+    /**
+     * @brief Lädt den Cache aus den Einstellungen
+     */
+    void load();
+
+private:
+    struct Entry {
+        qint64 lastModified;
+        qint64 size;
+        QJsonObject metaData;
+    };
+
+    QSettings m_settings;
+    QMap<QString, Entry> m_entries;
+    QSet<QString> m_disabledPlugins;
+    bool m_dirty;
+};
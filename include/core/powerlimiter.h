@@ -0,0 +1,187 @@
+#pragma once
+
+#include <QString>
+#include <QStringList>
+#include <QHash>
+#include <QVector>
+#include <QRgb>
+#include <QJsonObject>
+
+/**
+ * @brief Begrenzt die geschätzte Stromaufnahme adressierbarer LED-Streifen
+ *
+ * Für jedes Gerät mit Budget wird pro Frame die Summe aller Kanalwerte gebildet und daraus
+ * der Strom geschätzt: channelCurrentMa bei vollem Kanal, linear skaliert, plus
+ * idleCurrentMa je LED. Geräte können zusätzlich einer Versorgungsschiene zugeordnet
+ * werden, deren Budget sich alle Geräte der Schiene teilen; dafür zählt der zuletzt
+ * geschätzte Strom der übrigen Geräte.
+ *
+ * Wird ein Budget überschritten, wird die Helligkeit sofort so weit gesenkt, dass es
+ * eingehalten wird. Erholt sich die Last, steigt sie nur um ReleaseRate des Abstands
+ * pro Frame wieder an, damit wechselnde Frames nicht flackern. Solange kein Budget
+ * überschritten ist, bleibt es bei dem einen Summendurchlauf.
+ */
+class PowerLimiter
+{
+public:
+    /**
+     * @brief Anteil, um den sich die Helligkeit pro Frame wieder dem Ziel nähert
+     */
+    static constexpr double ReleaseRate = 0.05;
+    
+    /**
+     * @brief Budget und Strommodell eines Geräts
+     */
+    struct DeviceBudget {
+        int maxCurrentMa = 0;           // 0: kein eigenes Budget, nur das der Schiene
+        QString rail;                   // Leer: keiner Schiene zugeordnet
+        double channelCurrentMa = 20.0; // Strom eines voll ausgesteuerten Kanals
+        double idleCurrentMa = 1.0;     // Ruhestrom je LED
+    };
+    
+    /**
+     * @brief Zähler und Zustand eines Geräts
+     */
+    struct Statistics {
+        quint64 frames = 0;             // Geprüfte Frames
+        quint64 limitedFrames = 0;      // Gedimmte Frames
+        double requestedCurrentMa = 0;  // Geschätzter Strom des letzten Frames ohne Begrenzung
+        double deliveredCurrentMa = 0;  // Geschätzter Strom des letzten Frames nach Begrenzung
+        double peakCurrentMa = 0;       // Größter angeforderter Strom
+        double scale = 1.0;             // Aktuelle Helligkeit (1: unbegrenzt)
+    };
+    
+    /**
+     * @brief Legt das Budget eines Geräts fest
+     * @param deviceId ID des Geräts
+     * @param budget Budget und Strommodell
+     */
+    void setDeviceBudget(const QString &deviceId, const DeviceBudget &budget);
+    
+    /**
+     * @brief Entfernt das Budget eines Geräts
+     * @param deviceId ID des Geräts
+     */
+    void removeDeviceBudget(const QString &deviceId);
+    
+    /**
+     * @brief Gibt das Budget eines Geräts zurück
+     * @param deviceId ID des Geräts
+     * @return Budget (leer, wenn keines festgelegt ist)
+     */
+    DeviceBudget getDeviceBudget(const QString &deviceId) const;
+    
+    /**
+     * @brief Legt das Budget einer Versorgungsschiene fest
+     * @param rail Name der Schiene
+     * @param maxCurrentMa Höchster Strom in mA, 0 entfernt die Schiene
+     */
+    void setRailBudget(const QString &rail, int maxCurrentMa);
+    
+    /**
+     * @brief Gibt das Budget einer Versorgungsschiene zurück
+     * @param rail Name der Schiene
+     * @return Höchster Strom in mA, 0 wenn unbekannt
+     */
+    int getRailBudget(const QString &rail) const;
+    
+    /**
+     * @brief Prüft, ob für ein Gerät ein Budget festgelegt ist
+     * @param deviceId ID des Geräts
+     * @return true wenn Frames des Geräts geprüft werden
+     */
+    bool isLimited(const QString &deviceId) const;
+    
+    /**
+     * @brief Prüft einen Frame und dimmt ihn bei Überschreitung
+     *
+     * frame und output dürfen derselbe Puffer sein.
+     * @param deviceId ID des Geräts
+     * @param frame Frame
+     * @param output Ziel für den gedimmten Frame
+     * @return true wenn output geschrieben wurde, false wenn frame unverändert gilt
+     */
+    bool limit(const QString &deviceId, const QVector<QRgb> &frame, QVector<QRgb> &output);
+    
+    /**
+     * @brief Prüft eine Farbe für alle LEDs eines Geräts
+     * @param deviceId ID des Geräts
+     * @param color Farbe
+     * @param ledCount Anzahl der LEDs
+     * @return Gegebenenfalls gedimmte Farbe
+     */
+    QRgb limit(const QString &deviceId, QRgb color, int ledCount);
+    
+    /**
+     * @brief Vergisst den letzten Strom eines Geräts, z.B. wenn es getrennt wurde
+     * @param deviceId ID des Geräts
+     */
+    void resetDevice(const QString &deviceId);
+    
+    /**
+     * @brief Gibt die Zähler eines Geräts zurück
+     * @param deviceId ID des Geräts
+     * @return Zähler
+     */
+    Statistics getStatistics(const QString &deviceId) const;
+    
+    /**
+     * @brief Gibt die IDs aller Geräte mit Budget zurück
+     * @return Geräte-IDs
+     */
+    QStringList getLimitedDeviceIds() const;
+    
+    /**
+     * @brief Speichert Schienen und Budgets als JSON
+     * @return JSON-Objekt
+     */
+    QJsonObject toJson() const;
+    
+    /**
+     * @brief Ersetzt Schienen und Budgets durch die aus JSON
+     * @param json JSON-Objekt (siehe toJson)
+     * @return true wenn erfolgreich, false wenn das Objekt ungültig ist
+     */
+    bool fromJson(const QJsonObject &json);
+    
+    /**
+     * @brief Summiert Rot, Grün und Blau aller Farben
+     * @param colors Farben
+     * @param count Anzahl
+     * @return Summe aller Kanalwerte
+     */
+    static quint64 channelSum(const QRgb *colors, int count);
+
+private:
+    /**
+     * @brief Budget und Zustand eines Geräts
+     */
+    struct DeviceState {
+        DeviceBudget budget;
+        double ledCurrentMa = 0;    // Angeforderter Strom der LEDs im letzten Frame
+        double idleCurrentMa = 0;   // Ruhestrom aller LEDs
+        Statistics statistics;
+    };
+    
+    /**
+     * @brief Schätzt den Strom und berechnet die neue Helligkeit
+     * @param state Zustand des Geräts
+     * @param sum Summe aller Kanalwerte
+     * @param ledCount Anzahl der LEDs
+     * @return Helligkeit als Faktor von 0 bis 256
+     */
+    int update(DeviceState &state, quint64 sum, int ledCount);
+    
+    /**
+     * @brief Dimmt Farben mit einem festen Faktor
+     * @param source Quelle
+     * @param target Ziel (darf gleich der Quelle sein)
+     * @param count Anzahl
+     * @param factor Faktor von 0 bis 256
+     */
+    static void scale(const QRgb *source, QRgb *target, int count, int factor);
+
+private:
+    QHash<QString, DeviceState> m_devices;
+    QHash<QString, int> m_rails;
+};
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "core/rgbcontroller.h"
+#include "core/profilewriter.h"
 #include <QObject>
 #include <QString>
 #include <QStringList>
@@ -48,9 +49,12 @@ public:
     
     /**
      * @brief Speichert ein Profil
+     *
+     * Der aktuelle Zustand wird sofort erfasst, die Datei aber asynchron auf dem
+     * I/O-Thread geschrieben. profileSaved() wird ausgelöst, sobald sie auf der Platte ist.
      * @param profileName Name des Profils (ohne Dateiendung)
      * @param includeTemperatureRules Ob Temperaturregeln gespeichert werden sollen
-     * @return true wenn erfolgreich, false wenn fehlgeschlagen
+     * @return true wenn der Speicherauftrag angenommen wurde, false wenn fehlgeschlagen
      */
     bool saveProfile(const QString &profileName, bool includeTemperatureRules = true);
     
@@ -142,6 +146,7 @@ private:
 
 private:
     RGBController *m_rgbController;
+    ProfileWriter *m_writer;
     QDir m_profilesDir;
     QString m_defaultProfilePath;
 };
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <QObject>
+#include <QString>
+#include <QMap>
+#include <QSet>
+#include <QMutex>
+#include <QThread>
+#include <QJsonObject>
+
+/**
+ * @brief Schreibt Profildateien asynchron auf einem eigenen I/O-Thread
+ *
+ * Profile werden atomar gespeichert (temporäre Datei, fsync, rename über QSaveFile),
+ * sodass ein Absturz nie eine halb geschriebene Profildatei hinterlässt.
+ * Mehrere Speicheraufträge für dasselbe Profil, die eintreffen, bevor der I/O-Thread
+ * sie abgearbeitet hat, werden zusammengefasst; geschrieben wird nur der neueste Stand.
+ */
+class ProfileWriter : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Konstruktor
+     * @param parent Parent-Objekt
+     */
+    explicit ProfileWriter(QObject *parent = nullptr);
+
+    /**
+     * @brief Destruktor
+     *
+     * Schreibt alle noch ausstehenden Profile, bevor der I/O-Thread beendet wird.
+     */
+    ~ProfileWriter();
+
+    /**
+     * @brief Reiht ein Profil zum Schreiben ein
+     *
+     * Ein noch nicht geschriebener Auftrag für dasselbe Profil wird ersetzt.
+     * @param profileName Name des Profils
+     * @param filePath Zielpfad der Profildatei
+     * @param json Profilinhalt
+     */
+    void enqueue(const QString &profileName, const QString &filePath, const QJsonObject &json);
+
+    /**
+     * @brief Verwirft einen noch nicht geschriebenen Auftrag
+     * @param profileName Name des Profils
+     * @return true wenn ein Auftrag verworfen wurde
+     */
+    bool discard(const QString &profileName);
+
+    /**
+     * @brief Prüft, ob für ein Profil noch ein Schreibauftrag aussteht oder gerade läuft
+     * @param profileName Name des Profils
+     * @return true wenn ein Auftrag aussteht oder gerade geschrieben wird
+     */
+    bool isPending(const QString &profileName) const;
+
+    /**
+     * @brief Blockiert, bis alle eingereihten Profile geschrieben wurden
+     */
+    void flush();
+
+signals:
+    /**
+     * @brief Signal, das ausgelöst wird, wenn ein Profil auf die Platte geschrieben wurde
+     * @param profileName Name des Profils
+     */
+    void profileWritten(const QString &profileName);
+
+    /**
+     * @brief Signal, das ausgelöst wird, wenn das Schreiben fehlgeschlagen ist
+     * @param profileName Name des Profils
+     * @param errorMessage Fehlermeldung
+     */
+    void writeFailed(const QString &profileName, const QString &errorMessage);
+
+private:
+    /**
+     * @brief Schreibt alle ausstehenden Aufträge (läuft auf dem I/O-Thread)
+     */
+    void processPending();
+
+    /**
+     * @brief Schreibt eine Profildatei atomar (läuft auf dem I/O-Thread)
+     * @param filePath Zielpfad
+     * @param json Profilinhalt
+     * @param errorMessage Fehlermeldung bei Misserfolg
+     * @return true wenn erfolgreich, false wenn fehlgeschlagen
+     */
+    static bool writeAtomically(const QString &filePath, const QJsonObject &json, QString *errorMessage);
+
+private:
+    struct PendingWrite {
+        QString filePath;
+        QJsonObject json;
+    };
+
+    QThread m_ioThread;
+    QObject *m_ioContext;
+    mutable QMutex m_mutex;
+    QMap<QString, PendingWrite> m_pending;
+    QSet<QString> m_writing;    // Aus m_pending übernommen, aber noch nicht geschrieben
+    bool m_processScheduled;
+};
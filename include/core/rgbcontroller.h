@@ -2,13 +2,22 @@
 
 #include "core/color.h"
 #include "core/effect.h"
+#include "core/ledlayout.h"
+#include "core/effectcompositor.h"
+#include "core/frameencoder.h"
+#include "core/outputscheduler.h"
+#include "core/colorcalibration.h"
+#include "core/powerlimiter.h"
+#include "core/temporaldither.h"
+#include "core/framegovernor.h"
 #include "devices/irgbdevice.h"
 #include <QObject>
 #include <QList>
 #include <QMap>
+#include <QHash>
+#include <QVector>
 #include <QColor>
 #include <QTimer>
-#include <QSignalMapper>
 
 /**
  * @brief Controller für RGB-Geräte
@@ -80,10 +89,25 @@ public:
      */
     int setColorForAllDevices(const QColor &color);
     
+    /**
+     * @brief Gibt einen extern berechneten Frame an ein Gerät aus
+     *
+     * Für Clients, die selbst Frames streamen (z.B. über das OpenRGB-SDK). Ein laufender
+     * Effekt wird beendet; es werden keine Erfolgsmeldungen ausgelöst.
+     * @param device Gerät
+     * @param frame Eine Farbe pro LED
+     * @return true wenn erfolgreich, false wenn fehlgeschlagen
+     */
+    bool setFrameForDevice(IRGBDevice *device, const QVector<QRgb> &frame);
+    
     /**
      * @brief Setzt einen Effekt für ein Gerät
+     *
+     * Kann das Gerät den Effekt selbst ausführen (siehe IRGBDevice::getSupportedEffects),
+     * wird er an die Firmware ausgelagert und es werden keine Einzelfarben gestreamt.
+     * Andernfalls läuft der Effekt in Software.
      * @param device Gerät
-     * @param effectName Name des Effekts
+     * @param effectName Name oder kanonische ID des Effekts
      * @param parameters Parameter für den Effekt
      * @return true wenn erfolgreich, false wenn fehlgeschlagen
      */
@@ -91,6 +115,10 @@ public:
     
     /**
      * @brief Setzt einen Effekt für mehrere Geräte
+     *
+     * Alle Geräte, die den Effekt nicht in der Firmware ausführen, bilden eine Sync-Gruppe:
+     * eine einzige Effektinstanz wird pro Frame einmal berechnet und an alle Mitglieder
+     * verteilt, sodass die Geräte phasengleich laufen.
      * @param devices Liste von Geräten
      * @param effectName Name des Effekts
      * @param parameters Parameter für den Effekt
@@ -106,6 +134,216 @@ public:
      */
     int setEffectForAllDevices(const QString &effectName, const QVariantMap &parameters = QVariantMap());
     
+    /**
+     * @brief Setzt die Phasenverschiebung eines Geräts innerhalb seiner Sync-Gruppe
+     * @param device Gerät
+     * @param phaseOffset Verschiebung als Anteil einer Effektperiode (0.0 - 1.0)
+     * @return true wenn erfolgreich, false wenn das Gerät keinen Software-Effekt hat
+     */
+    bool setPhaseOffset(IRGBDevice *device, qreal phaseOffset);
+    
+    /**
+     * @brief Gibt die Phasenverschiebung eines Geräts zurück
+     * @param device Gerät
+     * @return Verschiebung als Anteil einer Effektperiode
+     */
+    qreal getPhaseOffset(IRGBDevice *device) const;
+    
+    /**
+     * @brief Legt eine Effektebene über den aktiven Effekt eines Geräts
+     *
+     * Der bisherige Effekt bzw. die gesetzte Farbe bleibt als Basis erhalten und wird
+     * mit allen Ebenen gemischt. Solange Ebenen existieren, läuft die Basis in Software.
+     * @param device Gerät
+     * @param effectName Name oder kanonische ID des Effekts
+     * @param parameters Parameter für den Effekt
+     * @param mode Mischmodus
+     * @param opacity Deckkraft (0.0 - 1.0)
+     * @return Index der Ebene oder -1, wenn fehlgeschlagen
+     */
+    int addEffectLayer(IRGBDevice *device, const QString &effectName, const QVariantMap &parameters = QVariantMap(),
+                       EffectCompositor::BlendMode mode = EffectCompositor::Normal, qreal opacity = 1.0);
+    
+    /**
+     * @brief Entfernt eine Effektebene eines Geräts
+     * @param device Gerät
+     * @param layerIndex Index der Ebene
+     * @return true wenn erfolgreich, false wenn die Ebene nicht existiert
+     */
+    bool removeEffectLayer(IRGBDevice *device, int layerIndex);
+    
+    /**
+     * @brief Setzt die LED-Maske einer Effektebene
+     * @param device Gerät
+     * @param layerIndex Index der Ebene
+     * @param mask Gewicht pro LED (0-255), leer für keine Maske
+     * @return true wenn erfolgreich, false wenn die Ebene nicht existiert
+     */
+    bool setEffectLayerMask(IRGBDevice *device, int layerIndex, const QVector<quint8> &mask);
+    
+    /**
+     * @brief Setzt die Deckkraft einer Effektebene
+     * @param device Gerät
+     * @param layerIndex Index der Ebene
+     * @param opacity Deckkraft (0.0 - 1.0)
+     * @return true wenn erfolgreich, false wenn die Ebene nicht existiert
+     */
+    bool setEffectLayerOpacity(IRGBDevice *device, int layerIndex, qreal opacity);
+    
+    /**
+     * @brief Entfernt alle Effektebenen eines Geräts
+     *
+     * Unterstützt die Firmware den Basiseffekt, wird er wieder an sie ausgelagert.
+     * @param device Gerät
+     */
+    void clearEffectLayers(IRGBDevice *device);
+    
+    /**
+     * @brief Gibt die Anzahl der Effektebenen eines Geräts zurück
+     * @param device Gerät
+     * @return Anzahl der Ebenen (ohne Basis)
+     */
+    int getEffectLayerCount(IRGBDevice *device) const;
+    
+    /**
+     * @brief Gibt das räumliche LED-Layout zurück
+     *
+     * Geräte, die im Layout platziert sind, werden von periodischen Effekten mit dem
+     * Parameter "spatial" (Standard für "wave") positionsabhängig angesteuert.
+     * Weitere Parameter: "direction" (Winkel in Grad in der XY-Ebene) und "periods"
+     * (Anzahl der Effektperioden über das gesamte Layout).
+     * @return LED-Layout
+     */
+    LedLayout* getLayout() const;
+    
+    /**
+     * @brief Gibt die Anzahl der laufenden Effektinstanzen zurück
+     * @return Anzahl der Sync-Gruppen
+     */
+    int getActiveEffectCount() const;
+    
+    /**
+     * @brief Gibt die Anzahl der bisher erzeugten Effektinstanzen zurück
+     *
+     * Effekte werden aus Pools je Typ wiederverwendet oder an Ort und Stelle
+     * umkonfiguriert. Im eingeschwungenen Zustand (z.B. Temperaturkopplung) darf
+     * dieser Zähler daher nicht mehr steigen.
+     * @return Anzahl der Allokationen von Effekten samt Sync-Gruppe
+     */
+    quint64 getEffectAllocationCount() const;
+    
+    /**
+     * @brief Gibt die Anzahl der Effektinstanzen zurück, die im Pool auf Wiederverwendung warten
+     * @return Anzahl der gepoolten Effekte
+     */
+    int getPooledEffectCount() const;
+    
+    /**
+     * @brief Gibt die Anzahl der bestehenden Verbindungen von Effekten zum Controller zurück
+     *
+     * Zählt die tatsächlich an colorChanged verbundenen Empfänger aller aktiven und
+     * gepoolten Effekte. Jede Instanz hält genau eine Verbindung; beliebig viele
+     * Effektwechsel dürfen diese Zahl nicht über die Anzahl der Instanzen wachsen lassen.
+     * @return Anzahl der Verbindungen
+     */
+    int getEffectConnectionCount() const;
+    
+    /**
+     * @brief Gibt den Scheduler zurück, der die Ausgabe nach Bildrate und Latenz plant
+     * @return Output-Scheduler (für Statistiken je Gerät und den Latenzausgleich)
+     */
+    OutputScheduler *getOutputScheduler() const;
+    
+    /**
+     * @brief Legt die Ausgabekalibrierung eines Geräts fest
+     *
+     * Gilt ab dem nächsten geschriebenen Frame. Eine neutrale Kalibrierung entfernt den
+     * Eintrag, sodass die Ausgabe ohne zusätzlichen Durchlauf erfolgt. Firmware-Effekte
+     * werden nicht kalibriert.
+     * @param deviceId ID des Geräts
+     * @param calibration Kalibrierung
+     */
+    void setCalibration(const QString &deviceId, const ColorCalibration &calibration);
+    
+    /**
+     * @brief Gibt die Ausgabekalibrierung eines Geräts zurück
+     * @param deviceId ID des Geräts
+     * @return Kalibrierung (neutral, wenn keine festgelegt ist)
+     */
+    ColorCalibration getCalibration(const QString &deviceId) const;
+    
+    /**
+     * @brief Gibt die IDs aller Geräte mit nicht neutraler Kalibrierung zurück
+     * @return Geräte-IDs
+     */
+    QStringList getCalibratedDeviceIds() const;
+    
+    /**
+     * @brief Schaltet zeitliches Dithering für ein Gerät ein oder aus
+     *
+     * Einfarbige Ausgaben (auch von Effekten) werden dann mit 16 Bit kalibriert und über
+     * aufeinanderfolgende Frames auf 8 Bit verteilt. Frames pro LED bleiben unverändert.
+     * @param deviceId ID des Geräts
+     * @param enabled true zum Einschalten
+     */
+    void setDitheringEnabled(const QString &deviceId, bool enabled);
+    
+    /**
+     * @brief Prüft, ob ein Gerät gedithert wird
+     * @param deviceId ID des Geräts
+     * @return true wenn eingeschaltet
+     */
+    bool isDitheringEnabled(const QString &deviceId) const;
+    
+    /**
+     * @brief Gibt die IDs aller geditherten Geräte zurück
+     * @return Geräte-IDs
+     */
+    QStringList getDitheredDeviceIds() const;
+    
+    /**
+     * @brief Gibt den Governor zurück, der die CPU-Last der Effekte begrenzt
+     * @return Governor (Budget, aktuelle Stufe und Zähler)
+     */
+    FrameGovernor *getFrameGovernor() const;
+    
+    /**
+     * @brief Gibt die Strombegrenzung zurück
+     *
+     * Geprüft wird jeder Frame nach Ebenen und Kalibrierung, direkt vor der Übertragung.
+     * @return Strombegrenzung (Budgets je Gerät und Schiene, Zähler)
+     */
+    PowerLimiter *getPowerLimiter();
+    
+    /**
+     * @brief Gibt die summierten Kodierungszähler aller Geräte mit Teilaktualisierungen zurück
+     *
+     * Das Verhältnis von encodedBytes zu rawBytes zeigt die eingesparte Bandbreite.
+     * @return Zähler aller Frame-Encoder
+     */
+    FrameEncoder::Statistics getEncoderStatistics() const;
+    
+    /**
+     * @brief Gibt die kanonische ID des aktiven Effekts eines Geräts zurück
+     * @param device Gerät
+     * @return Kanonische Effekt-ID oder leerer String, wenn kein Effekt aktiv ist
+     */
+    QString getActiveEffectId(IRGBDevice *device) const;
+    
+    /**
+     * @brief Gibt die Parameter des aktiven Effekts eines Geräts zurück
+     * @param device Gerät
+     * @return Parameter-Map
+     */
+    QVariantMap getActiveEffectParameters(IRGBDevice *device) const;
+    
+    /**
+     * @brief Prüft, ob der aktive Effekt eines Geräts in der Firmware läuft
+     * @param device Gerät
+     * @return true wenn ausgelagert, false wenn er in Software läuft oder keiner aktiv ist
+     */
+    bool isEffectOffloaded(IRGBDevice *device) const;
+    
     /**
      * @brief Erstellt einen Effekt
      * @param effectName Name des Effekts
@@ -132,6 +370,15 @@ public:
      */
     bool isTemperatureLinkingEnabled() const;
     
+    /**
+     * @brief Prüft, ob alle Ausgaben statisch sind
+     *
+     * Das ist der Fall, wenn kein Effekt und keine Ebene animiert und keine Farbe von
+     * Sensorwerten abhängt. Dann erzeugt der Controller ohne äußeren Anstoß keine Frames.
+     * @return true wenn nichts animiert
+     */
+    bool isIdle() const;
+    
     /**
      * @brief Aktualisiert die Temperaturwerte
      * @param cpuTemp CPU-Temperatur (0-100)
@@ -147,6 +394,16 @@ signals:
      */
     void colorChanged(const QString &deviceId, const QColor &color);
     
+    /**
+     * @brief Signal, das für jede Ausgabe an ein Gerät ausgelöst wird
+     *
+     * Auch einheitliche Farben werden als Frame mit einer Farbe pro LED gemeldet; der
+     * Puffer dafür wird je Gerät wiederverwendet. Der Frame ist nur während des Aufrufs gültig.
+     * @param deviceId ID des Geräts
+     * @param frame Ausgegebene Farbe pro LED
+     */
+    void frameChanged(const QString &deviceId, const QVector<QRgb> &frame);
+    
     /**
      * @brief Signal, das bei Effektänderung ausgelöst wird
      * @param deviceId ID des Geräts
@@ -165,19 +422,230 @@ signals:
      * @param message Fehlermeldung
      */
     void actionError(const QString &message);
+    
+    /**
+     * @brief Signal, das ausgelöst wird, wenn die Ausgaben statisch werden oder wieder animieren
+     * @param idle true wenn nichts mehr animiert
+     */
+    void idleChanged(bool idle);
 
-private slots:
+private:
+    /**
+     * @brief Gruppe von Geräten, die von derselben Effektinstanz angesteuert werden
+     */
+    struct EffectGroup {
+        Effect *effect;
+        QMetaObject::Connection connection;  // Einzige Verbindung des Effekts zum Controller
+        QList<IRGBDevice*> devices;
+        QMap<IRGBDevice*, qreal> phaseOffsets;
+        
+        // Positionsabhängige Ausgabe über das LED-Layout
+        bool spatial;
+        QVector3D direction;
+        qreal periods;
+        QVector<QRgb> palette;
+        QHash<IRGBDevice*, QVector<QRgb>> frames;
+        QHash<IRGBDevice*, LedLayout::PhaseTable> phaseTables;
+        
+        // Verringerte Qualität über dem CPU-Budget
+        int skippedFrames;
+        QVector<QRgb> sampledFrame;
+        QVector<QVector3D> sampledPositions;
+    };
+    
+    /**
+     * @brief Wendet einen Effekt auf Geräte an (Firmware oder gemeinsame Software-Instanz)
+     * @param devices Liste von Geräten
+     * @param effectName Name oder kanonische ID des Effekts
+     * @param parameters Parameter für den Effekt
+     * @return Anzahl der Geräte, bei denen der Effekt gesetzt wurde
+     */
+    int applyEffect(const QList<IRGBDevice*> &devices, const QString &effectName, const QVariantMap &parameters);
+    
+    /**
+     * @brief Setzt eine Farbe ohne Erfolgsmeldung
+     *
+     * Läuft auf dem Gerät bereits ein eigener statischer Effekt, wird dieser nur
+     * umkonfiguriert; sonst kommt ein statischer Effekt aus dem Pool.
+     * @param device Gerät
+     * @param color Farbe
+     * @return true wenn erfolgreich, false wenn fehlgeschlagen
+     */
+    bool applyColor(IRGBDevice *device, const QColor &color);
+    
+    /**
+     * @brief Holt eine Sync-Gruppe mit Effekt eines Typs aus dem Pool oder legt sie an
+     *
+     * Gruppe und Effekt bleiben dauerhaft verbunden, sodass beim Wiederverwenden weder
+     * Objekte noch Signalverbindungen neu erzeugt werden. Die Parameter des Effekts
+     * müssen anschließend gesetzt und die Geräte über bindDevice() zugeordnet werden.
+     * @param type Effekttyp
+     * @return Gruppe ohne Mitglieder
+     */
+    EffectGroup* acquireEffectGroup(Effect::Type type);
+    
+    /**
+     * @brief Stoppt den Effekt einer leeren Gruppe und legt sie in den Pool zurück
+     * @param group Sync-Gruppe
+     */
+    void releaseEffectGroup(EffectGroup *group);
+    
+    /**
+     * @brief Trennt die Verbindung einer Gruppe und löscht sie samt Effekt
+     * @param group Sync-Gruppe
+     */
+    void destroyEffectGroup(EffectGroup *group);
+    
+    /**
+     * @brief Übernimmt die räumlichen Parameter des Effekts in die Gruppe
+     * @param group Sync-Gruppe
+     */
+    void configureGroupLayout(EffectGroup *group);
+    
+    /**
+     * @brief Ordnet ein Gerät einer Gruppe zu
+     * @param group Sync-Gruppe
+     * @param device Gerät
+     */
+    void bindDevice(EffectGroup *group, IRGBDevice *device);
+    
+    /**
+     * @brief Berechnet einen Frame aus Palette und Phasentabelle für ein platziertes Gerät
+     * @param group Sync-Gruppe
+     * @param device Gerät (muss im Layout platziert sein)
+     * @return Frame mit einer Farbe pro LED
+     */
+    const QVector<QRgb> &renderSpatialFrame(EffectGroup *group, IRGBDevice *device);
+    
+    /**
+     * @brief Berechnet einen Frame eines Effekts, der jede LED einzeln rendert
+     * @param group Sync-Gruppe
+     * @param device Gerät
+     * @return Frame mit einer Farbe pro LED
+     */
+    const QVector<QRgb> &renderPerLedFrame(EffectGroup *group, IRGBDevice *device);
+    
+    /**
+     * @brief Tastet die Palette einer räumlichen Gruppe ab, über dem CPU-Budget gröber
+     * @param group Sync-Gruppe
+     */
+    void renderGroupPalette(EffectGroup *group);
+    
+    /**
+     * @brief Gibt eine Farbe an ein Gerät aus, bei Ebenen als Basis an dessen Compositor
+     * @param device Gerät
+     * @param color Farbe
+     */
+    void writeDeviceColor(IRGBDevice *device, const QColor &color);
+    
+    /**
+     * @brief Gibt einen Frame an ein Gerät aus, bei Ebenen als Basis an dessen Compositor
+     * @param device Gerät
+     * @param frame Eine Farbe pro LED
+     */
+    void writeDeviceFrame(IRGBDevice *device, const QVector<QRgb> &frame);
+    
+    /**
+     * @brief Füllt den wiederverwendeten Einfarb-Frame eines Geräts
+     * @param device Gerät
+     * @param color Farbe
+     * @return Frame mit der Farbe für jede LED
+     */
+    const QVector<QRgb> &solidFrame(IRGBDevice *device, const QColor &color);
+    
+    /**
+     * @brief Gibt eine Farbe direkt an ein Gerät aus
+     *
+     * Geräte mit Teilaktualisierungen erhalten einen Einfarb-Frame über ihren Encoder,
+     * damit der bestätigte Frame aktuell bleibt. Für geditherte Geräte wird die Farbe
+     * mit 16 Bit kalibriert und erst in transmitFrame() auf 8 Bit verteilt.
+     * @param device Gerät
+     * @param color Farbe
+     * @return true wenn erfolgreich, false wenn fehlgeschlagen
+     */
+    bool outputColor(IRGBDevice *device, const QColor &color);
+    
+    /**
+     * @brief Gibt einen Frame an ein Gerät aus, sobald dessen Bildrate es zulässt
+     *
+     * Hat das Gerät eine Kalibrierung oder ein Strombudget, wird der Frame zuerst in einen
+     * Puffer je Gerät kalibriert bzw. gedimmt.
+     * Ist das Gerät noch im Frame-Intervall des vorherigen Frames, hält der
+     * OutputScheduler den Frame zurück und ersetzt ihn bei weiteren Frames. Geräte mit
+     * kleinerer Latenz als das langsamste erhalten den Frame entsprechend später.
+     * @param device Gerät
+     * @param frame Eine Farbe pro LED
+     * @return true wenn geschrieben oder eingeplant, false wenn fehlgeschlagen
+     */
+    bool outputFrame(IRGBDevice *device, const QVector<QRgb> &frame);
+    
+    /**
+     * @brief Gibt einen fertig kalibrierten Frame an Strombegrenzung und Scheduler weiter
+     * @param device Gerät
+     * @param frame Eine Farbe pro LED
+     * @return true wenn geschrieben oder eingeplant, false wenn fehlgeschlagen
+     */
+    bool submitFrame(IRGBDevice *device, const QVector<QRgb> &frame);
+    
+    /**
+     * @brief Schreibt einen Frame sofort an ein Gerät
+     *
+     * Unterstützt das Gerät Teilaktualisierungen, wird nur die kleinste Kodierung der
+     * Änderung übertragen; lehnt das Gerät sie ab, folgt der ganze Frame. Für geditherte
+     * Geräte wird hier der nächste Dithering-Frame erzeugt und auf das Strombudget geprüft.
+     * @param device Gerät
+     * @param frame Eine Farbe pro LED
+     * @return true wenn erfolgreich, false wenn fehlgeschlagen
+     */
+    bool transmitFrame(IRGBDevice *device, const QVector<QRgb> &frame);
+    
+    /**
+     * @brief Verteilt eine Effektfarbe an alle Mitglieder einer Gruppe
+     * @param group Sync-Gruppe
+     * @param color Farbe ohne Phasenverschiebung
+     */
+    void dispatchGroupColor(EffectGroup *group, const QColor &color);
+    
+    /**
+     * @brief Sucht den Firmware-Effekt eines Geräts, der einem Effekttyp entspricht
+     * @param device Gerät
+     * @param type Effekttyp
+     * @return Name des Firmware-Effekts oder leerer String, wenn das Gerät ihn nicht kann
+     */
+    QString negotiateHardwareEffect(IRGBDevice *device, Effect::Type type) const;
+    
+    /**
+     * @brief Prüft, ob noch etwas animiert, und meldet Änderungen über idleChanged()
+     */
+    void updateIdleState();
+    
     /**
-     * @brief Aktualisiert die Farbe für ein Gerät basierend auf dem aktiven Effekt
+     * @brief Beendet den Firmware-Effekt eines Geräts bzw. nimmt es aus seiner Sync-Gruppe
      * @param deviceId ID des Geräts
      */
-    void updateDeviceColor(const QString &deviceId);
+    void removeEffect(const QString &deviceId);
 
 private:
     QList<IRGBDevice*> m_devices;
-    QMap<QString, Effect*> m_deviceEffects;
-    QSignalMapper *m_effectMapper;
+    QList<EffectGroup*> m_effectGroups;
+    QMap<QString, EffectGroup*> m_deviceGroups;
+    QHash<int, QList<EffectGroup*>> m_groupPool;
+    quint64 m_effectAllocations;
+    QMap<QString, QString> m_offloadedEffects;
+    QMap<QString, EffectCompositor*> m_compositors;
+    QHash<QString, QVector<QRgb>> m_solidFrames;
+    QHash<QString, FrameEncoder> m_encoders;
+    QHash<QString, ColorCalibration> m_calibrations;
+    QHash<QString, QVector<QRgb>> m_outputFrames;
+    PowerLimiter m_powerLimiter;
+    QHash<QString, TemporalDither> m_dithers;
+    QHash<QString, QRgba64> m_ditherTargets;
+    QHash<QString, QVector<QRgb>> m_ditherFrames;
+    OutputScheduler *m_scheduler;
+    FrameGovernor *m_governor;
+    LedLayout *m_layout;
     bool m_temperatureLinkingEnabled;
+    bool m_idle;
     int m_cpuTemperature;
     int m_gpuTemperature;
 };
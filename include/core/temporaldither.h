@@ -0,0 +1,34 @@
+#pragma once
+
+#include <QVector>
+#include <QRgb>
+#include <QRgba64>
+
+/**
+ * @brief Zeitliches Dithering einer 16-Bit-Farbe auf 8-Bit-LEDs
+ *
+ * Jede LED trägt je Kanal den Rundungsfehler des letzten Frames in den nächsten weiter
+ * (Fehlerdiffusion über die Zeit). Über mehrere Frames gemittelt zeigt die LED so Zwischenwerte,
+ * die 8 Bit allein nicht darstellen können; langsame Überblendungen im dunklen Bereich
+ * laufen dadurch ohne sichtbare Stufen. Die Startfehler der LEDs sind gestreut, damit nicht
+ * alle LEDs im selben Frame umschalten, was zusätzlich räumlich dithert.
+ */
+class TemporalDither
+{
+public:
+    /**
+     * @brief Berechnet den nächsten Frame für eine Farbe auf allen LEDs
+     * @param color Farbe mit 16 Bit pro Kanal
+     * @param ledCount Anzahl der LEDs
+     * @param frame Ziel, wird auf ledCount gebracht (Puffer wird wiederverwendet)
+     */
+    void render(QRgba64 color, int ledCount, QVector<QRgb> &frame);
+    
+    /**
+     * @brief Setzt die Fehler auf ihre gestreuten Startwerte zurück
+     */
+    void reset();
+
+private:
+    QVector<quint8> m_error;    // Drei Einträge pro LED, in 1/256 einer 8-Bit-Stufe
+};
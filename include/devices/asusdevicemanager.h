@@ -3,6 +3,7 @@
 #include "devices/asusrgbdevice.h"
 #include <QObject>
 #include <QList>
+#include <QStringList>
 
 /**
  * @brief Manager für ASUS RGB-Geräte
@@ -37,7 +38,33 @@ public:
      */
     QList<AsusRGBDevice*> getDevices() const;
 
+    /**
+     * @brief Sucht erneut nach ASUS RGB-Geräten und meldet nur die Änderungen
+     *
+     * Bereits bekannte Geräte bleiben unverändert erhalten. Entfernte Geräte werden
+     * per deleteLater() freigegeben und sind bis zur Rückkehr in die Ereignisschleife gültig.
+     * @param addedDevices Wird mit den neu gefundenen Geräten gefüllt
+     * @param removedDeviceIds Wird mit den IDs der entfernten Geräte gefüllt
+     * @return true wenn erfolgreich, false wenn fehlgeschlagen
+     */
+    bool rescanDevices(QList<AsusRGBDevice*> &addedDevices, QStringList &removedDeviceIds);
+
 private:
+    /**
+     * @brief Beschreibung eines gefundenen, noch nicht instanziierten Geräts
+     */
+    struct DeviceInfo {
+        QString id;
+        QString name;
+        QString type;
+    };
+
+    /**
+     * @brief Fragt die aktuell angeschlossenen ASUS RGB-Geräte ab
+     * @return Liste der gefundenen Geräte
+     */
+    QList<DeviceInfo> enumerateDevices() const;
+
     /**
      * @brief Sucht nach ASUS RGB-Geräten
      */
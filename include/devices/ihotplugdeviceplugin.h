@@ -0,0 +1,36 @@
+#pragma once
+
+#include "irgbdevice.h"
+#include <QtPlugin>
+#include <QList>
+#include <QStringList>
+
+/**
+ * @brief Optionales Interface für Plugins mit inkrementeller Gerätesuche
+ *
+ * Plugins, die dieses Interface zusätzlich zu IRGBDevicePlugin implementieren
+ * (Q_INTERFACES(IRGBDevicePlugin IHotplugDevicePlugin)), können neu angeschlossene
+ * und entfernte Geräte als Differenz melden, ohne dass der DeviceManager das Plugin
+ * neu laden muss. Unveränderte Geräte behalten ihre Objekte und laufenden Effekte.
+ *
+ * Besitzt das Plugin-Objekt ein Signal devicesChanged(), ruft der DeviceManager
+ * bei dessen Auslösung automatisch DeviceManager::rescanDevices() auf.
+ */
+class IHotplugDevicePlugin {
+public:
+    virtual ~IHotplugDevicePlugin() = default;
+
+    /**
+     * @brief Sucht erneut nach Geräten und meldet nur die Änderungen
+     *
+     * Entfernte Geräte müssen mindestens bis zur Rückkehr in die Ereignisschleife
+     * gültig bleiben (z.B. per deleteLater() freigeben), damit der DeviceManager
+     * sie noch abmelden kann.
+     * @param addedDevices Wird mit den neu gefundenen Geräten gefüllt
+     * @param removedDeviceIds Wird mit den IDs der nicht mehr vorhandenen Geräte gefüllt
+     * @return true wenn die Suche erfolgreich war, false wenn fehlgeschlagen
+     */
+    virtual bool rescanDevices(QList<IRGBDevice*> &addedDevices, QStringList &removedDeviceIds) = 0;
+};
+
+Q_DECLARE_INTERFACE(IHotplugDevicePlugin, "org.lumincontrol.IHotplugDevicePlugin")
@@ -1,7 +1,10 @@
 #pragma once
 
+#include "devices/ledframeupdate.h"
 #include <QString>
+#include <QStringList>
 #include <QColor>
+#include <QVector>
 #include <QVariantMap>
 
 /**
@@ -39,6 +42,63 @@ public:
      */
     virtual bool setColor(const QColor &color) = 0;
     
+    /**
+     * @brief Gibt die Anzahl der einzeln ansteuerbaren LEDs zurück
+     * @return Anzahl der LEDs (1 für Geräte, die nur eine Farbe kennen)
+     */
+    virtual int getLedCount() const { return 1; }
+    
+    /**
+     * @brief Setzt die Farben aller LEDs auf einmal
+     *
+     * Geräte ohne Einzel-LED-Ansteuerung übernehmen die erste Farbe.
+     * @param colors Eine Farbe pro LED
+     * @return true wenn erfolgreich, false wenn fehlgeschlagen
+     */
+    virtual bool setLedColors(const QVector<QRgb> &colors)
+    {
+        return !colors.isEmpty() && setColor(QColor::fromRgb(colors.first()));
+    }
+    
+    /**
+     * @brief Gibt die Teilaktualisierungen zurück, die das Gerät annehmen kann
+     *
+     * Langsame Verbindungen (seriell, HID, WLAN) sparen Bandbreite, wenn statt des
+     * ganzen Frames nur Änderungen übertragen werden. Der RGBController wählt dann
+     * je Frame die kleinste unterstützte Kodierung.
+     * @return Bitmaske aus LedFrameUpdate::Encoding, LedFrameUpdate::Full wenn keine
+     */
+    virtual int getSupportedEncodings() const { return LedFrameUpdate::Full; }
+    
+    /**
+     * @brief Überträgt eine kodierte Teilaktualisierung
+     *
+     * Gibt das Gerät false zurück (z.B. weil die Aktualisierung nicht in seine
+     * Paketpuffer passt), sendet der RGBController stattdessen den ganzen Frame.
+     * @param update Änderung gegenüber dem zuletzt übertragenen Frame
+     * @return true wenn übertragen, false wenn der ganze Frame gesendet werden soll
+     */
+    virtual bool setLedUpdate(const LedFrameUpdate &update)
+    {
+        Q_UNUSED(update);
+        return false;
+    }
+    
+    /**
+     * @brief Gibt die höchste Bildrate zurück, mit der das Gerät Frames annehmen kann
+     *
+     * Schnellere Frames fasst der OutputScheduler des RGBControllers zusammen, statt sie
+     * beim Gerät aufzustauen.
+     * @return Frames pro Sekunde, 0 wenn unbegrenzt
+     */
+    virtual int getMaxFrameRate() const { return 0; }
+    
+    /**
+     * @brief Gibt die Zeit vom Schreiben eines Frames bis zu seiner Anzeige zurück
+     * @return Latenz in Mikrosekunden
+     */
+    virtual int getOutputLatencyUs() const { return 0; }
+    
     /**
      * @brief Gibt die aktuelle Farbe des Geräts zurück
      * @return Aktuelle Farbe
@@ -53,6 +113,16 @@ public:
      */
     virtual bool setEffect(const QString &effectName, const QVariantMap &parameters = QVariantMap()) = 0;
     
+    /**
+     * @brief Gibt die Effekte zurück, die das Gerät selbst (in der Firmware) ausführen kann
+     *
+     * Der RGBController lagert einen Effekt an das Gerät aus, wenn einer dieser Namen
+     * derselben kanonischen Effekt-ID entspricht (siehe Effect::canonicalId). Dann werden
+     * für das Gerät keine Einzelfarben mehr gestreamt.
+     * @return Liste der Firmware-Effektnamen, leer wenn das Gerät keine eigenen Effekte hat
+     */
+    virtual QStringList getSupportedEffects() const { return QStringList(); }
+    
     /**
      * @brief Gibt den Namen des aktuellen Effekts zurück
      * @return Name des aktuellen Effekts
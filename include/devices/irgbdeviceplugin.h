@@ -17,6 +17,10 @@ public:
 
     /**
      * @brief Initialisiert das Plugin
+     *
+     * Wird auf einem Worker-Thread des DeviceManagers aufgerufen. Danach wird das
+     * Plugin-Objekt samt Kindobjekten in den Hauptthread verschoben; Geräte müssen
+     * daher Kinder des Plugins sein und dürfen hier noch keine Timer starten.
      * @return true wenn erfolgreich, false wenn fehlgeschlagen
      */
     virtual bool initialize() = 0;
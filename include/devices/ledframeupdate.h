@@ -0,0 +1,43 @@
+#pragma once
+
+#include <QVector>
+#include <QRgb>
+
+/**
+ * @brief Kodierte Änderung eines LED-Frames gegenüber dem zuletzt übertragenen
+ *
+ * Wird vom RGBController an Geräte übergeben, die über getSupportedEncodings()
+ * Teilaktualisierungen anbieten. Geräte ohne diese Fähigkeit erhalten immer ganze Frames.
+ */
+struct LedFrameUpdate {
+    /**
+     * @brief Kodierungen (als Bitmaske in IRGBDevice::getSupportedEncodings())
+     */
+    enum Encoding {
+        Full = 0x0,         // Ganzer Frame über setLedColors()
+        DirtyRanges = 0x1,  // Nur geänderte LED-Bereiche
+        RunLength = 0x2     // Ganzer Frame als Folge gleichfarbiger Läufe
+    };
+    
+    /**
+     * @brief Zusammenhängender Bereich geänderter LEDs
+     */
+    struct Range {
+        int start;
+        int count;
+    };
+    
+    /**
+     * @brief Lauf gleichfarbiger LEDs
+     */
+    struct Run {
+        int count;
+        QRgb color;
+    };
+    
+    Encoding encoding = Full;
+    const QRgb *colors = nullptr;   // Vollständiger neuer Frame, gültig während des Aufrufs
+    int ledCount = 0;
+    QVector<Range> ranges;          // Bei DirtyRanges; Farben stehen in colors
+    QVector<Run> runs;              // Bei RunLength, in LED-Reihenfolge
+};
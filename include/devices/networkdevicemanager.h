@@ -0,0 +1,99 @@
+#pragma once
+
+#include "devices/networkrgbdevice.h"
+#include "devices/networkoutputsender.h"
+#include <QObject>
+#include <QList>
+#include <QStringList>
+
+/**
+ * @brief Manager für Netzwerk-LED-Geräte (E1.31, Art-Net, DDP)
+ *
+ * Liest die Geräte aus einer JSON-Konfiguration und verschickt ihre Frames über einen
+ * gemeinsamen NetworkOutputSender. Aufbau der Konfiguration:
+ * @code
+ * { "devices": [ { "id": "strip-1", "name": "Regal", "protocol": "e131",
+ *                  "host": "192.168.1.50", "ledCount": 300, "startUniverse": 1 } ] }
+ * @endcode
+ * Optional sind außerdem "port", "channelsPerUniverse", "priority", "maxFps" und "latencyMs".
+ */
+class NetworkDeviceManager : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Standardpfad der Konfiguration (relativ zum Arbeitsverzeichnis)
+     */
+    static const char *DefaultConfigPath;
+    
+    /**
+     * @brief Konstruktor
+     * @param parent Parent-QObject
+     */
+    explicit NetworkDeviceManager(QObject *parent = nullptr);
+    
+    /**
+     * @brief Destruktor
+     */
+    ~NetworkDeviceManager();
+    
+    /**
+     * @brief Initialisiert den Manager und legt die konfigurierten Geräte an
+     *
+     * Eine fehlende Konfigurationsdatei ist kein Fehler, es gibt dann keine Geräte.
+     * @param configPath Pfad der Konfigurationsdatei
+     * @return true wenn erfolgreich, false wenn die Konfiguration ungültig ist
+     */
+    bool initialize(const QString &configPath = DefaultConfigPath);
+    
+    /**
+     * @brief Gibt eine Liste aller Netzwerkgeräte zurück
+     * @return Liste von NetworkRGBDevice-Objekten
+     */
+    QList<NetworkRGBDevice*> getDevices() const;
+    
+    /**
+     * @brief Liest die Konfiguration erneut und meldet nur die Änderungen
+     *
+     * Geräte werden anhand ihrer ID verglichen; bekannte Geräte bleiben unverändert.
+     * Entfernte Geräte werden per deleteLater() freigegeben.
+     * @param addedDevices Wird mit den neu konfigurierten Geräten gefüllt
+     * @param removedDeviceIds Wird mit den IDs der entfernten Geräte gefüllt
+     * @return true wenn erfolgreich, false wenn fehlgeschlagen
+     */
+    bool rescanDevices(QList<NetworkRGBDevice*> &addedDevices, QStringList &removedDeviceIds);
+    
+    /**
+     * @brief Gibt den gemeinsamen Sender zurück (für Statistiken)
+     *
+     * Der Sender wird erst mit dem ersten konfigurierten Gerät angelegt.
+     * @return Sender, nullptr solange kein Gerät konfiguriert wurde
+     */
+    NetworkOutputSender *getSender() const;
+
+private:
+    /**
+     * @brief Liest die Gerätekonfiguration
+     * @param configs Wird mit den gültigen Gerätekonfigurationen gefüllt
+     * @return true wenn die Datei fehlt oder gültig ist, false bei ungültigem JSON
+     */
+    bool readConfig(QList<NetworkRGBDevice::Config> &configs) const;
+    
+    /**
+     * @brief Gibt den gemeinsamen Sender zurück und legt ihn bei Bedarf an
+     * @return Sender
+     */
+    NetworkOutputSender *ensureSender();
+    
+    /**
+     * @brief Entfernt alle Geräte
+     */
+    void clearDevices();
+
+private:
+    bool m_initialized;
+    QString m_configPath;
+    NetworkOutputSender *m_sender;
+    QList<NetworkRGBDevice*> m_devices;
+};
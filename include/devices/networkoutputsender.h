@@ -0,0 +1,217 @@
+#pragma once
+
+#include <QObject>
+#include <QThread>
+#include <QMutex>
+#include <QList>
+#include <QVector>
+#include <QByteArray>
+#include <QHostAddress>
+#include <atomic>
+
+#ifdef Q_OS_LINUX
+#include <netinet/in.h>
+#include <sys/socket.h>
+#endif
+
+class QUdpSocket;
+
+/**
+ * @brief Vorbelegte UDP-Pakete eines Netzwerkgeräts mit Dreifachpuffer
+ *
+ * Das Gerät schreibt jeden Frame in den Schreibpuffer und übergibt ihn mit
+ * NetworkOutputSender::submit(). Der Sendethread verschickt jeweils den neuesten
+ * übergebenen Puffer; ältere, noch nicht gesendete Frames werden übersprungen.
+ * Alle Puffer werden einmalig angelegt und danach nur noch überschrieben.
+ */
+class NetworkOutputStream
+{
+public:
+    /**
+     * @brief Konstruktor
+     * @param packetCount Anzahl der Pakete pro Frame
+     * @param packetCapacity Maximale Größe eines Pakets in Byte
+     */
+    NetworkOutputStream(int packetCount, int packetCapacity);
+    
+    /**
+     * @brief Gibt die Anzahl der Pakete pro Frame zurück
+     * @return Anzahl der Pakete
+     */
+    int getPacketCount() const;
+    
+    /**
+     * @brief Gibt ein Paket im Schreibpuffer zurück
+     * @param index Index des Pakets
+     * @return Zeiger auf den Anfang des Pakets
+     */
+    char *packet(int index);
+    
+    /**
+     * @brief Legt Länge und Ziel eines Pakets fest (gilt für alle Puffer)
+     * @param index Index des Pakets
+     * @param length Länge in Byte
+     * @param address Zieladresse
+     * @param port Zielport
+     */
+    void setPacket(int index, int length, const QHostAddress &address, quint16 port);
+
+    /**
+     * @brief Ändert die Länge eines Pakets nur für den aktuellen Frame
+     * @param index Index des Pakets
+     * @param length Länge in Byte
+     */
+    void setPacketLength(int index, int length);
+
+    /**
+     * @brief Legt fest, wie viele Pakete der aktuelle Frame sendet (Standard: alle)
+     * @param count Anzahl der ersten Pakete, die gesendet werden
+     */
+    void setActivePacketCount(int count);
+    
+    /**
+     * @brief Kopiert den Schreibpuffer in die übrigen Puffer
+     *
+     * Nach dem Aufbau der Paketköpfe aufrufen, damit alle Puffer dieselben Köpfe haben
+     * und pro Frame nur noch Nutzdaten und Sequenznummern geschrieben werden müssen.
+     */
+    void commitTemplate();
+
+private:
+    friend class NetworkOutputSender;
+    
+    int m_packetCount;
+    int m_packetCapacity;
+    QByteArray m_buffers[3];
+    QVector<quint16> m_lengths[3];
+    int m_activeCounts[3];
+    QVector<QHostAddress> m_addresses;
+    QVector<quint16> m_ports;
+#ifdef Q_OS_LINUX
+    QVector<sockaddr_in> m_destinations;
+#endif
+
+    // Rollen der drei Puffer; werden nur unter dem Mutex des Senders getauscht
+    int m_write;
+    int m_ready;
+    int m_sending;
+    bool m_pending;
+};
+
+/**
+ * @brief Verschickt die Pakete aller Netzwerkgeräte auf einem eigenen Thread
+ *
+ * Übergaben aus dem Hauptthread werden gesammelt und in einem Durchlauf gesendet,
+ * unter Linux gebündelt mit sendmmsg (ein Systemaufruf für bis zu BatchSize Pakete),
+ * auf anderen Plattformen paketweise über QUdpSocket.
+ */
+class NetworkOutputSender : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Maximale Anzahl an Paketen pro sendmmsg-Aufruf
+     */
+    static const int BatchSize = 512;
+    
+    /**
+     * @brief Konstruktor
+     * @param parent Parent-Objekt
+     */
+    explicit NetworkOutputSender(QObject *parent = nullptr);
+    
+    /**
+     * @brief Destruktor
+     */
+    ~NetworkOutputSender();
+    
+    /**
+     * @brief Legt einen Paketstrom an
+     * @param packetCount Anzahl der Pakete pro Frame
+     * @param packetCapacity Maximale Größe eines Pakets in Byte
+     * @return Paketstrom (gehört dem Sender)
+     */
+    NetworkOutputStream *createStream(int packetCount, int packetCapacity);
+    
+    /**
+     * @brief Entfernt einen Paketstrom; wartet, falls er gerade gesendet wird
+     * @param stream Paketstrom
+     */
+    void removeStream(NetworkOutputStream *stream);
+    
+    /**
+     * @brief Übergibt den Schreibpuffer eines Stroms zum Senden
+     * @param stream Paketstrom
+     */
+    void submit(NetworkOutputStream *stream);
+    
+    /**
+     * @brief Prüft, ob ein übergebener Frame noch auf das Senden wartet
+     *
+     * Ein solcher Frame würde von der nächsten Übergabe ersetzt. Teilaktualisierungen
+     * dürfen ihn daher nicht ersetzen, sonst gingen seine Änderungen verloren.
+     * @param stream Paketstrom
+     * @return true wenn noch ein Frame bereitliegt
+     */
+    bool isPending(NetworkOutputStream *stream) const;
+    
+    /**
+     * @brief Gibt die Anzahl der gesendeten Pakete zurück
+     * @return Anzahl der Pakete
+     */
+    quint64 getSentPacketCount() const;
+    
+    /**
+     * @brief Gibt die Anzahl der Systemaufrufe zum Senden zurück
+     * @return Anzahl der Aufrufe
+     */
+    quint64 getSendCallCount() const;
+    
+    /**
+     * @brief Gibt die Anzahl der übersprungenen Frames zurück
+     * @return Frames, die vor dem Senden durch einen neueren ersetzt wurden
+     */
+    quint64 getDroppedFrameCount() const;
+    
+    /**
+     * @brief Gibt die Anzahl der Sendefehler zurück
+     * @return Anzahl der Fehler
+     */
+    quint64 getSendErrorCount() const;
+
+private:
+    /**
+     * @brief Sendet alle übergebenen Frames (läuft auf dem Sendethread)
+     */
+    void processPending();
+    
+    /**
+     * @brief Sendet die Pakete eines Stroms aus dessen Sendepuffer
+     * @param stream Paketstrom
+     */
+    void sendStream(NetworkOutputStream *stream);
+
+private:
+    QThread m_sendThread;
+    QObject *m_sendContext;
+    mutable QMutex m_mutex;
+    QMutex m_sendMutex;
+    QList<NetworkOutputStream*> m_streams;
+    QList<NetworkOutputStream*> m_pending;
+    QList<NetworkOutputStream*> m_processing;
+    bool m_processScheduled;
+
+#ifdef Q_OS_LINUX
+    int m_socket;
+    mmsghdr m_messages[BatchSize];
+    iovec m_vectors[BatchSize];
+#else
+    QUdpSocket *m_udpSocket;
+#endif
+
+    std::atomic<quint64> m_sentPackets;
+    std::atomic<quint64> m_sendCalls;
+    std::atomic<quint64> m_droppedFrames;
+    std::atomic<quint64> m_sendErrors;
+};
@@ -0,0 +1,128 @@
+#pragma once
+
+#include "devices/irgbdevice.h"
+#include "devices/networkoutputsender.h"
+#include <QObject>
+#include <QColor>
+#include <QHostAddress>
+#include <QVector>
+
+/**
+ * @brief LED-Streifen oder -Matrix, die über das Netzwerk angesteuert wird
+ *
+ * Der LED-Puffer des Geräts wird je nach Protokoll auf E1.31-(sACN-)Universen,
+ * Art-Net-Universen oder DDP-Pakete aufgeteilt. Die Paketköpfe werden einmalig beim
+ * Anlegen aufgebaut; pro Frame werden nur Farbwerte und Sequenznummern geschrieben
+ * und der Frame an den NetworkOutputSender übergeben.
+ */
+class NetworkRGBDevice : public QObject, public IRGBDevice
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Unterstützte Netzwerkprotokolle
+     */
+    enum Protocol {
+        E131,
+        ArtNet,
+        Ddp
+    };
+    
+    /**
+     * @brief Konfiguration eines Netzwerkgeräts
+     */
+    struct Config {
+        QString id;
+        QString name;
+        Protocol protocol = E131;
+        QString host;                   // Leer: Multicast (E1.31) bzw. Broadcast (Art-Net)
+        quint16 port = 0;               // 0: Standardport des Protokolls
+        int ledCount = 0;
+        int startUniverse = -1;         // -1: 1 für E1.31, 0 für Art-Net
+        int channelsPerUniverse = 510;  // Vielfaches von 3, höchstens 512
+        int priority = 100;             // Nur E1.31
+        int maxFrameRate = 0;           // 0: unbegrenzt
+        int latencyUs = 0;              // Vom Empfänger bis zur Anzeige
+    };
+    
+    /**
+     * @brief Ermittelt das Protokoll zu einem Namen aus der Konfiguration
+     * @param name Name ("e131", "sacn", "artnet" oder "ddp")
+     * @param protocol Wird mit dem Protokoll gefüllt
+     * @return true wenn der Name bekannt ist, false wenn nicht
+     */
+    static bool protocolFromName(const QString &name, Protocol &protocol);
+    
+    /**
+     * @brief Gibt den Standardport eines Protokolls zurück
+     * @param protocol Protokoll
+     * @return UDP-Port
+     */
+    static quint16 defaultPort(Protocol protocol);
+    
+    /**
+     * @brief Konstruktor
+     * @param config Konfiguration (muss gültig sein)
+     * @param sender Sender, über den die Pakete verschickt werden
+     * @param parent Parent-Objekt
+     */
+    NetworkRGBDevice(const Config &config, NetworkOutputSender *sender, QObject *parent = nullptr);
+    
+    /**
+     * @brief Destruktor
+     */
+    ~NetworkRGBDevice();
+    
+    // IRGBDevice-Interface-Implementierung
+    QString getId() const override;
+    QString getDisplayName() const override;
+    QString getType() const override;
+    bool setColor(const QColor &color) override;
+    int getLedCount() const override;
+    bool setLedColors(const QVector<QRgb> &colors) override;
+    int getSupportedEncodings() const override;
+    bool setLedUpdate(const LedFrameUpdate &update) override;
+    int getMaxFrameRate() const override;
+    int getOutputLatencyUs() const override;
+    QColor getColor() const override;
+    bool setEffect(const QString &effectName, const QVariantMap &parameters = QVariantMap()) override;
+    QString getActiveEffect() const override;
+    QVariantMap getEffectParameters() const override;
+    bool isConnected() const override;
+    
+    /**
+     * @brief Gibt die Anzahl der Pakete pro Frame zurück
+     * @return Anzahl der Universen bzw. DDP-Pakete
+     */
+    int getPacketCount() const;
+
+private:
+    /**
+     * @brief Erhöht die Sequenznummer für den nächsten Frame
+     */
+    void advanceSequence();
+    
+    /**
+     * @brief Baut die Köpfe aller Pakete im Schreibpuffer auf
+     */
+    void buildPacketHeaders();
+    
+    /**
+     * @brief Gibt die Zieladresse eines Universums zurück
+     * @param universe Universum
+     * @return Zieladresse
+     */
+    QHostAddress destinationFor(int universe) const;
+
+private:
+    Config m_config;
+    NetworkOutputSender *m_sender;
+    NetworkOutputStream *m_stream;
+    QHostAddress m_address;
+    int m_ledsPerPacket;
+    int m_dataOffset;
+    quint8 m_sequence;
+    QColor m_currentColor;
+    QVector<QRgb> m_frame;
+};
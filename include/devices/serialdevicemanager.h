@@ -0,0 +1,90 @@
+#pragma once
+
+#include "devices/serialrgbdevice.h"
+#include <QObject>
+#include <QList>
+#include <QStringList>
+
+/**
+ * @brief Manager für serielle LED-Geräte (Adalight)
+ *
+ * Liest die Geräte aus einer JSON-Konfiguration:
+ * @code
+ * { "devices": [ { "id": "ambilight", "name": "Ambilight", "port": "/dev/ttyUSB0",
+ *                  "baudRate": 500000, "ledCount": 120 } ] }
+ * @endcode
+ * Optional begrenzt "maxFps" die Bildrate unter die der Leitung.
+ */
+class SerialDeviceManager : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Standardpfad der Konfiguration (relativ zum Arbeitsverzeichnis)
+     */
+    static const char *DefaultConfigPath;
+    
+    /**
+     * @brief Konstruktor
+     * @param parent Parent-QObject
+     */
+    explicit SerialDeviceManager(QObject *parent = nullptr);
+    
+    /**
+     * @brief Destruktor
+     */
+    ~SerialDeviceManager();
+    
+    /**
+     * @brief Initialisiert den Manager und öffnet die konfigurierten Schnittstellen
+     *
+     * Eine fehlende Konfigurationsdatei ist kein Fehler, es gibt dann keine Geräte.
+     * Geräte, deren Schnittstelle sich nicht öffnen lässt, bleiben als getrennt erhalten.
+     * @param configPath Pfad der Konfigurationsdatei
+     * @return true wenn erfolgreich, false wenn die Konfiguration ungültig ist
+     */
+    bool initialize(const QString &configPath = DefaultConfigPath);
+    
+    /**
+     * @brief Gibt eine Liste aller seriellen Geräte zurück
+     * @return Liste von SerialRGBDevice-Objekten
+     */
+    QList<SerialRGBDevice*> getDevices() const;
+    
+    /**
+     * @brief Liest die Konfiguration erneut und meldet nur die Änderungen
+     *
+     * Getrennte Geräte versuchen dabei erneut, ihre Schnittstelle zu öffnen.
+     * Entfernte Geräte werden per deleteLater() freigegeben.
+     * @param addedDevices Wird mit den neu konfigurierten Geräten gefüllt
+     * @param removedDeviceIds Wird mit den IDs der entfernten Geräte gefüllt
+     * @return true wenn erfolgreich, false wenn fehlgeschlagen
+     */
+    bool rescanDevices(QList<SerialRGBDevice*> &addedDevices, QStringList &removedDeviceIds);
+
+private:
+    /**
+     * @brief Liest die Gerätekonfiguration
+     * @param configs Wird mit den gültigen Gerätekonfigurationen gefüllt
+     * @return true wenn die Datei fehlt oder gültig ist, false bei ungültigem JSON
+     */
+    bool readConfig(QList<SerialRGBDevice::Config> &configs) const;
+    
+    /**
+     * @brief Legt ein Gerät an und öffnet seine Schnittstelle
+     * @param config Konfiguration
+     * @return Neues Gerät
+     */
+    SerialRGBDevice *createDevice(const SerialRGBDevice::Config &config);
+    
+    /**
+     * @brief Entfernt alle Geräte
+     */
+    void clearDevices();
+
+private:
+    bool m_initialized;
+    QString m_configPath;
+    QList<SerialRGBDevice*> m_devices;
+};
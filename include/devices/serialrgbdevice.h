@@ -0,0 +1,134 @@
+#pragma once
+
+#include "devices/irgbdevice.h"
+#include <QObject>
+#include <QColor>
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QVector>
+
+class QSocketNotifier;
+class QTimer;
+
+/**
+ * @brief LED-Streifen an einer seriellen Schnittstelle (Adalight-Protokoll)
+ *
+ * Jeder Frame besteht aus dem Kopf "Ada", der LED-Anzahl minus eins (Big Endian),
+ * einer Prüfsumme und den RGB-Werten. Geschrieben wird nicht blockierend: Pro
+ * Schnittstelle ist höchstens ein Frame unterwegs, ein weiterer wartet. Kommt ein
+ * neuer Frame, bevor der wartende geschrieben wurde, ersetzt er ihn.
+ *
+ * Frames werden nach der Baudrate getaktet: Ein neuer Frame beginnt frühestens, wenn
+ * die Leitung den vorherigen übertragen haben kann. So wächst die Warteschlange im
+ * Treiber nicht an und die Latenz bleibt bei höchstens einem Frame.
+ */
+class SerialRGBDevice : public QObject, public IRGBDevice
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Konfiguration eines seriellen Geräts
+     */
+    struct Config {
+        QString id;
+        QString name;
+        QString portName;       // z.B. /dev/ttyUSB0 oder eine Pty-Gegenseite
+        int baudRate = 115200;
+        int ledCount = 0;
+        int maxFrameRate = 0;   // 0: so schnell, wie die Leitung erlaubt
+    };
+    
+    /**
+     * @brief Konstruktor
+     * @param config Konfiguration
+     * @param parent Parent-Objekt
+     */
+    explicit SerialRGBDevice(const Config &config, QObject *parent = nullptr);
+    
+    /**
+     * @brief Destruktor
+     */
+    ~SerialRGBDevice();
+    
+    /**
+     * @brief Öffnet die Schnittstelle und stellt sie auf Rohdaten und Baudrate ein
+     * @return true wenn erfolgreich, false wenn fehlgeschlagen
+     */
+    bool open();
+    
+    /**
+     * @brief Schließt die Schnittstelle
+     */
+    void close();
+    
+    // IRGBDevice-Interface-Implementierung
+    QString getId() const override;
+    QString getDisplayName() const override;
+    QString getType() const override;
+    bool setColor(const QColor &color) override;
+    int getLedCount() const override;
+    bool setLedColors(const QVector<QRgb> &colors) override;
+    int getMaxFrameRate() const override;
+    int getOutputLatencyUs() const override;
+    QColor getColor() const override;
+    bool setEffect(const QString &effectName, const QVariantMap &parameters = QVariantMap()) override;
+    QString getActiveEffect() const override;
+    QVariantMap getEffectParameters() const override;
+    bool isConnected() const override;
+    
+    /**
+     * @brief Gibt die Übertragungsdauer eines Frames zurück
+     * @return Dauer in Mikrosekunden (10 Bit pro Byte bei 8N1)
+     */
+    qint64 getFrameDurationUs() const;
+    
+    /**
+     * @brief Gibt die Anzahl der vollständig geschriebenen Frames zurück
+     * @return Anzahl der Frames
+     */
+    quint64 getWrittenFrameCount() const;
+    
+    /**
+     * @brief Gibt die Anzahl der ersetzten, nie geschriebenen Frames zurück
+     * @return Anzahl der Frames
+     */
+    quint64 getReplacedFrameCount() const;
+
+private slots:
+    /**
+     * @brief Schreibt weiter, sobald die Schnittstelle wieder Daten annimmt
+     */
+    void onWritable();
+    
+    /**
+     * @brief Startet den wartenden Frame sofort oder plant ihn nach der Taktung ein
+     */
+    void startPendingFrame();
+
+private:
+    /**
+     * @brief Schreibt so viel vom laufenden Frame wie möglich
+     */
+    void writeInFlight();
+
+private:
+    Config m_config;
+    int m_fd;
+    QSocketNotifier *m_writeNotifier;
+    QTimer *m_pacingTimer;
+    QElapsedTimer m_clock;
+    
+    QByteArray m_inFlight;      // Frame, der gerade geschrieben wird
+    int m_inFlightOffset;       // Bereits geschriebene Bytes von m_inFlight
+    bool m_writing;
+    QByteArray m_pending;       // Neuester noch nicht begonnener Frame
+    bool m_hasPending;
+    qint64 m_nextFrameStartUs;  // Frühester Start des nächsten Frames
+    qint64 m_frameDurationUs;
+    
+    QColor m_currentColor;
+    QVector<QRgb> m_frame;
+    quint64 m_writtenFrames;
+    quint64 m_replacedFrames;
+};
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <QtGlobal>
+
+/**
+ * @brief Binäres Protokoll der lokalen Steuerschnittstelle
+ *
+ * Nachrichten bestehen aus einem Kopf von 8 Byte und den Nutzdaten. Alle Zahlen sind
+ * Little Endian, Zeichenketten werden als u16-Länge plus UTF-8 übertragen.
+ *
+ *     u16 magic (0x4C43, "LC") | u8 command | u8 reserved | u32 payloadLength | payload
+ *
+ * Client an Dienst:
+ * - SetColor:      str deviceId (leer = alle Geräte), u8 r, u8 g, u8 b
+ * - SetEffect:     str deviceId (leer = alle Geräte), str effect, u16 count,
+ *                  count x (str key, u8 ValueType, Wert)
+ * - LoadProfile:   str name
+ * - Subscribe:     u32 Maske aus Subscription
+ * - ListDevices:   keine Nutzdaten
+ * - GetStateInfo:  keine Nutzdaten
+ *
+ * Dienst an Client:
+ * - Result:        u8 command, u8 status (0 = Erfolg), str message
+ * - DeviceList:    u16 count, count x (str id, str name, u32 ledCount)
+ * - StateInfo:     str sharedMemoryKey, u32 size, u16 layoutVersion
+ * - SensorEvent:   i16 cpuTemperature, i16 cpuUsage, i16 gpuTemperature, i16 gpuUsage
+ * - DeviceEvent:   u8 added (1) / removed (0), str deviceId
+ *
+ * Frames und Sensorwerte werden nicht über den Socket übertragen, sondern im
+ * Shared Memory veröffentlicht (siehe SharedState).
+ */
+namespace ControlProtocol {
+
+/**
+ * @brief Kennung am Anfang jeder Nachricht ("LC")
+ */
+const quint16 Magic = 0x4C43;
+
+/**
+ * @brief Größe des Nachrichtenkopfs in Byte
+ */
+const int HeaderSize = 8;
+
+/**
+ * @brief Maximale Größe der Nutzdaten; größere Nachrichten trennen die Verbindung
+ */
+const quint32 MaxPayloadSize = 64 * 1024;
+
+/**
+ * @brief Standardname des lokalen Sockets
+ */
+const char DefaultServerName[] = "lumincontrol";
+
+/**
+ * @brief Befehle und Antworten
+ */
+enum Command : quint8 {
+    SetColor = 0x01,
+    SetEffect = 0x02,
+    LoadProfile = 0x03,
+    Subscribe = 0x04,
+    ListDevices = 0x05,
+    GetStateInfo = 0x06,
+    
+    Result = 0x81,
+    DeviceList = 0x82,
+    StateInfo = 0x83,
+    SensorEvent = 0x90,
+    DeviceEvent = 0x91
+};
+
+/**
+ * @brief Typkennung der Effektparameter in SetEffect
+ */
+enum ValueType : quint8 {
+    Int32 = 0,      ///< i32
+    Double = 1,     ///< f64
+    Bool = 2,       ///< u8
+    String = 3      ///< str
+};
+
+/**
+ * @brief Abonnierbare Ereignisse
+ */
+enum Subscription : quint32 {
+    SensorEvents = 0x01,
+    DeviceEvents = 0x02
+};
+
+} // namespace ControlProtocol
@@ -0,0 +1,159 @@
+#pragma once
+
+#include "engine/controlprotocol.h"
+#include "core/devicemanager.h"
+#include "core/rgbcontroller.h"
+#include "core/profilemanager.h"
+#include "monitoring/sensormonitor.h"
+#include <QObject>
+#include <QLocalServer>
+#include <QLocalSocket>
+#include <QByteArray>
+#include <QHash>
+
+class SharedState;
+
+/**
+ * @brief Lokale Steuerschnittstelle über einen Unix-Domain-Socket (unter Windows Named Pipe)
+ *
+ * Nimmt Befehle im binären ControlProtocol entgegen (Farben, Effekte, Profile) und
+ * verschickt abonnierte Ereignisse. Laufende Frames und Sensorwerte liest ein Client
+ * aus dem Shared Memory, dessen Schlüssel er über GetStateInfo erfährt.
+ */
+class ControlServer : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Konstruktor
+     * @param deviceManager Geräteverwaltung (für Geräteereignisse)
+     * @param rgbController RGB-Controller
+     * @param profileManager Profilverwaltung
+     * @param sensorMonitor Sensorüberwachung
+     * @param sharedState Shared-Memory-Zustand (darf nullptr sein)
+     * @param parent Parent-Objekt
+     */
+    ControlServer(DeviceManager *deviceManager, RGBController *rgbController, ProfileManager *profileManager,
+                  SensorMonitor *sensorMonitor, SharedState *sharedState, QObject *parent = nullptr);
+    
+    /**
+     * @brief Destruktor
+     */
+    ~ControlServer();
+    
+    /**
+     * @brief Startet den Server
+     *
+     * Ein verwaister Socket eines abgestürzten Dienstes wird vorher entfernt. Der Socket
+     * ist nur für den eigenen Benutzer zugänglich.
+     * @param name Name des Sockets
+     * @return true wenn erfolgreich, false wenn fehlgeschlagen
+     */
+    bool listen(const QString &name = QLatin1String(ControlProtocol::DefaultServerName));
+    
+    /**
+     * @brief Gibt die Anzahl der verbundenen Clients zurück
+     * @return Anzahl der Clients
+     */
+    int getClientCount() const;
+    
+    /**
+     * @brief Prüft, ob ein Client Ereignisse einer Art abonniert hat
+     * @param subscription Abonnement
+     * @return true wenn mindestens ein Client es abonniert hat
+     */
+    bool hasSubscribers(ControlProtocol::Subscription subscription) const;
+
+signals:
+    /**
+     * @brief Signal, das ausgelöst wird, wenn sich Abonnements ändern oder ein Client geht
+     */
+    void subscriptionsChanged();
+
+private slots:
+    /**
+     * @brief Nimmt neue Verbindungen an
+     */
+    void onNewConnection();
+    
+    /**
+     * @brief Liest eingegangene Daten eines Clients und verarbeitet vollständige Nachrichten
+     */
+    void onReadyRead();
+    
+    /**
+     * @brief Entfernt einen getrennten Client
+     */
+    void onDisconnected();
+    
+    /**
+     * @brief Verschickt die aktuellen Sensorwerte an Abonnenten
+     */
+    void onSensorsUpdated();
+    
+    /**
+     * @brief Meldet ein neues Gerät an Abonnenten
+     * @param device Gerät
+     */
+    void onDeviceDiscovered(IRGBDevice *device);
+    
+    /**
+     * @brief Meldet ein entferntes Gerät an Abonnenten
+     * @param device Gerät
+     */
+    void onDeviceRemoved(IRGBDevice *device);
+
+private:
+    /**
+     * @brief Zustand einer Verbindung
+     */
+    struct Client {
+        QByteArray buffer;      // Noch nicht verarbeitete Eingangsdaten
+        quint32 subscriptions;  // Maske aus ControlProtocol::Subscription
+    };
+    
+    /**
+     * @brief Verarbeitet eine vollständige Nachricht
+     * @param socket Verbindung
+     * @param client Zustand der Verbindung
+     * @param command Befehl
+     * @param payload Nutzdaten
+     * @return false, wenn die Nachricht fehlerhaft war
+     */
+    bool handleMessage(QLocalSocket *socket, Client *client, quint8 command, const QByteArray &payload);
+    
+    /**
+     * @brief Schickt eine Nachricht an einen Client
+     * @param socket Verbindung
+     * @param command Befehl
+     * @param payload Nutzdaten
+     */
+    void send(QLocalSocket *socket, quint8 command, const QByteArray &payload);
+    
+    /**
+     * @brief Schickt eine Nachricht an alle Clients mit passendem Abonnement
+     * @param subscription Abonnement
+     * @param command Befehl
+     * @param payload Nutzdaten
+     */
+    void broadcast(quint32 subscription, quint8 command, const QByteArray &payload);
+    
+    /**
+     * @brief Schickt die Antwort auf einen Befehl
+     * @param socket Verbindung
+     * @param command Beantworteter Befehl
+     * @param success Ergebnis
+     * @param message Meldung
+     */
+    void sendResult(QLocalSocket *socket, quint8 command, bool success, const QString &message = QString());
+
+private:
+    QLocalServer *m_server;
+    DeviceManager *m_deviceManager;
+    RGBController *m_rgbController;
+    ProfileManager *m_profileManager;
+    SensorMonitor *m_sensorMonitor;
+    SharedState *m_sharedState;
+    QHash<QLocalSocket*, Client> m_clients;
+};
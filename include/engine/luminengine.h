@@ -0,0 +1,181 @@
+#pragma once
+
+#include "core/devicemanager.h"
+#include "core/rgbcontroller.h"
+#include "core/profilemanager.h"
+#include "monitoring/sensormonitor.h"
+#include "engine/controlprotocol.h"
+#include <QObject>
+#include <QString>
+#include <QEvent>
+
+class ControlServer;
+class SharedState;
+class OpenRGBServer;
+
+/**
+ * @brief Kern der Anwendung ohne Benutzeroberfläche
+ *
+ * Besitzt Geräteverwaltung, RGB-Controller, Sensorüberwachung und Profilverwaltung und
+ * verbindet sie miteinander. Die Engine benötigt nur QtCore und QtGui-Datentypen (QColor),
+ * aber weder Widgets noch Charts oder eine Anzeige. Sie läuft damit sowohl im Dienst
+ * (LuminControlDaemon) als auch unter dem Hauptfenster, das nur noch ein Client ist.
+ *
+ * Sind alle Ausgaben statisch und hat kein Client Sensorereignisse abonniert, parkt die
+ * Engine die Sensorüberwachung; bis sich eine Eingabe ändert, läuft dann kein Timer mehr.
+ * Die Sensorwerte im Shared Memory bleiben währenddessen auf dem letzten Stand.
+ */
+class LuminEngine : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Konstruktor
+     * @param parent Parent-Objekt
+     */
+    explicit LuminEngine(QObject *parent = nullptr);
+    
+    /**
+     * @brief Destruktor
+     */
+    ~LuminEngine();
+    
+    /**
+     * @brief Lädt die Plugins und startet die Sensorüberwachung
+     *
+     * Sobald alle Plugins geladen sind, wird das Startprofil angewendet.
+     * @param startupProfile Name des Startprofils, leer für das Standardprofil
+     */
+    void start(const QString &startupProfile = QString());
+    
+    /**
+     * @brief Beendet die Sensorüberwachung
+     */
+    void stop();
+    
+    /**
+     * @brief Legt fest, ob Sensortemperaturen an den RGB-Controller weitergereicht werden
+     * @param enabled true, wenn die Engine die Temperaturen selbst liefern soll
+     */
+    void setSensorTemperaturesEnabled(bool enabled);
+    
+    /**
+     * @brief Legt fest, ob die Engine ihre Timer parkt, solange nichts animiert
+     * @param enabled true zum Parken (Standard), false wenn z.B. eine Oberfläche die Sensoren anzeigt
+     */
+    void setIdleParkingEnabled(bool enabled);
+    
+    /**
+     * @brief Prüft, ob die Timer gerade geparkt sind
+     * @return true wenn geparkt
+     */
+    bool isParked() const;
+    
+    /**
+     * @brief Gibt die Anzahl der Timer-Weckrufe im Hauptthread zurück
+     * @return Anzahl seit dem Start
+     */
+    quint64 getWakeupCount() const;
+    
+    /**
+     * @brief Gibt die Anzahl der Timer-Weckrufe zurück, die während des Parkens auftraten
+     * @return Anzahl seit dem Start, im Idealfall 0
+     */
+    quint64 getParkedWakeupCount() const;
+    
+    /**
+     * @brief Startet die lokale Steuerschnittstelle und den Shared-Memory-Zustand
+     *
+     * Der Shared-Memory-Bereich erhält den Namen des Sockets als Schlüssel.
+     * @param serverName Name des Sockets
+     * @return true wenn erfolgreich, false wenn fehlgeschlagen
+     */
+    bool startControlInterface(const QString &serverName = QLatin1String(ControlProtocol::DefaultServerName));
+    
+    /**
+     * @brief Startet den OpenRGB-SDK-Server auf localhost
+     * @param port TCP-Port (Standard 6742)
+     * @return true wenn erfolgreich, false wenn fehlgeschlagen
+     */
+    bool startOpenRGBServer(quint16 port = 6742);
+    
+    /**
+     * @brief Gibt die Geräteverwaltung zurück
+     * @return Geräteverwaltung
+     */
+    DeviceManager* getDeviceManager() const;
+    
+    /**
+     * @brief Gibt den RGB-Controller zurück
+     * @return RGB-Controller
+     */
+    RGBController* getRGBController() const;
+    
+    /**
+     * @brief Gibt die Sensorüberwachung zurück
+     * @return Sensorüberwachung
+     */
+    SensorMonitor* getSensorMonitor() const;
+    
+    /**
+     * @brief Gibt die Profilverwaltung zurück
+     * @return Profilverwaltung
+     */
+    ProfileManager* getProfileManager() const;
+
+signals:
+    /**
+     * @brief Signal, das ausgelöst wird, wenn die Plugins geladen und das Startprofil angewendet wurde
+     */
+    void started();
+    
+    /**
+     * @brief Signal, das ausgelöst wird, wenn die Engine ihre Timer parkt oder wieder startet
+     * @param parked true wenn geparkt
+     */
+    void parkedChanged(bool parked);
+
+protected:
+    /**
+     * @brief Zählt die Timer-Ereignisse der Anwendung als Weckrufe
+     * @param watched Empfänger des Ereignisses
+     * @param event Ereignis
+     * @return Immer false, das Ereignis wird normal zugestellt
+     */
+    bool eventFilter(QObject *watched, QEvent *event) override;
+
+private slots:
+    /**
+     * @brief Wendet nach dem Laden der Plugins das Startprofil an
+     * @param loadedPlugins Anzahl der geladenen Plugins
+     */
+    void onPluginLoadingFinished(int loadedPlugins);
+    
+    /**
+     * @brief Reicht die aktuellen Sensortemperaturen an den RGB-Controller weiter
+     */
+    void onSensorsUpdated();
+    
+    /**
+     * @brief Parkt die Sensorüberwachung oder startet sie wieder, je nach Bedarf
+     */
+    void updateParking();
+
+private:
+    DeviceManager *m_deviceManager;
+    RGBController *m_rgbController;
+    SensorMonitor *m_sensorMonitor;
+    ProfileManager *m_profileManager;
+    SharedState *m_sharedState;
+    ControlServer *m_controlServer;
+    OpenRGBServer *m_openRGBServer;
+    QString m_startupProfile;
+    bool m_startupPending;
+    bool m_sensorTemperatures;
+    bool m_idleParking;
+    bool m_running;
+    bool m_parked;
+    quint64 m_wakeups;
+    quint64 m_parkedWakeups;
+};
@@ -0,0 +1,181 @@
+#pragma once
+
+#include "core/devicemanager.h"
+#include "core/rgbcontroller.h"
+#include <QObject>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QByteArray>
+#include <QHash>
+#include <QList>
+#include <QVector>
+#include <QRgb>
+
+/**
+ * @brief Server für das OpenRGB-SDK-Protokoll auf localhost
+ *
+ * Stellt die Geräte des RGB-Controllers als OpenRGB-Controller bereit, sodass vorhandene
+ * SDK-Clients sie ansteuern können. Jedes Gerät erscheint mit einem Modus "Direct" und
+ * einer linearen Zone über alle LEDs.
+ *
+ * UpdateLEDs-Pakete werden direkt in einen Frame-Puffer je Gerät dekodiert. Ausgegeben
+ * wird gesammelt einmal pro Durchlauf der Ereignisschleife; kommen mehrere Frames für
+ * ein Gerät an (auch von verschiedenen Clients), gilt der neueste.
+ */
+class OpenRGBServer : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Standardport des OpenRGB-SDK-Servers
+     */
+    static const quint16 DefaultPort = 6742;
+    
+    /**
+     * @brief Höchste unterstützte Protokollversion
+     */
+    static const quint32 ProtocolVersion = 3;
+    
+    /**
+     * @brief Konstruktor
+     * @param deviceManager Geräteverwaltung (für Änderungen der Geräteliste)
+     * @param rgbController RGB-Controller
+     * @param parent Parent-Objekt
+     */
+    OpenRGBServer(DeviceManager *deviceManager, RGBController *rgbController, QObject *parent = nullptr);
+    
+    /**
+     * @brief Destruktor
+     */
+    ~OpenRGBServer();
+    
+    /**
+     * @brief Startet den Server auf localhost
+     * @param port TCP-Port
+     * @return true wenn erfolgreich, false wenn fehlgeschlagen
+     */
+    bool listen(quint16 port = DefaultPort);
+    
+    /**
+     * @brief Gibt den Port zurück, auf dem der Server lauscht
+     * @return TCP-Port (bei listen(0) der vom System gewählte), 0 wenn nicht gestartet
+     */
+    quint16 getPort() const;
+    
+    /**
+     * @brief Gibt die Anzahl der verbundenen Clients zurück
+     * @return Anzahl der Clients
+     */
+    int getClientCount() const;
+    
+    /**
+     * @brief Gibt die Anzahl der empfangenen LED-Updates zurück
+     * @return Anzahl der UpdateLEDs-, UpdateZoneLEDs- und UpdateSingleLED-Pakete
+     */
+    quint64 getReceivedUpdateCount() const;
+    
+    /**
+     * @brief Gibt die Anzahl der an Geräte ausgegebenen Frames zurück
+     *
+     * Die Differenz zu getReceivedUpdateCount() sind zusammengefasste Updates.
+     * @return Anzahl der Frames
+     */
+    quint64 getAppliedFrameCount() const;
+
+private slots:
+    /**
+     * @brief Nimmt neue Verbindungen an
+     */
+    void onNewConnection();
+    
+    /**
+     * @brief Verarbeitet alle vollständigen Pakete eines Clients
+     */
+    void onReadyRead();
+    
+    /**
+     * @brief Entfernt einen getrennten Client
+     */
+    void onDisconnected();
+    
+    /**
+     * @brief Meldet allen Clients eine geänderte Geräteliste
+     */
+    void onDeviceListChanged();
+    
+    /**
+     * @brief Gibt alle geänderten Frames an die Geräte aus
+     */
+    void flushFrames();
+
+private:
+    /**
+     * @brief Zustand einer Verbindung
+     */
+    struct Client {
+        QByteArray buffer;          // Noch nicht verarbeitete Eingangsdaten
+        quint32 protocolVersion;    // Ausgehandelte Protokollversion
+        QString name;               // Über SetClientName gemeldeter Name
+    };
+    
+    /**
+     * @brief Ausgabepuffer eines Geräts
+     */
+    struct DeviceFrame {
+        QVector<QRgb> colors;
+        bool dirty;
+    };
+    
+    /**
+     * @brief Verarbeitet ein vollständiges Paket
+     * @param socket Verbindung
+     * @param client Zustand der Verbindung
+     * @param deviceIndex Geräteindex aus dem Paketkopf
+     * @param packetId Pakettyp
+     * @param data Nutzdaten
+     * @param size Größe der Nutzdaten
+     */
+    void handlePacket(QTcpSocket *socket, Client *client, quint32 deviceIndex, quint32 packetId,
+                      const char *data, quint32 size);
+    
+    /**
+     * @brief Schickt ein Paket an einen Client
+     * @param socket Verbindung
+     * @param deviceIndex Geräteindex
+     * @param packetId Pakettyp
+     * @param payload Nutzdaten
+     */
+    void send(QTcpSocket *socket, quint32 deviceIndex, quint32 packetId, const QByteArray &payload);
+    
+    /**
+     * @brief Erzeugt die Controller-Beschreibung eines Geräts
+     * @param device Gerät
+     * @param protocolVersion Protokollversion des Clients
+     * @return Controller-Daten im OpenRGB-Format
+     */
+    QByteArray controllerData(IRGBDevice *device, quint32 protocolVersion);
+    
+    /**
+     * @brief Gibt den Ausgabepuffer eines Geräts zurück und legt ihn bei Bedarf an
+     * @param device Gerät
+     * @return Ausgabepuffer mit einer Farbe pro LED
+     */
+    DeviceFrame &frameFor(IRGBDevice *device);
+    
+    /**
+     * @brief Plant die gesammelte Ausgabe für den nächsten Durchlauf der Ereignisschleife ein
+     */
+    void scheduleFlush();
+
+private:
+    QTcpServer *m_server;
+    DeviceManager *m_deviceManager;
+    RGBController *m_rgbController;
+    QHash<QTcpSocket*, Client> m_clients;
+    QHash<IRGBDevice*, DeviceFrame> m_frames;
+    QList<IRGBDevice*> m_devices;
+    bool m_flushScheduled;
+    quint64 m_receivedUpdates;
+    quint64 m_appliedFrames;
+};
@@ -0,0 +1,149 @@
+#pragma once
+
+#include "core/rgbcontroller.h"
+#include "monitoring/sensormonitor.h"
+#include <QObject>
+#include <QSharedMemory>
+#include <QHash>
+#include <QString>
+#include <QRgb>
+#include <atomic>
+
+/**
+ * @brief Veröffentlicht Gerätframes und Sensorwerte in einem Shared-Memory-Bereich
+ *
+ * Clients (Oberfläche, Monitoring) hängen sich an den Bereich an und lesen den Zustand
+ * direkt, ohne Nachrichten zu serialisieren. Geschrieben wird nur vom Dienst; die
+ * Konsistenz sichert ein Sequenzzähler (Seqlock) statt einer Sperre:
+ *
+ * - Schreiben: Zähler auf ungerade setzen, Daten schreiben, Zähler auf gerade setzen.
+ * - Lesen: Zähler lesen (bei ungerade erneut versuchen), Daten kopieren, Zähler erneut
+ *   lesen und bei Abweichung wiederholen.
+ *
+ * Aufbau: Header, danach maxDevices x DeviceSlot, danach die Frames (eine QRgb pro LED,
+ * Versatz je Gerät in DeviceSlot::frameOffset ab Beginn des Bereichs).
+ */
+class SharedState : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Version des Speicheraufbaus
+     */
+    static const quint16 LayoutVersion = 1;
+    
+    /**
+     * @brief Maximale Anzahl an Geräten im Bereich
+     */
+    static const int MaxDevices = 64;
+    
+    /**
+     * @brief Kopf des Bereichs
+     */
+    struct Header {
+        quint32 magic;                  ///< "LCST"
+        quint16 version;                ///< LayoutVersion
+        quint16 maxDevices;             ///< Anzahl der DeviceSlot-Einträge
+        std::atomic<quint32> sequence;  ///< Seqlock-Zähler, ungerade während des Schreibens
+        quint32 deviceCount;            ///< Belegte DeviceSlot-Einträge
+        quint32 size;                   ///< Gesamtgröße des Bereichs in Byte
+        qint16 cpuTemperature;
+        qint16 cpuUsage;
+        qint16 gpuTemperature;
+        qint16 gpuUsage;
+        qint64 timestamp;               ///< Letzte Änderung, ms seit Epoche
+    };
+    
+    /**
+     * @brief Eintrag eines Geräts
+     */
+    struct DeviceSlot {
+        char id[64];                    ///< Geräte-ID in UTF-8, nullterminiert
+        quint32 ledCount;               ///< Anzahl der LEDs im Frame
+        quint32 frameOffset;            ///< Versatz des Frames ab Beginn des Bereichs
+        quint32 frameCounter;           ///< Anzahl der bisher geschriebenen Frames
+        quint32 reserved;
+    };
+    
+    /**
+     * @brief Konstruktor
+     * @param rgbController RGB-Controller, dessen Ausgaben veröffentlicht werden
+     * @param sensorMonitor Sensorüberwachung
+     * @param parent Parent-Objekt
+     */
+    SharedState(RGBController *rgbController, SensorMonitor *sensorMonitor, QObject *parent = nullptr);
+    
+    /**
+     * @brief Destruktor
+     */
+    ~SharedState();
+    
+    /**
+     * @brief Legt den Bereich an
+     * @param key Schlüssel des Shared Memory
+     * @param size Größe in Byte
+     * @return true wenn erfolgreich, false wenn fehlgeschlagen
+     */
+    bool create(const QString &key, int size = 1024 * 1024);
+    
+    /**
+     * @brief Baut die Geräteeinträge neu auf (nach Hinzufügen oder Entfernen von Geräten)
+     */
+    void rebuildLayout();
+    
+    /**
+     * @brief Gibt den Schlüssel des Bereichs zurück
+     * @return Schlüssel, leer wenn nicht angelegt
+     */
+    QString getKey() const;
+    
+    /**
+     * @brief Gibt die Größe des Bereichs zurück
+     * @return Größe in Byte, 0 wenn nicht angelegt
+     */
+    int getSize() const;
+
+private slots:
+    /**
+     * @brief Schreibt einen ausgegebenen Frame in den Eintrag des Geräts
+     * @param deviceId ID des Geräts
+     * @param frame Farbe pro LED
+     */
+    void onFrameChanged(const QString &deviceId, const QVector<QRgb> &frame);
+    
+    /**
+     * @brief Schreibt die aktuellen Sensorwerte
+     */
+    void onSensorsUpdated();
+
+private:
+    /**
+     * @brief Beginnt einen Schreibvorgang (Zähler wird ungerade)
+     */
+    void beginWrite();
+    
+    /**
+     * @brief Beendet einen Schreibvorgang (Zähler wird gerade)
+     */
+    void endWrite();
+    
+    /**
+     * @brief Gibt den Kopf im angehängten Bereich zurück
+     * @return Kopf
+     */
+    Header* header() const;
+    
+    /**
+     * @brief Gibt einen Geräteeintrag im angehängten Bereich zurück
+     * @param index Index des Eintrags
+     * @return Geräteeintrag
+     */
+    DeviceSlot* deviceSlot(int index) const;
+
+private:
+    RGBController *m_rgbController;
+    SensorMonitor *m_sensorMonitor;
+    QSharedMemory m_memory;
+    QHash<QString, int> m_slotIndex;
+};
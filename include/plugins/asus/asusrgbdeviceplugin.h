@@ -40,7 +40,7 @@ public:
     QString getId() const override;
     QString getDisplayName() const override;
     QString getType() const override;
-    QStringList getSupportedEffects() const;
+    QStringList getSupportedEffects() const override;
     bool setColor(const QColor &color) override;
     bool setEffect(const QString &effectName, const QVariantMap &params = QVariantMap()) override;
     QColor getColor() const override;
@@ -20,9 +20,7 @@
 #include <QDateTime>
 #include <QDebug>
 
-#include "core/devicemanager.h"
-#include "core/rgbcontroller.h"
-#include "core/profilemanager.h"
+#include "engine/luminengine.h"
 #include "devices/irgbdevice.h"
 #include "monitoring/sensormonitor.h"
 
@@ -63,6 +61,8 @@ private slots:
     void onProfileSelectionChanged();
     void onThemeChanged(int index);
     void onDeviceDiscovered(IRGBDevice *device);
+    void onDeviceRemoved(IRGBDevice *device);
+    void onRescanDevicesClicked();
     void onDeviceSelectionChanged(const QItemSelection &selected, const QItemSelection &deselected);
     void onRGBColorChanged(const QString &deviceId, const QColor &color);
     void onRGBEffectChanged(const QString &deviceId, const QString &effectName);
@@ -110,6 +110,7 @@ private:
     QTableView *devicesTableView;
     QStandardItemModel *devicesModel;
     QPushButton *rgbConfigureButton;
+    QPushButton *rescanDevicesButton;
     
     // RGB Control Tab
     QColorDialog *colorPicker;
@@ -158,6 +159,9 @@ private:
     QCheckBox *startWithSystemCheckBox;
     QPushButton *managePluginsButton;
     
+    // Engine (besitzt Geräte, Controller, Sensoren und Profile)
+    LuminEngine *engine;
+    
     // Plugin System
     DeviceManager *deviceManager;
     RGBController *rgbController;
@@ -103,11 +103,15 @@ QColor Color::interpolate(const QColor &color1, const QColor &color2, qreal rati
     if (ratio <= 0.0) return color1;
     if (ratio >= 1.0) return color2;
     
-    int r = qRound(color1.red() * (1.0 - ratio) + color2.red() * ratio);
-    int g = qRound(color1.green() * (1.0 - ratio) + color2.green() * ratio);
-    int b = qRound(color1.blue() * (1.0 - ratio) + color2.blue() * ratio);
+    // Mit 16 Bit pro Kanal interpolieren, damit langsame Übergänge nicht in 8-Bit-Stufen springen
+    QRgba64 from = color1.rgba64();
+    QRgba64 to = color2.rgba64();
     
-    return QColor(r, g, b);
+    quint16 r = quint16(qRound(from.red() * (1.0 - ratio) + to.red() * ratio));
+    quint16 g = quint16(qRound(from.green() * (1.0 - ratio) + to.green() * ratio));
+    quint16 b = quint16(qRound(from.blue() * (1.0 - ratio) + to.blue() * ratio));
+    
+    return QColor::fromRgba64(r, g, b);
 }
 
 QColor Color::fromTemperature(int temperature)
@@ -0,0 +1,133 @@
+#include "core/colorcalibration.h"
+#include <QtMath>
+
+ColorCalibration::ColorCalibration()
+    : m_identity(true)
+{
+    buildTables();
+}
+
+ColorCalibration::ColorCalibration(const Settings &settings)
+    : m_settings(settings)
+    , m_identity(true)
+{
+    buildTables();
+}
+
+const ColorCalibration::Settings &ColorCalibration::settings() const
+{
+    return m_settings;
+}
+
+bool ColorCalibration::isIdentity() const
+{
+    return m_identity;
+}
+
+QRgb ColorCalibration::apply(QRgb color) const
+{
+    return (color & 0xff000000u)
+        | m_table8[0][qRed(color)]
+        | m_table8[1][qGreen(color)]
+        | m_table8[2][qBlue(color)];
+}
+
+QRgba64 ColorCalibration::apply(QRgba64 color) const
+{
+    const quint16 channels[3] = { color.red(), color.green(), color.blue() };
+    quint16 output[3];
+    
+    for (int channel = 0; channel < 3; ++channel) {
+        // Position in der Tabelle (0 - 255) als 8.8-Festkommazahl: Eintrag i gehört zum
+        // 16-Bit-Wert i * 257, 65535 fällt daher genau auf den letzten Eintrag
+        int position = int((quint32(channels[channel]) * 255 * 256 + 32767) / 65535);
+        int index = position >> 8;
+        int fraction = position & 0xff;
+        int low = m_table16[channel][index];
+        int high = m_table16[channel][qMin(index + 1, 255)];
+        output[channel] = quint16(low + ((high - low) * fraction) / 256);
+    }
+    
+    return QRgba64::fromRgba64(output[0], output[1], output[2], color.alpha());
+}
+
+void ColorCalibration::apply(const QVector<QRgb> &frame, QVector<QRgb> &output) const
+{
+    int ledCount = frame.size();
+    output.resize(ledCount);
+    
+    const QRgb *source = frame.constData();
+    QRgb *target = output.data();
+    const quint32 *red = m_table8[0];
+    const quint32 *green = m_table8[1];
+    const quint32 *blue = m_table8[2];
+    
+    // Ein Durchlauf ohne Verzweigungen, die Tabellen liegen zusammen im L1-Cache
+    for (int i = 0; i < ledCount; ++i) {
+        QRgb color = source[i];
+        target[i] = (color & 0xff000000u)
+            | red[(color >> 16) & 0xff]
+            | green[(color >> 8) & 0xff]
+            | blue[color & 0xff];
+    }
+}
+
+const quint16 *ColorCalibration::table16(int channel) const
+{
+    return m_table16[qBound(0, channel, 2)];
+}
+
+QJsonObject ColorCalibration::toJson() const
+{
+    QJsonObject json;
+    json["gamma"] = m_settings.gamma;
+    json["whitePoint"] = m_settings.whitePoint.name();
+    json["redGain"] = m_settings.redGain;
+    json["greenGain"] = m_settings.greenGain;
+    json["blueGain"] = m_settings.blueGain;
+    return json;
+}
+
+ColorCalibration ColorCalibration::fromJson(const QJsonObject &json)
+{
+    Settings settings;
+    settings.gamma = json["gamma"].toDouble(1.0);
+    settings.redGain = json["redGain"].toDouble(1.0);
+    settings.greenGain = json["greenGain"].toDouble(1.0);
+    settings.blueGain = json["blueGain"].toDouble(1.0);
+    
+    QColor whitePoint(json["whitePoint"].toString());
+    if (whitePoint.isValid()) {
+        settings.whitePoint = whitePoint;
+    }
+    
+    return ColorCalibration(settings);
+}
+
+void ColorCalibration::buildTables()
+{
+    double gamma = m_settings.gamma > 0.0 ? m_settings.gamma : 1.0;
+    const double scale[3] = {
+        qBound(0.0, m_settings.redGain, 1.0) * m_settings.whitePoint.redF(),
+        qBound(0.0, m_settings.greenGain, 1.0) * m_settings.whitePoint.greenF(),
+        qBound(0.0, m_settings.blueGain, 1.0) * m_settings.whitePoint.blueF()
+    };
+    const int shift[3] = {16, 8, 0};
+    
+    m_identity = true;
+    for (int value = 0; value < 256; ++value) {
+        double level = qPow(value / 255.0, gamma);
+        
+        for (int channel = 0; channel < 3; ++channel) {
+            double output = level * scale[channel];
+            quint16 wide = quint16(qRound(output * 65535.0));
+            int narrow = qRound(output * 255.0);
+            
+            m_table16[channel][value] = wide;
+            m_table8[channel][value] = quint32(narrow) << shift[channel];
+            if (narrow != value) {
+                m_identity = false;
+            }
+        }
+    }
+}
@@ -1,33 +1,57 @@
 #include "core/devicemanager.h"
-#include <QApplication>
+#include <QCoreApplication>
 #include <QDebug>
 #include <QDir>
+#include <QFileInfo>
+#include <QThread>
 
 DeviceManager::DeviceManager(QObject *parent)
     : QObject(parent)
+    , m_metadataCache(new PluginMetadataCache(this))
+    , m_pendingPlugins(0)
+    , m_loadedPlugins(0)
     , m_asusManager(nullptr)
+    , m_networkManager(nullptr)
+    , m_serialManager(nullptr)
 {
-    // ASUS-Gerätemanager erstellen und initialisieren
+    // ASUS-Gerätemanager erstellen, initialisiert wird er in loadPlugins()
     m_asusManager = new AsusDeviceManager(this);
     
-    // Plugins beim Start laden
-    loadPlugins();
+    // Netzwerkgeräte (E1.31, Art-Net, DDP) aus config/outputdevices.json
+    m_networkManager = new NetworkDeviceManager(this);
+    
+    // Serielle Adalight-Geräte aus config/serialdevices.json
+    m_serialManager = new SerialDeviceManager(this);
+    
+    // Plugins werden nicht mehr hier geladen: Signale, die im Konstruktor ausgelöst
+    // würden, erreichen noch keinen Empfänger. Der Besitzer ruft loadPlugins() auf,
+    // sobald seine Verbindungen stehen.
 }
 
 DeviceManager::~DeviceManager()
 {
-    // Plugins freigeben
-    for (auto loader : m_pluginLoaders) {
+    // Laufende Ladevorgänge abwarten, bevor die Loader freigegeben werden
+    m_loaderPool.waitForDone();
+    
+    // Fertig geladene, aber noch nicht übernommene Loader freigeben; ihre eingereihten
+    // finishPluginLoad-Aufrufe verfallen mit diesem Objekt
+    for (QPluginLoader *loader : m_startedLoaders) {
         loader->unload();
         delete loader;
     }
-    m_pluginLoaders.clear();
-    m_plugins.clear();
-    m_devices.clear();
+    m_startedLoaders.clear();
+    
+    // Plugins freigeben
+    unloadPlugins(false);
 }
 
 int DeviceManager::loadPlugins()
 {
+    if (m_pendingPlugins > 0) {
+        qWarning() << "Plugins werden bereits geladen, Aufruf wird ignoriert";
+        return 0;
+    }
+    
     qDebug() << "LuminControl wird initialisiert...";
     
     // Plugins-Verzeichnis bestimmen
@@ -38,95 +62,283 @@ int DeviceManager::loadPlugins()
         qDebug() << "Suche Plugins in:" << pluginsDir.absolutePath();
     } else {
         // Wenn nicht vorhanden, im Entwicklungsmodus nach dem Plugins-Verzeichnis suchen
-        pluginsDir = QDir(QApplication::applicationDirPath());
+        pluginsDir = QDir(QCoreApplication::applicationDirPath());
         if (pluginsDir.cdUp() && pluginsDir.cd("plugins")) {
             qDebug() << "Suche Plugins in (Entwicklungsmodus):" << pluginsDir.absolutePath();
         } else {
             qWarning() << "Plugins-Verzeichnis nicht gefunden! Erstelle Verzeichnis...";
-            QDir appDir(QApplication::applicationDirPath());
+            QDir appDir(QCoreApplication::applicationDirPath());
             appDir.mkdir("plugins");
         }
     }
     
-    // Vorhandene Plugins freigeben
-    for (auto loader : m_pluginLoaders) {
-        loader->unload();
-        delete loader;
+    // Vorhandene Plugins freigeben; Abnehmer müssen ihre Gerätezeiger verwerfen
+    unloadPlugins(true);
+    m_loadedPlugins = 0;
+    
+    // ASUS-Gerätemanager initialisieren, solange die Plugins im Hintergrund laden
+    if (m_asusManager && m_asusManager->initialize()) {
+        qDebug() << "ASUS-Gerätemanager erfolgreich initialisiert";
+        
+        // ASUS-Geräte in die Geräteliste einfügen
+        QList<AsusRGBDevice*> asusDevices = m_asusManager->getDevices();
+        for (AsusRGBDevice *device : asusDevices) {
+            addDevice(device);
+        }
+    } else {
+        qWarning() << "ASUS-Gerätemanager konnte nicht initialisiert werden";
+    }
+    
+    // Netzwerkgeräte einfügen
+    if (m_networkManager && m_networkManager->initialize()) {
+        for (NetworkRGBDevice *device : m_networkManager->getDevices()) {
+            addDevice(device);
+        }
+    } else {
+        qWarning() << "Netzwerk-Gerätemanager konnte nicht initialisiert werden";
     }
-    m_pluginLoaders.clear();
-    m_plugins.clear();
-    m_devices.clear();
     
-    // Nach Plugins suchen und laden
-    int loadedPlugins = 0;
+    // Serielle Geräte einfügen
+    if (m_serialManager && m_serialManager->initialize()) {
+        for (SerialRGBDevice *device : m_serialManager->getDevices()) {
+            addDevice(device);
+        }
+    } else {
+        qWarning() << "Serieller Gerätemanager konnte nicht initialisiert werden";
+    }
     
-    // Dynamische Plugins laden
+    // Dynamische Plugins parallel laden
+    int startedPlugins = 0;
+    QStringList pluginPaths;
     foreach (QString fileName, pluginsDir.entryList(QDir::Files)) {
         if (fileName.endsWith(".dll") || fileName.endsWith(".so") || fileName.endsWith(".dylib")) {
-            QPluginLoader *loader = new QPluginLoader(pluginsDir.absoluteFilePath(fileName));
-            QObject *plugin = loader->instance();
+            QString filePath = pluginsDir.absoluteFilePath(fileName);
+            pluginPaths.append(filePath);
             
-            if (plugin) {
-                IRGBDevicePlugin *devicePlugin = qobject_cast<IRGBDevicePlugin*>(plugin);
-                if (devicePlugin) {
-                    qDebug() << "Plugin gefunden:" << devicePlugin->getName() << "von" << devicePlugin->getAuthor();
-                    
-                    // Plugin initialisieren
-                    if (devicePlugin->initialize()) {
-                        m_plugins.append(devicePlugin);
-                        m_pluginLoaders.append(loader);
-                        
-                        // Geräte des Plugins laden
-                        QList<IRGBDevice*> devices = devicePlugin->getDevices();
-                        for (IRGBDevice *device : devices) {
-                            QString deviceId = device->getId();
-                            m_devices.insert(deviceId, device);
-                            qDebug() << "Gerät gefunden:" << device->getDisplayName() << "(" << device->getType() << ")";
-                            
-                            // Signal für neu erkanntes Gerät senden
-                            emit deviceDiscovered(device);
-                        }
-                        
-                        loadedPlugins++;
-                    } else {
-                        qWarning() << "Plugin konnte nicht initialisiert werden:" << devicePlugin->getName();
-                        loader->unload();
-                        delete loader;
-                    }
-                } else {
-                    qWarning() << "Datei ist kein gültiges RGB-Geräteplugin:" << fileName;
-                    loader->unload();
-                    delete loader;
-                }
-            } else {
-                qWarning() << "Fehler beim Laden des Plugins:" << fileName << "-" << loader->errorString();
-                delete loader;
+            // Anhand der (zwischengespeicherten) Metadaten entscheiden, ohne die Bibliothek zu laden
+            if (!m_metadataCache->isDevicePlugin(filePath)) {
+                qDebug() << "Überspringe Datei ohne RGB-Geräteplugin-Metadaten:" << fileName;
+                continue;
+            }
+            if (!m_metadataCache->isEnabled(fileName)) {
+                qDebug() << "Plugin ist deaktiviert:" << fileName;
+                continue;
             }
+            
+            QPluginLoader *loader = new QPluginLoader(filePath);
+            m_startedLoaders.append(loader);
+            m_pendingPlugins++;
+            startedPlugins++;
+            m_loaderPool.start([this, loader]() { loadPluginAsync(loader); });
         }
     }
     
-    // ASUS-Gerätemanager initialisieren
-    if (m_asusManager && m_asusManager->initialize()) {
-        qDebug() << "ASUS-Gerätemanager erfolgreich initialisiert";
+    m_metadataCache->prune(pluginPaths);
+    m_metadataCache->save();
+    
+    if (m_pendingPlugins == 0) {
+        qDebug() << "System bereit für RGB-Geräte";
+        emit pluginLoadingFinished(0);
+    }
+    
+    return startedPlugins;
+}
+
+bool DeviceManager::isLoadingPlugins() const
+{
+    return m_pendingPlugins > 0;
+}
+
+void DeviceManager::setPluginEnabled(const QString &fileName, bool enabled)
+{
+    m_metadataCache->setEnabled(fileName, enabled);
+    m_metadataCache->save();
+}
+
+bool DeviceManager::isPluginEnabled(const QString &fileName) const
+{
+    return m_metadataCache->isEnabled(fileName);
+}
+
+void DeviceManager::loadPluginAsync(QPluginLoader *loader)
+{
+    // Bibliothek laden und Plugin initialisieren; beides kann bei echten SDKs dauern
+    QObject *plugin = loader->instance();
+    IRGBDevicePlugin *devicePlugin = plugin ? qobject_cast<IRGBDevicePlugin*>(plugin) : nullptr;
+    bool initialized = devicePlugin && devicePlugin->initialize();
+    
+    // Plugin und seine Geräte gehören ab jetzt dem Hauptthread
+    if (plugin && plugin->thread() == QThread::currentThread()) {
+        plugin->moveToThread(thread());
+    }
+    
+    QMetaObject::invokeMethod(this, [this, loader, devicePlugin, initialized]() {
+        finishPluginLoad(loader, devicePlugin, initialized);
+    }, Qt::QueuedConnection);
+}
+
+void DeviceManager::finishPluginLoad(QPluginLoader *loader, IRGBDevicePlugin *devicePlugin, bool initialized)
+{
+    QString fileName = QFileInfo(loader->fileName()).fileName();
+    m_startedLoaders.removeOne(loader);
+    
+    if (!loader->isLoaded()) {
+        qWarning() << "Fehler beim Laden des Plugins:" << fileName << "-" << loader->errorString();
+        delete loader;
+    } else if (!devicePlugin) {
+        qWarning() << "Datei ist kein gültiges RGB-Geräteplugin:" << fileName;
+        loader->unload();
+        delete loader;
+    } else if (!initialized) {
+        qWarning() << "Plugin konnte nicht initialisiert werden:" << devicePlugin->getName();
+        loader->unload();
+        delete loader;
+    } else {
+        qDebug() << "Plugin gefunden:" << devicePlugin->getName() << "von" << devicePlugin->getAuthor();
         
-        // ASUS-Geräte in die Geräteliste einfügen
-        QList<AsusRGBDevice*> asusDevices = m_asusManager->getDevices();
-        for (AsusRGBDevice *device : asusDevices) {
-            QString deviceId = device->getId();
-            m_devices.insert(deviceId, device);
-            qDebug() << "ASUS-Gerät gefunden:" << device->getDisplayName() << "(" << device->getType() << ")";
-            
-            // Signal für neu erkanntes Gerät senden
-            emit deviceDiscovered(device);
+        m_plugins.append(devicePlugin);
+        m_pluginLoaders.append(loader);
+        m_loadedPlugins++;
+        emit pluginLoaded(devicePlugin);
+        
+        // Hotplug-fähige Plugins dürfen selbst eine inkrementelle Suche anstoßen
+        QObject *pluginObject = loader->instance();
+        if (qobject_cast<IHotplugDevicePlugin*>(pluginObject)
+            && pluginObject->metaObject()->indexOfSignal("devicesChanged()") >= 0) {
+            connect(pluginObject, SIGNAL(devicesChanged()), this, SLOT(rescanDevices()));
         }
-    } else {
-        qWarning() << "ASUS-Gerätemanager konnte nicht initialisiert werden";
+        
+        // Geräte des Plugins sofort melden, ohne auf die übrigen Plugins zu warten
+        QList<IRGBDevice*> devices = devicePlugin->getDevices();
+        for (IRGBDevice *device : devices) {
+            addDevice(device);
+        }
+    }
+    
+    if (--m_pendingPlugins == 0) {
+        qDebug() << "System bereit für RGB-Geräte";
+        qDebug() << m_loadedPlugins << "Plugins geladen mit" << m_devices.size() << "Geräten";
+        emit pluginLoadingFinished(m_loadedPlugins);
+    }
+}
+
+void DeviceManager::addDevice(IRGBDevice *device)
+{
+    QString deviceId = device->getId();
+    m_devices.insert(deviceId, device);
+    qDebug() << "Gerät gefunden:" << device->getDisplayName() << "(" << device->getType() << ")";
+    
+    // Signal für neu erkanntes Gerät senden
+    emit deviceDiscovered(device);
+}
+
+int DeviceManager::rescanDevices()
+{
+    if (m_pendingPlugins > 0) {
+        qWarning() << "Plugins werden noch geladen, Gerätesuche wird übersprungen";
+        return 0;
+    }
+    
+    int changes = 0;
+    
+    // Integrierte ASUS-Geräte
+    if (m_asusManager) {
+        QList<AsusRGBDevice*> added;
+        QStringList removedIds;
+        if (m_asusManager->rescanDevices(added, removedIds)) {
+            for (const QString &deviceId : removedIds) {
+                removeDevice(deviceId);
+            }
+            for (AsusRGBDevice *device : added) {
+                addDevice(device);
+            }
+            changes += added.size() + removedIds.size();
+        }
+    }
+    
+    // Netzwerkgeräte aus der Konfiguration
+    if (m_networkManager) {
+        QList<NetworkRGBDevice*> added;
+        QStringList removedIds;
+        if (m_networkManager->rescanDevices(added, removedIds)) {
+            for (const QString &deviceId : removedIds) {
+                removeDevice(deviceId);
+            }
+            for (NetworkRGBDevice *device : added) {
+                addDevice(device);
+            }
+            changes += added.size() + removedIds.size();
+        }
+    }
+    
+    // Serielle Geräte aus der Konfiguration
+    if (m_serialManager) {
+        QList<SerialRGBDevice*> added;
+        QStringList removedIds;
+        if (m_serialManager->rescanDevices(added, removedIds)) {
+            for (const QString &deviceId : removedIds) {
+                removeDevice(deviceId);
+            }
+            for (SerialRGBDevice *device : added) {
+                addDevice(device);
+            }
+            changes += added.size() + removedIds.size();
+        }
+    }
+    
+    // Plugins, die eine inkrementelle Suche unterstützen
+    for (QPluginLoader *loader : m_pluginLoaders) {
+        IHotplugDevicePlugin *hotplugPlugin = qobject_cast<IHotplugDevicePlugin*>(loader->instance());
+        if (!hotplugPlugin) {
+            continue;
+        }
+        
+        QList<IRGBDevice*> added;
+        QStringList removedIds;
+        if (hotplugPlugin->rescanDevices(added, removedIds)) {
+            for (const QString &deviceId : removedIds) {
+                removeDevice(deviceId);
+            }
+            for (IRGBDevice *device : added) {
+                addDevice(device);
+            }
+            changes += added.size() + removedIds.size();
+        }
+    }
+    
+    if (changes > 0) {
+        qDebug() << "Gerätesuche abgeschlossen:" << changes << "Änderungen," << m_devices.size() << "Geräte";
+    }
+    
+    return changes;
+}
+
+void DeviceManager::removeDevice(const QString &deviceId)
+{
+    IRGBDevice *device = m_devices.take(deviceId);
+    if (!device) {
+        return;
     }
     
-    qDebug() << "System bereit für RGB-Geräte";
-    qDebug() << loadedPlugins << "Plugins geladen mit" << m_devices.size() << "Geräten";
+    qDebug() << "Gerät entfernt:" << device->getDisplayName();
+    emit deviceRemoved(device);
+}
+
+void DeviceManager::unloadPlugins(bool notify)
+{
+    if (notify) {
+        for (const QString &deviceId : m_devices.keys()) {
+            removeDevice(deviceId);
+        }
+    }
     
-    return loadedPlugins;
+    for (auto loader : m_pluginLoaders) {
+        loader->unload();
+        delete loader;
+    }
+    m_pluginLoaders.clear();
+    m_plugins.clear();
+    m_devices.clear();
 }
 
 QList<IRGBDevicePlugin*> DeviceManager::getPlugins() const
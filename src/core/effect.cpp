@@ -1,6 +1,67 @@
 #include "core/effect.h"
 #include "core/color.h"
 #include <QDebug>
+#include <QtMath>
+#include <algorithm>
+
+namespace {
+
+// Phase (0.0 - 1.0) eines Dreiecksverlaufs zwischen minValue und maxValue
+qreal trianglePhase(qreal value, bool rising, qreal minValue, qreal maxValue)
+{
+    qreal normalized = (value - minValue) / (maxValue - minValue);
+    return rising ? normalized * 0.5 : 0.5 + (1.0 - normalized) * 0.5;
+}
+
+// Wert eines Dreiecksverlaufs zwischen minValue und maxValue an einer Phase
+qreal triangleValue(qreal phase, qreal minValue, qreal maxValue)
+{
+    phase -= qFloor(phase);
+    qreal normalized = phase < 0.5 ? phase * 2.0 : (1.0 - phase) * 2.0;
+    return minValue + normalized * (maxValue - minValue);
+}
+
+// Wandelt die Parameter einmalig an der API-Grenze um; ungültige Felder behalten ihren Standardwert
+template <typename EffectClass>
+Effect *createTypedEffect(const QVariantMap &parameters, QObject *parent)
+{
+    typename EffectClass::Parameters typedParameters;
+    QStringList errors;
+    if (!EffectParameters::fromVariantMap(parameters, &typedParameters, &errors)) {
+        qWarning() << "Ungültige Effektparameter, verwende Standardwerte:" << errors;
+    }
+    
+    return new EffectClass(typedParameters, parent);
+}
+
+template <typename Params>
+bool validateTypedParameters(const QVariantMap &parameters, QStringList *errors)
+{
+    Params typedParameters;
+    return EffectParameters::fromVariantMap(parameters, &typedParameters, errors);
+}
+
+// Ausdrücke werden zusätzlich übersetzt, damit Syntaxfehler schon beim Prüfen auffallen
+template <>
+bool validateTypedParameters<ExpressionParameters>(const QVariantMap &parameters, QStringList *errors)
+{
+    ExpressionParameters typedParameters;
+    if (!EffectParameters::fromVariantMap(parameters, &typedParameters, errors)) {
+        return false;
+    }
+    
+    ExpressionProgram program;
+    QString errorMessage;
+    if (!program.compile(QStringList() << typedParameters.red << typedParameters.green << typedParameters.blue, &errorMessage)) {
+        if (errors) {
+            errors->append(QString("Ungültiger Ausdruck: %1").arg(errorMessage));
+        }
+        return false;
+    }
+    return true;
+}
+
+} // namespace
 
 // Effect Basisklasse
 Effect::Effect(Type type, QObject *parent)
@@ -26,9 +87,49 @@ QString Effect::getName() const
     return nameFromType(m_type);
 }
 
-void Effect::setParameters(const QVariantMap &parameters)
+QColor Effect::getColorAtPhase(qreal phaseOffset) const
+{
+    Q_UNUSED(phaseOffset);
+    return getCurrentColor();
+}
+
+bool Effect::isPeriodic() const
+{
+    return false;
+}
+
+void Effect::renderPalette(QRgb *palette, int size) const
+{
+    if (!isPeriodic()) {
+        std::fill(palette, palette + size, getCurrentColor().rgb());
+        return;
+    }
+    
+    for (int i = 0; i < size; ++i) {
+        palette[i] = getColorAtPhase(qreal(i) / size).rgb();
+    }
+}
+
+bool Effect::rendersPerLed() const
+{
+    return false;
+}
+
+void Effect::renderFrame(QRgb *frame, int ledCount, const QVector3D *positions) const
+{
+    Q_UNUSED(positions);
+    std::fill(frame, frame + ledCount, getCurrentColor().rgb());
+}
+
+void Effect::setInputValue(const QString &name, qreal value)
 {
-    m_parameters = parameters;
+    Q_UNUSED(name);
+    Q_UNUSED(value);
+}
+
+LayoutParameters Effect::getLayoutParameters() const
+{
+    return LayoutParameters();
 }
 
 void Effect::start()
@@ -49,60 +150,50 @@ bool Effect::isActive() const
     return m_active;
 }
 
+bool Effect::isAnimating() const
+{
+    return m_active && m_timer->isActive();
+}
+
+int Effect::getColorReceiverCount() const
+{
+    return receivers(SIGNAL(colorChanged(QColor)));
+}
+
 Effect* Effect::createEffect(Type type, const QVariantMap &parameters, QObject *parent)
 {
-    Effect *effect = nullptr;
-    
     switch (type) {
-        case Static: {
-            QColor color = parameters.value("color", QColor(Qt::white)).value<QColor>();
-            effect = new StaticEffect(color, parent);
-            break;
-        }
-        case Breathing: {
-            QColor color = parameters.value("color", QColor(Qt::white)).value<QColor>();
-            int speed = parameters.value("speed", 2000).toInt();
-            effect = new BreathingEffect(color, speed, parent);
-            break;
-        }
-        case Rainbow: {
-            int speed = parameters.value("speed", 2000).toInt();
-            effect = new RainbowEffect(speed, parent);
-            break;
-        }
-        case Wave: {
-            QColor color1 = parameters.value("color1", QColor(Qt::blue)).value<QColor>();
-            QColor color2 = parameters.value("color2", QColor(Qt::cyan)).value<QColor>();
-            int speed = parameters.value("speed", 2000).toInt();
-            effect = new WaveEffect(color1, color2, speed, parent);
-            break;
-        }
-        case Reactive: {
-            QColor color = parameters.value("color", QColor(Qt::white)).value<QColor>();
-            int duration = parameters.value("duration", 500).toInt();
-            effect = new ReactiveEffect(color, duration, parent);
-            break;
-        }
+        case Static: return createTypedEffect<StaticEffect>(parameters, parent);
+        case Breathing: return createTypedEffect<BreathingEffect>(parameters, parent);
+        case Rainbow: return createTypedEffect<RainbowEffect>(parameters, parent);
+        case Wave: return createTypedEffect<WaveEffect>(parameters, parent);
+        case Reactive: return createTypedEffect<ReactiveEffect>(parameters, parent);
+        case Expression: return createTypedEffect<ExpressionEffect>(parameters, parent);
         default:
             qWarning() << "Unbekannter Effekttyp:" << type;
-            effect = new StaticEffect(Qt::white, parent);
-            break;
+            return new StaticEffect(StaticParameters(), parent);
     }
-    
-    if (effect) {
-        effect->setParameters(parameters);
+}
+
+bool Effect::validateParameters(Type type, const QVariantMap &parameters, QStringList *errors)
+{
+    switch (type) {
+        case Static: return validateTypedParameters<StaticParameters>(parameters, errors);
+        case Breathing: return validateTypedParameters<BreathingParameters>(parameters, errors);
+        case Rainbow: return validateTypedParameters<RainbowParameters>(parameters, errors);
+        case Wave: return validateTypedParameters<WaveParameters>(parameters, errors);
+        case Reactive: return validateTypedParameters<ReactiveParameters>(parameters, errors);
+        case Expression: return validateTypedParameters<ExpressionParameters>(parameters, errors);
+        default: return false;
     }
-    
-    return effect;
 }
 
 Effect::Type Effect::typeFromName(const QString &name)
 {
-    if (name == "Statisch") return Static;
-    if (name == "Atmen") return Breathing;
-    if (name == "Regenbogen") return Rainbow;
-    if (name == "Welle") return Wave;
-    if (name == "Reaktiv") return Reactive;
+    Type type;
+    if (typeFromId(name, &type)) {
+        return type;
+    }
     
     // Standardwert zurückgeben, wenn der Name nicht erkannt wurde
     return Static;
@@ -116,37 +207,79 @@ QString Effect::nameFromType(Type type)
         case Rainbow: return "Regenbogen";
         case Wave: return "Welle";
         case Reactive: return "Reaktiv";
+        case Expression: return "Ausdruck";
         default: return "Unbekannt";
     }
 }
 
+QString Effect::idFromType(Type type)
+{
+    switch (type) {
+        case Static: return "static";
+        case Breathing: return "breathing";
+        case Rainbow: return "rainbow";
+        case Wave: return "wave";
+        case Reactive: return "reactive";
+        case Expression: return "expression";
+        default: return QString();
+    }
+}
+
+bool Effect::typeFromId(const QString &name, Type *type)
+{
+    // Kanonische ID, Anzeigename und abweichender englischer Gerätename je Effekttyp
+    static const struct {
+        Type type;
+        const char *aliases[3];
+    } aliasTable[] = {
+        { Static,     { "static",     "statisch",   nullptr    } },
+        { Breathing,  { "breathing",  "atmen",      "breathe"  } },
+        { Rainbow,    { "rainbow",    "regenbogen", "spectrum" } },
+        { Wave,       { "wave",       "welle",      nullptr    } },
+        { Reactive,   { "reactive",   "reaktiv",    nullptr    } },
+        { Expression, { "expression", "ausdruck",   "custom"   } }
+    };
+    
+    const QString key = name.trimmed().toLower();
+    for (const auto &entry : aliasTable) {
+        for (const char *alias : entry.aliases) {
+            if (alias && key == QLatin1String(alias)) {
+                *type = entry.type;
+                return true;
+            }
+        }
+    }
+    
+    return false;
+}
+
+QString Effect::canonicalId(const QString &name)
+{
+    Type type;
+    return typeFromId(name, &type) ? idFromType(type) : QString();
+}
+
 // StaticEffect
-StaticEffect::StaticEffect(const QColor &color, QObject *parent)
-    : Effect(Static, parent)
-    , m_color(color)
+StaticEffect::StaticEffect(const StaticParameters &parameters, QObject *parent)
+    : TypedEffect(Static, parameters, parent)
 {
 }
 
 QColor StaticEffect::getCurrentColor() const
 {
-    return m_color;
+    return m_params.color;
 }
 
-void StaticEffect::setParameters(const QVariantMap &parameters)
+void StaticEffect::applyParameters(const StaticParameters &previous)
 {
-    Effect::setParameters(parameters);
-    
-    if (parameters.contains("color")) {
-        m_color = parameters["color"].value<QColor>();
-        emit colorChanged(m_color);
+    if (m_params.color != previous.color) {
+        emit colorChanged(m_params.color);
     }
 }
 
 // BreathingEffect
-BreathingEffect::BreathingEffect(const QColor &color, int speed, QObject *parent)
-    : Effect(Breathing, parent)
-    , m_color(color)
-    , m_speed(speed)
+BreathingEffect::BreathingEffect(const BreathingParameters &parameters, QObject *parent)
+    : TypedEffect(Breathing, parameters, parent)
     , m_intensity(0.0)
     , m_increasing(true)
 {
@@ -156,30 +289,37 @@ BreathingEffect::BreathingEffect(const QColor &color, int speed, QObject *parent
 QColor BreathingEffect::getCurrentColor() const
 {
     // Farbe mit aktueller Intensität berechnen
-    int h, s, v;
-    m_color.getHsv(&h, &s, &v);
-    
-    // Helligkeit basierend auf Intensität anpassen
-    int newV = qRound(v * m_intensity);
+    float h, s, v;
+    m_params.color.getHsvF(&h, &s, &v);
     
+    // Helligkeit mit voller Genauigkeit anpassen; QColor hält 16 Bit pro Kanal,
+    // erst die Ausgabe rundet (oder dithert) auf 8 Bit
     QColor currentColor;
-    currentColor.setHsv(h, s, newV);
+    currentColor.setHsvF(h, s, v * float(m_intensity));
     return currentColor;
 }
 
-void BreathingEffect::setParameters(const QVariantMap &parameters)
+QColor BreathingEffect::getColorAtPhase(qreal phaseOffset) const
 {
-    Effect::setParameters(parameters);
+    qreal phase = trianglePhase(m_intensity, m_increasing, 0.1, 1.0) + phaseOffset;
     
-    if (parameters.contains("color")) {
-        m_color = parameters["color"].value<QColor>();
-    }
+    float h, s, v;
+    m_params.color.getHsvF(&h, &s, &v);
     
-    if (parameters.contains("speed")) {
-        m_speed = parameters["speed"].toInt();
-        if (m_active) {
-            m_timer->setInterval(m_speed / 50);
-        }
+    QColor color;
+    color.setHsvF(h, s, v * float(triangleValue(phase, 0.1, 1.0)));
+    return color;
+}
+
+bool BreathingEffect::isPeriodic() const
+{
+    return true;
+}
+
+void BreathingEffect::applyParameters(const BreathingParameters &previous)
+{
+    if (m_params.speed != previous.speed && m_active) {
+        m_timer->setInterval(m_params.speed / 50);
     }
 }
 
@@ -188,7 +328,7 @@ void BreathingEffect::start()
     Effect::start();
     m_intensity = 0.1;
     m_increasing = true;
-    m_timer->setInterval(m_speed / 50);
+    m_timer->setInterval(m_params.speed / 50);
     m_timer->start();
 }
 
@@ -213,9 +353,8 @@ void BreathingEffect::update()
 }
 
 // RainbowEffect
-RainbowEffect::RainbowEffect(int speed, QObject *parent)
-    : Effect(Rainbow, parent)
-    , m_speed(speed)
+RainbowEffect::RainbowEffect(const RainbowParameters &parameters, QObject *parent)
+    : TypedEffect(Rainbow, parameters, parent)
     , m_hue(0)
 {
     connect(m_timer, &QTimer::timeout, this, &RainbowEffect::update);
@@ -228,15 +367,27 @@ QColor RainbowEffect::getCurrentColor() const
     return color;
 }
 
-void RainbowEffect::setParameters(const QVariantMap &parameters)
+QColor RainbowEffect::getColorAtPhase(qreal phaseOffset) const
 {
-    Effect::setParameters(parameters);
+    int hue = (m_hue + qRound(phaseOffset * 360.0)) % 360;
+    if (hue < 0) {
+        hue += 360;
+    }
     
-    if (parameters.contains("speed")) {
-        m_speed = parameters["speed"].toInt();
-        if (m_active) {
-            m_timer->setInterval(m_speed / 360);
-        }
+    QColor color;
+    color.setHsv(hue, 255, 255);
+    return color;
+}
+
+bool RainbowEffect::isPeriodic() const
+{
+    return true;
+}
+
+void RainbowEffect::applyParameters(const RainbowParameters &previous)
+{
+    if (m_params.speed != previous.speed && m_active) {
+        m_timer->setInterval(m_params.speed / 360);
     }
 }
 
@@ -244,7 +395,7 @@ void RainbowEffect::start()
 {
     Effect::start();
     m_hue = 0;
-    m_timer->setInterval(m_speed / 360);
+    m_timer->setInterval(m_params.speed / 360);
     m_timer->start();
 }
 
@@ -256,11 +407,8 @@ void RainbowEffect::update()
 }
 
 // WaveEffect
-WaveEffect::WaveEffect(const QColor &color1, const QColor &color2, int speed, QObject *parent)
-    : Effect(Wave, parent)
-    , m_color1(color1)
-    , m_color2(color2)
-    , m_speed(speed)
+WaveEffect::WaveEffect(const WaveParameters &parameters, QObject *parent)
+    : TypedEffect(Wave, parameters, parent)
     , m_position(0.0)
     , m_forward(true)
 {
@@ -269,26 +417,24 @@ WaveEffect::WaveEffect(const QColor &color1, const QColor &color2, int speed, QO
 
 QColor WaveEffect::getCurrentColor() const
 {
-    return Color::interpolate(m_color1, m_color2, m_position);
+    return Color::interpolate(m_params.color1, m_params.color2, m_position);
 }
 
-void WaveEffect::setParameters(const QVariantMap &parameters)
+QColor WaveEffect::getColorAtPhase(qreal phaseOffset) const
 {
-    Effect::setParameters(parameters);
-    
-    if (parameters.contains("color1")) {
-        m_color1 = parameters["color1"].value<QColor>();
-    }
-    
-    if (parameters.contains("color2")) {
-        m_color2 = parameters["color2"].value<QColor>();
-    }
-    
-    if (parameters.contains("speed")) {
-        m_speed = parameters["speed"].toInt();
-        if (m_active) {
-            m_timer->setInterval(m_speed / 100);
-        }
+    qreal phase = trianglePhase(m_position, m_forward, 0.0, 1.0) + phaseOffset;
+    return Color::interpolate(m_params.color1, m_params.color2, triangleValue(phase, 0.0, 1.0));
+}
+
+bool WaveEffect::isPeriodic() const
+{
+    return true;
+}
+
+void WaveEffect::applyParameters(const WaveParameters &previous)
+{
+    if (m_params.speed != previous.speed && m_active) {
+        m_timer->setInterval(m_params.speed / 100);
     }
 }
 
@@ -297,7 +443,7 @@ void WaveEffect::start()
     Effect::start();
     m_position = 0.0;
     m_forward = true;
-    m_timer->setInterval(m_speed / 100);
+    m_timer->setInterval(m_params.speed / 100);
     m_timer->start();
 }
 
@@ -322,11 +468,8 @@ void WaveEffect::update()
 }
 
 // ReactiveEffect
-ReactiveEffect::ReactiveEffect(const QColor &color, int duration, QObject *parent)
-    : Effect(Reactive, parent)
-    , m_color(color)
-    , m_baseColor(Qt::black)
-    , m_duration(duration)
+ReactiveEffect::ReactiveEffect(const ReactiveParameters &parameters, QObject *parent)
+    : TypedEffect(Reactive, parameters, parent)
     , m_intensity(0.0)
 {
     connect(m_timer, &QTimer::timeout, this, &ReactiveEffect::update);
@@ -334,23 +477,13 @@ ReactiveEffect::ReactiveEffect(const QColor &color, int duration, QObject *paren
 
 QColor ReactiveEffect::getCurrentColor() const
 {
-    return Color::interpolate(m_baseColor, m_color, m_intensity);
+    return Color::interpolate(m_params.baseColor, m_params.color, m_intensity);
 }
 
-void ReactiveEffect::setParameters(const QVariantMap &parameters)
+void ReactiveEffect::applyParameters(const ReactiveParameters &previous)
 {
-    Effect::setParameters(parameters);
-    
-    if (parameters.contains("color")) {
-        m_color = parameters["color"].value<QColor>();
-    }
-    
-    if (parameters.contains("baseColor")) {
-        m_baseColor = parameters["baseColor"].value<QColor>();
-    }
-    
-    if (parameters.contains("duration")) {
-        m_duration = parameters["duration"].toInt();
+    if (m_params.duration != previous.duration && m_active) {
+        m_timer->setInterval(m_params.duration / 50);
     }
 }
 
@@ -358,7 +491,7 @@ void ReactiveEffect::start()
 {
     Effect::start();
     m_intensity = 0.0;
-    m_timer->setInterval(m_duration / 50);
+    m_timer->setInterval(m_params.duration / 50);
 }
 
 void ReactiveEffect::trigger()
@@ -387,3 +520,107 @@ void ReactiveEffect::update()
     
     emit colorChanged(getCurrentColor());
 }
+
+// ExpressionEffect
+ExpressionEffect::ExpressionEffect(const ExpressionParameters &parameters, QObject *parent)
+    : TypedEffect(Expression, parameters, parent)
+{
+    // Ungültige Ausdrücke durch die Standardausdrücke ersetzen
+    if (!m_program.compile(QStringList() << m_params.red << m_params.green << m_params.blue)) {
+        ExpressionParameters defaults;
+        m_params.red = defaults.red;
+        m_params.green = defaults.green;
+        m_params.blue = defaults.blue;
+        m_program.compile(QStringList() << m_params.red << m_params.green << m_params.blue);
+    }
+    
+    connect(m_timer, &QTimer::timeout, this, &ExpressionEffect::update);
+}
+
+QColor ExpressionEffect::getCurrentColor() const
+{
+    QRgb color = qRgb(0, 0, 0);
+    renderFrame(&color, 1, nullptr);
+    return QColor::fromRgb(color);
+}
+
+bool ExpressionEffect::rendersPerLed() const
+{
+    return true;
+}
+
+void ExpressionEffect::renderFrame(QRgb *frame, int ledCount, const QVector3D *positions) const
+{
+    if (ledCount <= 0) {
+        return;
+    }
+    
+    m_program.setVariable(ExpressionProgram::Time, m_clock.isValid() ? m_clock.elapsed() / 1000.0f : 0.0f);
+    
+    // Kanäle und Positionen als zusammenhängende Float-Reihen für die Blockauswertung
+    m_channels.resize(ledCount * 3);
+    float *channels[3] = { m_channels.data(), m_channels.data() + ledCount, m_channels.data() + 2 * ledCount };
+    
+    const float *x = nullptr;
+    const float *y = nullptr;
+    if (positions) {
+        m_positions.resize(ledCount * 2);
+        float *px = m_positions.data();
+        float *py = px + ledCount;
+        for (int led = 0; led < ledCount; ++led) {
+            px[led] = positions[led].x();
+            py[led] = positions[led].y();
+        }
+        x = px;
+        y = py;
+    }
+    
+    m_program.evaluate(ledCount, x, y, channels);
+    
+    for (int led = 0; led < ledCount; ++led) {
+        frame[led] = qRgb(qBound(0, int(channels[0][led] * 255.0f + 0.5f), 255),
+                          qBound(0, int(channels[1][led] * 255.0f + 0.5f), 255),
+                          qBound(0, int(channels[2][led] * 255.0f + 0.5f), 255));
+    }
+}
+
+void ExpressionEffect::setInputValue(const QString &name, qreal value)
+{
+    if (name == QLatin1String("cpu")) {
+        m_program.setVariable(ExpressionProgram::CpuTemperature, float(value));
+    } else if (name == QLatin1String("gpu")) {
+        m_program.setVariable(ExpressionProgram::GpuTemperature, float(value));
+    }
+}
+
+void ExpressionEffect::applyParameters(const ExpressionParameters &previous)
+{
+    if (m_params.red != previous.red || m_params.green != previous.green || m_params.blue != previous.blue) {
+        // Bei einem Fehler läuft das bisherige Programm mit seinen Ausdrücken weiter
+        QString errorMessage;
+        if (!m_program.compile(QStringList() << m_params.red << m_params.green << m_params.blue, &errorMessage)) {
+            qWarning() << "Ausdruck-Effekt nicht übernommen:" << errorMessage;
+            m_params.red = previous.red;
+            m_params.green = previous.green;
+            m_params.blue = previous.blue;
+        }
+    }
+    
+    m_params.interval = qMax(1, m_params.interval);
+    if (m_params.interval != previous.interval && m_active) {
+        m_timer->setInterval(m_params.interval);
+    }
+}
+
+void ExpressionEffect::start()
+{
+    Effect::start();
+    m_clock.start();
+    m_timer->setInterval(qMax(1, m_params.interval));
+    m_timer->start();
+}
+
+void ExpressionEffect::update()
+{
+    emit colorChanged(getCurrentColor());
+}
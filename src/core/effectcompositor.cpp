@@ -0,0 +1,412 @@
+#include "core/effectcompositor.h"
+#include "core/framegovernor.h"
+#include <QTimer>
+#include <QtMath>
+#include <QDebug>
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+// Exakte Division durch 255 für Werte von 0 bis 255 * 255
+inline unsigned div255(unsigned value)
+{
+    value += 128;
+    return (value + (value >> 8)) >> 8;
+}
+
+// Mischt src in dst. Die Gewichte liegen je Farbkanal vor, sodass die Schleife
+// ohne Verzweigung oder Indexumrechnung über alle Bytes läuft und vektorisiert wird.
+template <EffectCompositor::BlendMode Mode>
+void blendSpan(quint8 *dst, const quint8 *below, const quint8 *src, const quint8 *weights, int count)
+{
+    for (int i = 0; i < count; ++i) {
+        unsigned d = below[i];
+        unsigned s = src[i];
+        unsigned blended;
+        
+        if (Mode == EffectCompositor::Add) {
+            blended = std::min(d + s, 255u);
+        } else if (Mode == EffectCompositor::Multiply) {
+            blended = div255(d * s);
+        } else if (Mode == EffectCompositor::Max) {
+            blended = std::max(d, s);
+        } else {
+            blended = s;
+        }
+        
+        unsigned w = weights[i];
+        dst[i] = quint8(div255(d * (255u - w) + blended * w));
+    }
+}
+
+void blendLayer(EffectCompositor::BlendMode mode, QRgb *dst, const QRgb *below, const QRgb *src,
+                const quint8 *weights, int ledCount)
+{
+    quint8 *out = reinterpret_cast<quint8*>(dst);
+    const quint8 *base = reinterpret_cast<const quint8*>(below);
+    const quint8 *layer = reinterpret_cast<const quint8*>(src);
+    const int count = ledCount * 4;
+    
+    switch (mode) {
+    case EffectCompositor::Add:
+        blendSpan<EffectCompositor::Add>(out, base, layer, weights, count);
+        break;
+    case EffectCompositor::Multiply:
+        blendSpan<EffectCompositor::Multiply>(out, base, layer, weights, count);
+        break;
+    case EffectCompositor::Max:
+        blendSpan<EffectCompositor::Max>(out, base, layer, weights, count);
+        break;
+    case EffectCompositor::Normal:
+    default:
+        blendSpan<EffectCompositor::Normal>(out, base, layer, weights, count);
+        break;
+    }
+}
+
+} // namespace
+
+EffectCompositor::EffectCompositor(const QString &deviceId, int ledCount, LedLayout *layout, QObject *parent)
+    : QObject(parent)
+    , m_deviceId(deviceId)
+    , m_ledCount(qMax(1, ledCount))
+    , m_layout(layout)
+    , m_palette(256)
+    , m_baseDirty(true)
+    , m_composeScheduled(false)
+    , m_governor(nullptr)
+    , m_skippedFrames(0)
+{
+    if (m_layout) {
+        connect(m_layout, &LedLayout::layoutChanged, this, &EffectCompositor::onLayoutChanged);
+        if (m_layout->containsDevice(m_deviceId)) {
+            m_ledCount = qMax(1, int(m_layout->getLedPositions(m_deviceId).size()));
+        }
+    }
+    
+    m_base.fill(qRgb(0, 0, 0), m_ledCount);
+}
+
+EffectCompositor::~EffectCompositor()
+{
+    for (Layer *layer : m_layers) {
+        layer->effect->stop();
+        delete layer->effect;
+        delete layer;
+    }
+    m_layers.clear();
+}
+
+void EffectCompositor::setBaseFrame(const QVector<QRgb> &frame)
+{
+    if (frame.isEmpty()) {
+        return;
+    }
+    
+    // Fehlende LEDs erhalten die Farbe der letzten gelieferten LED
+    int count = qMin(int(frame.size()), m_ledCount);
+    std::copy(frame.constBegin(), frame.constBegin() + count, m_base.begin());
+    std::fill(m_base.begin() + count, m_base.end(), frame.at(count - 1));
+    
+    m_baseDirty = true;
+    scheduleCompose();
+}
+
+void EffectCompositor::setBaseColor(const QColor &color)
+{
+    m_base.fill(color.rgb());
+    m_baseDirty = true;
+    scheduleCompose();
+}
+
+int EffectCompositor::addLayer(Effect *effect, BlendMode mode, qreal opacity)
+{
+    if (!effect) {
+        return -1;
+    }
+    
+    effect->setParent(this);
+    
+    Layer *layer = new Layer;
+    layer->effect = effect;
+    layer->mode = mode;
+    layer->opacity = quint8(qRound(qBound(0.0, opacity, 1.0) * 255.0));
+    layer->dirty = true;
+    
+    LayoutParameters layout = effect->getLayoutParameters();
+    qreal angle = qDegreesToRadians(layout.direction);
+    layer->spatial = effect->isPeriodic() && layout.spatial;
+    layer->direction = QVector3D(float(qCos(angle)), float(qSin(angle)), 0.0f);
+    layer->periods = layout.periods;
+    
+    m_layers.append(layer);
+    resizeBuffers();
+    
+    // Nur Ebenen, deren Effekt sich gemeldet hat, werden neu gerendert
+    connect(effect, &Effect::colorChanged, this, [this, layer]() {
+        layer->dirty = true;
+        scheduleCompose();
+    });
+    
+    scheduleCompose();
+    return m_layers.size() - 1;
+}
+
+bool EffectCompositor::removeLayer(int index)
+{
+    if (index < 0 || index >= m_layers.size()) {
+        return false;
+    }
+    
+    Layer *layer = m_layers.takeAt(index);
+    layer->effect->stop();
+    delete layer->effect;
+    delete layer;
+    
+    // Die darüberliegenden Ebenen müssen neu gemischt werden
+    if (index < m_layers.size()) {
+        m_layers.at(index)->dirty = true;
+    } else if (!m_layers.isEmpty()) {
+        m_layers.last()->dirty = true;
+    } else {
+        m_baseDirty = true;
+    }
+    scheduleCompose();
+    
+    return true;
+}
+
+bool EffectCompositor::setLayerMask(int index, const QVector<quint8> &mask)
+{
+    if (index < 0 || index >= m_layers.size()) {
+        return false;
+    }
+    
+    Layer *layer = m_layers.at(index);
+    layer->mask = mask;
+    updateWeights(layer);
+    layer->dirty = true;
+    scheduleCompose();
+    
+    return true;
+}
+
+bool EffectCompositor::setLayerOpacity(int index, qreal opacity)
+{
+    if (index < 0 || index >= m_layers.size()) {
+        return false;
+    }
+    
+    Layer *layer = m_layers.at(index);
+    layer->opacity = quint8(qRound(qBound(0.0, opacity, 1.0) * 255.0));
+    updateWeights(layer);
+    layer->dirty = true;
+    scheduleCompose();
+    
+    return true;
+}
+
+void EffectCompositor::setFrameGovernor(FrameGovernor *governor)
+{
+    m_governor = governor;
+}
+
+void EffectCompositor::setInputValue(const QString &name, qreal value)
+{
+    for (Layer *layer : m_layers) {
+        layer->effect->setInputValue(name, value);
+    }
+}
+
+int EffectCompositor::getLayerCount() const
+{
+    return m_layers.size();
+}
+
+bool EffectCompositor::isAnimating() const
+{
+    for (const Layer *layer : m_layers) {
+        if (layer->effect->isAnimating()) {
+            return true;
+        }
+    }
+    return false;
+}
+
+const QVector<QRgb> &EffectCompositor::getFrame() const
+{
+    return m_layers.isEmpty() ? m_base : m_layers.last()->composite;
+}
+
+EffectCompositor::BlendMode EffectCompositor::blendModeFromName(const QString &name)
+{
+    QString mode = name.trimmed().toLower();
+    
+    if (mode == "add") {
+        return Add;
+    } else if (mode == "multiply") {
+        return Multiply;
+    } else if (mode == "max") {
+        return Max;
+    }
+    
+    return Normal;
+}
+
+void EffectCompositor::onLayoutChanged()
+{
+    if (!m_layout->containsDevice(m_deviceId)) {
+        return;
+    }
+    
+    int ledCount = qMax(1, int(m_layout->getLedPositions(m_deviceId).size()));
+    if (ledCount == m_ledCount) {
+        // Die Phasentabellen können sich trotzdem geändert haben
+        for (Layer *layer : m_layers) {
+            layer->dirty = layer->dirty || layer->spatial;
+        }
+        scheduleCompose();
+        return;
+    }
+    
+    m_ledCount = ledCount;
+    m_base.resize(m_ledCount);
+    m_baseDirty = true;
+    resizeBuffers();
+    scheduleCompose();
+}
+
+void EffectCompositor::scheduleCompose()
+{
+    // Mehrere Änderungen innerhalb eines Durchlaufs der Ereignisschleife ergeben einen Frame
+    if (m_composeScheduled) {
+        return;
+    }
+    
+    m_composeScheduled = true;
+    QTimer::singleShot(0, this, &EffectCompositor::compose);
+}
+
+void EffectCompositor::compose()
+{
+    m_composeScheduled = false;
+    
+    // Über dem CPU-Budget nur jeden n-ten Frame mischen; veränderte Ebenen bleiben markiert
+    // und werden im nächsten Durchlauf berechnet. Der letzte Frame einer abklingenden
+    // Animation wird nie ausgelassen
+    if (m_governor && isAnimating()) {
+        int divider = m_governor->getFrameDivider();
+        if (divider > 1 && ++m_skippedFrames < divider) {
+            m_governor->recordFrame(false);
+            return;
+        }
+    }
+    m_skippedFrames = 0;
+    
+    // Unterste veränderte Ebene suchen; alles darunter ist noch gültig
+    int firstDirty = m_baseDirty ? 0 : m_layers.size();
+    for (int i = 0; i < m_layers.size(); ++i) {
+        if (m_layers.at(i)->dirty) {
+            firstDirty = qMin(firstDirty, i);
+            renderLayer(m_layers.at(i));
+            m_layers.at(i)->dirty = false;
+        }
+    }
+    
+    if (firstDirty >= m_layers.size() && !m_baseDirty) {
+        return;
+    }
+    m_baseDirty = false;
+    
+    for (int i = firstDirty; i < m_layers.size(); ++i) {
+        Layer *layer = m_layers.at(i);
+        const QVector<QRgb> &below = i == 0 ? m_base : m_layers.at(i - 1)->composite;
+        blendLayer(layer->mode, layer->composite.data(), below.constData(), layer->buffer.constData(),
+                   layer->weights.constData(), m_ledCount);
+    }
+    
+    if (m_governor) {
+        m_governor->recordFrame(true);
+    }
+    emit frameComposed(getFrame());
+}
+
+void EffectCompositor::resizeBuffers()
+{
+    for (Layer *layer : m_layers) {
+        if (layer->buffer.size() == m_ledCount) {
+            continue;
+        }
+        
+        layer->buffer.fill(qRgb(0, 0, 0), m_ledCount);
+        layer->composite.fill(qRgb(0, 0, 0), m_ledCount);
+        updateWeights(layer);
+        layer->dirty = true;
+    }
+}
+
+void EffectCompositor::renderLayer(Layer *layer)
+{
+    QRgb *out = layer->buffer.data();
+    
+    if (layer->effect->rendersPerLed()) {
+        const QVector<QVector3D> *positions = m_layout ? &m_layout->normalizedPositions(m_deviceId) : nullptr;
+        bool placed = positions && positions->size() == m_ledCount;
+        
+        int step = m_governor ? m_governor->getLedStep() : 1;
+        if (step <= 1 || m_ledCount < step * 2) {
+            layer->effect->renderFrame(out, m_ledCount, placed ? positions->constData() : nullptr);
+            return;
+        }
+        
+        // Über dem CPU-Budget nur jede n-te LED berechnen und auf ihre Nachbarn übertragen
+        int sampledCount = (m_ledCount + step - 1) / step;
+        m_sampledFrame.resize(sampledCount);
+        const QVector3D *sampledPositions = nullptr;
+        if (placed) {
+            m_sampledPositions.resize(sampledCount);
+            for (int i = 0; i < sampledCount; ++i) {
+                m_sampledPositions[i] = positions->at(i * step);
+            }
+            sampledPositions = m_sampledPositions.constData();
+        }
+        layer->effect->renderFrame(m_sampledFrame.data(), sampledCount, sampledPositions);
+        
+        const QRgb *sampled = m_sampledFrame.constData();
+        for (int led = 0; led < m_ledCount; ++led) {
+            out[led] = sampled[led / step];
+        }
+        return;
+    }
+    
+    if (layer->spatial && m_layout && m_layout->containsDevice(m_deviceId)) {
+        const QVector<quint8> &phases = m_layout->phaseTable(m_deviceId, layer->direction, layer->periods, &layer->phases);
+        if (phases.size() == m_ledCount) {
+            layer->effect->renderPalette(m_palette.data(), m_palette.size());
+            const QRgb *palette = m_palette.constData();
+            for (int led = 0; led < m_ledCount; ++led) {
+                out[led] = palette[phases[led]];
+            }
+            return;
+        }
+    }
+    
+    std::fill(out, out + m_ledCount, layer->effect->getCurrentColor().rgb());
+}
+
+void EffectCompositor::updateWeights(Layer *layer)
+{
+    // Gewicht je LED auf alle vier Bytes verteilen; der Alphakanal bleibt dabei
+    // unverändert, da Basis und Ebenen immer voll deckend sind
+    layer->weights.resize(m_ledCount * 4);
+    quint8 *weights = layer->weights.data();
+    const int maskSize = layer->mask.size();
+    
+    for (int led = 0; led < m_ledCount; ++led) {
+        quint8 weight = led < maskSize
+            ? quint8(div255(unsigned(layer->opacity) * layer->mask.at(led)))
+            : layer->opacity;
+        std::memset(weights + led * 4, weight, 4);
+    }
+}
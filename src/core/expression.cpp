@@ -0,0 +1,534 @@
+#include "core/expression.h"
+#include <QByteArray>
+#include <QLocale>
+#include <QtMath>
+#include <QDebug>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace {
+
+const int MaxRegisters = 1024;
+
+enum OpCode : quint8 {
+    OpAdd, OpSub, OpMul, OpDiv, OpMod, OpPow, OpNeg,
+    OpLess, OpLessEqual, OpGreater, OpGreaterEqual, OpEqual, OpNotEqual, OpSelect,
+    OpSin, OpCos, OpAbs, OpFloor, OpFract, OpSqrt,
+    OpMin, OpMax, OpStep, OpClamp, OpMix
+};
+
+// Anzahl der Operanden einer Operation
+int operandCount(quint8 op)
+{
+    switch (op) {
+    case OpNeg: case OpSin: case OpCos: case OpAbs: case OpFloor: case OpFract: case OpSqrt:
+        return 1;
+    case OpSelect: case OpClamp: case OpMix:
+        return 3;
+    default:
+        return 2;
+    }
+}
+
+// Wendet eine Operation auf einen ganzen Block an; feste Länge, damit der Compiler vektorisiert
+template <typename F>
+inline void lanes(float *d, const float *a, const float *b, const float *c, F f)
+{
+    for (int lane = 0; lane < ExpressionProgram::BatchSize; ++lane) {
+        d[lane] = f(a[lane], b[lane], c[lane]);
+    }
+}
+
+void execute(quint8 op, float *d, const float *a, const float *b, const float *c)
+{
+    switch (op) {
+    case OpAdd:          lanes(d, a, b, c, [](float x, float y, float) { return x + y; }); break;
+    case OpSub:          lanes(d, a, b, c, [](float x, float y, float) { return x - y; }); break;
+    case OpMul:          lanes(d, a, b, c, [](float x, float y, float) { return x * y; }); break;
+    case OpDiv:          lanes(d, a, b, c, [](float x, float y, float) { return y != 0.0f ? x / y : 0.0f; }); break;
+    case OpMod:          lanes(d, a, b, c, [](float x, float y, float) { return y != 0.0f ? x - y * std::floor(x / y) : 0.0f; }); break;
+    case OpPow:          lanes(d, a, b, c, [](float x, float y, float) { return std::pow(x, y); }); break;
+    case OpNeg:          lanes(d, a, b, c, [](float x, float, float) { return -x; }); break;
+    case OpLess:         lanes(d, a, b, c, [](float x, float y, float) { return x < y ? 1.0f : 0.0f; }); break;
+    case OpLessEqual:    lanes(d, a, b, c, [](float x, float y, float) { return x <= y ? 1.0f : 0.0f; }); break;
+    case OpGreater:      lanes(d, a, b, c, [](float x, float y, float) { return x > y ? 1.0f : 0.0f; }); break;
+    case OpGreaterEqual: lanes(d, a, b, c, [](float x, float y, float) { return x >= y ? 1.0f : 0.0f; }); break;
+    case OpEqual:        lanes(d, a, b, c, [](float x, float y, float) { return x == y ? 1.0f : 0.0f; }); break;
+    case OpNotEqual:     lanes(d, a, b, c, [](float x, float y, float) { return x != y ? 1.0f : 0.0f; }); break;
+    case OpSelect:       lanes(d, a, b, c, [](float x, float y, float z) { return x != 0.0f ? y : z; }); break;
+    case OpSin:          lanes(d, a, b, c, [](float x, float, float) { return std::sin(x); }); break;
+    case OpCos:          lanes(d, a, b, c, [](float x, float, float) { return std::cos(x); }); break;
+    case OpAbs:          lanes(d, a, b, c, [](float x, float, float) { return std::fabs(x); }); break;
+    case OpFloor:        lanes(d, a, b, c, [](float x, float, float) { return std::floor(x); }); break;
+    case OpFract:        lanes(d, a, b, c, [](float x, float, float) { return x - std::floor(x); }); break;
+    case OpSqrt:         lanes(d, a, b, c, [](float x, float, float) { return x > 0.0f ? std::sqrt(x) : 0.0f; }); break;
+    case OpMin:          lanes(d, a, b, c, [](float x, float y, float) { return std::min(x, y); }); break;
+    case OpMax:          lanes(d, a, b, c, [](float x, float y, float) { return std::max(x, y); }); break;
+    case OpStep:         lanes(d, a, b, c, [](float x, float y, float) { return y >= x ? 1.0f : 0.0f; }); break;
+    case OpClamp:        lanes(d, a, b, c, [](float x, float y, float z) { return std::min(std::max(x, y), z); }); break;
+    case OpMix:          lanes(d, a, b, c, [](float x, float y, float z) { return x + (y - x) * z; }); break;
+    default: break;
+    }
+}
+
+/**
+ * Rekursiver Abstieg über den Quelltext, erzeugt direkt Registercode.
+ * Operationen mit ausschließlich konstanten Operanden werden beim Übersetzen ausgerechnet.
+ */
+class Compiler
+{
+public:
+    Compiler()
+        : m_registerCount(ExpressionProgram::VariableCount)
+        , m_source(nullptr)
+        , m_pos(0)
+    {
+    }
+
+    bool compileExpression(const QString &expression, quint16 *result, QString *errorMessage)
+    {
+        QByteArray source = expression.toUtf8();
+        m_source = source.constData();
+        m_pos = 0;
+        m_error.clear();
+
+        int reg = parseTernary();
+        skipWhitespace();
+        if (reg >= 0 && m_source[m_pos] != '\0') {
+            fail(QString("Unerwartetes Zeichen '%1'").arg(QChar(m_source[m_pos])));
+            reg = -1;
+        }
+
+        m_source = nullptr;
+        if (reg < 0) {
+            if (errorMessage) {
+                *errorMessage = m_error;
+            }
+            return false;
+        }
+
+        *result = quint16(reg);
+        return true;
+    }
+
+    std::vector<ExpressionProgram::Instruction> instructions;
+    std::vector<std::pair<quint16, float>> constants;
+    int registerCount() const { return m_registerCount; }
+
+private:
+    int fail(const QString &message)
+    {
+        if (m_error.isEmpty()) {
+            m_error = QString("%1 (Position %2)").arg(message).arg(m_pos + 1);
+        }
+        return -1;
+    }
+
+    void skipWhitespace()
+    {
+        while (m_source[m_pos] == ' ' || m_source[m_pos] == '\t' || m_source[m_pos] == '\n' || m_source[m_pos] == '\r') {
+            ++m_pos;
+        }
+    }
+
+    bool accept(const char *token)
+    {
+        skipWhitespace();
+        int length = int(std::strlen(token));
+        if (std::strncmp(m_source + m_pos, token, length) != 0) {
+            return false;
+        }
+        m_pos += length;
+        return true;
+    }
+
+    bool isConstant(int reg, float *value) const
+    {
+        for (const auto &constant : constants) {
+            if (constant.first == reg) {
+                *value = constant.second;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    int constant(float value)
+    {
+        for (const auto &existing : constants) {
+            if (existing.second == value) {
+                return existing.first;
+            }
+        }
+
+        if (m_registerCount >= MaxRegisters) {
+            return fail("Ausdruck zu komplex");
+        }
+
+        int reg = m_registerCount++;
+        constants.emplace_back(quint16(reg), value);
+        return reg;
+    }
+
+    int emit(OpCode op, int a, int b = 0, int c = 0)
+    {
+        if (a < 0 || b < 0 || c < 0) {
+            return -1;
+        }
+
+        // Konstantenfaltung: Ergebnis direkt ausrechnen statt einen Befehl zu erzeugen
+        const int operands = operandCount(op);
+        float va = 0.0f, vb = 0.0f, vc = 0.0f;
+        if (isConstant(a, &va) && (operands < 2 || isConstant(b, &vb)) && (operands < 3 || isConstant(c, &vc))) {
+            float in[3][ExpressionProgram::BatchSize];
+            float out[ExpressionProgram::BatchSize];
+            std::fill(in[0], in[0] + ExpressionProgram::BatchSize, va);
+            std::fill(in[1], in[1] + ExpressionProgram::BatchSize, vb);
+            std::fill(in[2], in[2] + ExpressionProgram::BatchSize, vc);
+            execute(op, out, in[0], in[1], in[2]);
+            return constant(out[0]);
+        }
+
+        if (m_registerCount >= MaxRegisters) {
+            return fail("Ausdruck zu komplex");
+        }
+
+        int dst = m_registerCount++;
+        instructions.push_back({op, quint16(dst), quint16(a), quint16(b), quint16(c)});
+        return dst;
+    }
+
+    int parseTernary()
+    {
+        int condition = parseComparison();
+        if (condition < 0 || !accept("?")) {
+            return condition;
+        }
+
+        int whenTrue = parseTernary();
+        if (whenTrue < 0) {
+            return -1;
+        }
+        if (!accept(":")) {
+            return fail("':' erwartet");
+        }
+        int whenFalse = parseTernary();
+        return emit(OpSelect, condition, whenTrue, whenFalse);
+    }
+
+    int parseComparison()
+    {
+        int left = parseAdditive();
+        if (left < 0) {
+            return -1;
+        }
+
+        // Zweizeichen-Operatoren zuerst prüfen
+        if (accept("<=")) return emit(OpLessEqual, left, parseAdditive());
+        if (accept(">=")) return emit(OpGreaterEqual, left, parseAdditive());
+        if (accept("==")) return emit(OpEqual, left, parseAdditive());
+        if (accept("!=")) return emit(OpNotEqual, left, parseAdditive());
+        if (accept("<")) return emit(OpLess, left, parseAdditive());
+        if (accept(">")) return emit(OpGreater, left, parseAdditive());
+
+        return left;
+    }
+
+    int parseAdditive()
+    {
+        int left = parseTerm();
+        while (left >= 0) {
+            if (accept("+")) {
+                left = emit(OpAdd, left, parseTerm());
+            } else if (accept("-")) {
+                left = emit(OpSub, left, parseTerm());
+            } else {
+                break;
+            }
+        }
+        return left;
+    }
+
+    int parseTerm()
+    {
+        int left = parseUnary();
+        while (left >= 0) {
+            if (accept("*")) {
+                left = emit(OpMul, left, parseUnary());
+            } else if (accept("/")) {
+                left = emit(OpDiv, left, parseUnary());
+            } else if (accept("%")) {
+                left = emit(OpMod, left, parseUnary());
+            } else {
+                break;
+            }
+        }
+        return left;
+    }
+
+    int parseUnary()
+    {
+        if (accept("-")) {
+            return emit(OpNeg, parseUnary());
+        }
+        if (accept("+")) {
+            return parseUnary();
+        }
+        return parsePower();
+    }
+
+    int parsePower()
+    {
+        int base = parsePrimary();
+        if (base >= 0 && accept("^")) {
+            return emit(OpPow, base, parseUnary());
+        }
+        return base;
+    }
+
+    int parsePrimary()
+    {
+        skipWhitespace();
+        char ch = m_source[m_pos];
+
+        if (accept("(")) {
+            int inner = parseTernary();
+            if (inner >= 0 && !accept(")")) {
+                return fail("')' erwartet");
+            }
+            return inner;
+        }
+
+        if ((ch >= '0' && ch <= '9') || ch == '.') {
+            // Zahl selbst abgrenzen und unabhängig vom Gebietsschema einlesen,
+            // damit "0.5" auch unter deutscher Locale gilt
+            int start = m_pos;
+            while ((m_source[m_pos] >= '0' && m_source[m_pos] <= '9') || m_source[m_pos] == '.') {
+                ++m_pos;
+            }
+            if (m_source[m_pos] == 'e' || m_source[m_pos] == 'E') {
+                int exponent = m_pos + 1;
+                if (m_source[exponent] == '+' || m_source[exponent] == '-') {
+                    ++exponent;
+                }
+                if (m_source[exponent] >= '0' && m_source[exponent] <= '9') {
+                    m_pos = exponent;
+                    while (m_source[m_pos] >= '0' && m_source[m_pos] <= '9') {
+                        ++m_pos;
+                    }
+                }
+            }
+
+            bool ok = false;
+            float value = QLocale::c().toFloat(QString::fromLatin1(m_source + start, m_pos - start), &ok);
+            if (!ok) {
+                return fail("Ungültige Zahl");
+            }
+            return constant(value);
+        }
+
+        if ((ch >= 'a' && ch <= 'z') || (ch >= 'A' && ch <= 'Z') || ch == '_') {
+            int start = m_pos;
+            while ((m_source[m_pos] >= 'a' && m_source[m_pos] <= 'z') || (m_source[m_pos] >= 'A' && m_source[m_pos] <= 'Z')
+                   || (m_source[m_pos] >= '0' && m_source[m_pos] <= '9') || m_source[m_pos] == '_') {
+                ++m_pos;
+            }
+            QString name = QString::fromLatin1(m_source + start, m_pos - start).toLower();
+
+            if (accept("(")) {
+                return parseCall(name);
+            }
+            return variable(name);
+        }
+
+        if (ch == '\0') {
+            return fail("Unerwartetes Ende des Ausdrucks");
+        }
+        return fail(QString("Unerwartetes Zeichen '%1'").arg(QChar(ch)));
+    }
+
+    int variable(const QString &name)
+    {
+        static const struct {
+            const char *name;
+            ExpressionProgram::Variable variable;
+        } variableTable[] = {
+            { "t",   ExpressionProgram::Time },
+            { "i",   ExpressionProgram::LedIndex },
+            { "n",   ExpressionProgram::LedCount },
+            { "x",   ExpressionProgram::PositionX },
+            { "y",   ExpressionProgram::PositionY },
+            { "cpu", ExpressionProgram::CpuTemperature },
+            { "gpu", ExpressionProgram::GpuTemperature }
+        };
+
+        for (const auto &entry : variableTable) {
+            if (name == QLatin1String(entry.name)) {
+                return entry.variable;
+            }
+        }
+
+        if (name == QLatin1String("pi")) {
+            return constant(float(M_PI));
+        }
+
+        return fail(QString("Unbekannte Variable '%1'").arg(name));
+    }
+
+    int parseCall(const QString &name)
+    {
+        static const struct {
+            const char *name;
+            OpCode op;
+            int argumentCount;
+        } functionTable[] = {
+            { "sin",   OpSin,   1 },
+            { "cos",   OpCos,   1 },
+            { "abs",   OpAbs,   1 },
+            { "floor", OpFloor, 1 },
+            { "fract", OpFract, 1 },
+            { "sqrt",  OpSqrt,  1 },
+            { "min",   OpMin,   2 },
+            { "max",   OpMax,   2 },
+            { "pow",   OpPow,   2 },
+            { "step",  OpStep,  2 },
+            { "clamp", OpClamp, 3 },
+            { "mix",   OpMix,   3 }
+        };
+
+        for (const auto &entry : functionTable) {
+            if (name != QLatin1String(entry.name)) {
+                continue;
+            }
+
+            int arguments[3] = {0, 0, 0};
+            for (int index = 0; index < entry.argumentCount; ++index) {
+                if (index > 0 && !accept(",")) {
+                    return fail(QString("%1() erwartet %2 Argumente").arg(name).arg(entry.argumentCount));
+                }
+                arguments[index] = parseTernary();
+                if (arguments[index] < 0) {
+                    return -1;
+                }
+            }
+
+            if (!accept(")")) {
+                return fail(QString("%1() erwartet %2 Argumente").arg(name).arg(entry.argumentCount));
+            }
+
+            return emit(entry.op, arguments[0], arguments[1], arguments[2]);
+        }
+
+        return fail(QString("Unbekannte Funktion '%1'").arg(name));
+    }
+
+private:
+    int m_registerCount;
+    const char *m_source;
+    int m_pos;
+    QString m_error;
+};
+
+} // namespace
+
+ExpressionProgram::ExpressionProgram()
+    : m_scalars(VariableCount, 0.0f)
+{
+}
+
+bool ExpressionProgram::compile(const QStringList &expressions, QString *errorMessage)
+{
+    Compiler compiler;
+    QVector<quint16> outputRegisters;
+
+    for (const QString &expression : expressions) {
+        quint16 reg = 0;
+        QString error;
+        if (!compiler.compileExpression(expression, &reg, &error)) {
+            qWarning() << "Fehler im Ausdruck" << expression << ":" << error;
+            if (errorMessage) {
+                *errorMessage = error;
+            }
+            return false;
+        }
+        outputRegisters.append(reg);
+    }
+
+    m_instructions = compiler.instructions;
+    m_outputRegisters = outputRegisters;
+
+    // Konstanten einmalig in die Registerdatei schreiben
+    m_registers.assign(size_t(compiler.registerCount()) * BatchSize, 0.0f);
+    for (const auto &constant : compiler.constants) {
+        std::fill_n(m_registers.begin() + constant.first * BatchSize, BatchSize, constant.second);
+    }
+
+    return true;
+}
+
+bool ExpressionProgram::isValid() const
+{
+    return !m_outputRegisters.isEmpty();
+}
+
+int ExpressionProgram::getOutputCount() const
+{
+    return m_outputRegisters.size();
+}
+
+int ExpressionProgram::getInstructionCount() const
+{
+    return int(m_instructions.size());
+}
+
+void ExpressionProgram::setVariable(Variable variable, float value)
+{
+    if (variable >= 0 && variable < VariableCount) {
+        m_scalars[variable] = value;
+    }
+}
+
+void ExpressionProgram::evaluate(int ledCount, const float *x, const float *y, float *const *outputs)
+{
+    if (!isValid() || ledCount <= 0) {
+        return;
+    }
+
+    float *registers = m_registers.data();
+    m_scalars[LedCount] = float(ledCount);
+
+    // Skalare Variablen einmal pro Aufruf auf alle Spuren verteilen
+    for (Variable variable : {Time, LedCount, CpuTemperature, GpuTemperature}) {
+        std::fill_n(registers + variable * BatchSize, BatchSize, m_scalars[variable]);
+    }
+
+    const float indexScale = ledCount > 1 ? 1.0f / float(ledCount - 1) : 0.0f;
+    float *index = registers + LedIndex * BatchSize;
+    float *posX = registers + PositionX * BatchSize;
+    float *posY = registers + PositionY * BatchSize;
+
+    for (int first = 0; first < ledCount; first += BatchSize) {
+        const int count = std::min(BatchSize, ledCount - first);
+
+        // Eingänge des Blocks; überzählige Spuren wiederholen die letzte LED
+        for (int lane = 0; lane < BatchSize; ++lane) {
+            int led = first + std::min(lane, count - 1);
+            index[lane] = float(led);
+            posX[lane] = x ? x[led] : float(led) * indexScale;
+            posY[lane] = y ? y[led] : 0.0f;
+        }
+
+        for (const Instruction &instruction : m_instructions) {
+            execute(instruction.op,
+                    registers + instruction.dst * BatchSize,
+                    registers + instruction.a * BatchSize,
+                    registers + instruction.b * BatchSize,
+                    registers + instruction.c * BatchSize);
+        }
+
+        for (int output = 0; output < m_outputRegisters.size(); ++output) {
+            std::copy_n(registers + m_outputRegisters.at(output) * BatchSize, count, outputs[output] + first);
+        }
+    }
+}
@@ -0,0 +1,179 @@
+#include "core/frameencoder.h"
+#include <cstring>
+
+FrameEncoder::FrameEncoder(int encodings)
+    : m_encodings(encodings)
+    , m_valid(false)
+    , m_framesSinceFull(0)
+    , m_encodedSize(0)
+{
+}
+
+int FrameEncoder::getEncodings() const
+{
+    return m_encodings;
+}
+
+bool FrameEncoder::encode(const QVector<QRgb> &frame)
+{
+    int ledCount = frame.size();
+    int fullSize = ledCount * 3;
+    
+    // Puffer behalten ihre Kapazität, im eingeschwungenen Zustand wird nichts allokiert
+    m_update.encoding = LedFrameUpdate::Full;
+    m_update.colors = frame.constData();
+    m_update.ledCount = ledCount;
+    m_update.ranges.clear();
+    m_update.runs.clear();
+    m_encodedSize = fullSize;
+    
+    if (!m_valid || m_acknowledged.size() != ledCount || m_framesSinceFull >= KeyframeInterval) {
+        return true;
+    }
+    
+    // Unveränderte Frames müssen gar nicht übertragen werden
+    if (std::memcmp(frame.constData(), m_acknowledged.constData(), size_t(ledCount) * sizeof(QRgb)) == 0) {
+        m_statistics.unchangedFrames++;
+        m_statistics.rawBytes += quint64(fullSize);
+        m_framesSinceFull++;
+        return false;
+    }
+    
+    if (m_encodings & LedFrameUpdate::DirtyRanges) {
+        int size = encodeRanges(frame, m_encodedSize);
+        if (size < m_encodedSize) {
+            m_update.encoding = LedFrameUpdate::DirtyRanges;
+            m_encodedSize = size;
+        } else {
+            m_update.ranges.clear();
+        }
+    }
+    
+    if (m_encodings & LedFrameUpdate::RunLength) {
+        int size = encodeRuns(frame, m_encodedSize);
+        if (size < m_encodedSize) {
+            m_update.encoding = LedFrameUpdate::RunLength;
+            m_update.ranges.clear();
+            m_encodedSize = size;
+        } else {
+            m_update.runs.clear();
+        }
+    }
+    
+    return true;
+}
+
+const LedFrameUpdate &FrameEncoder::update() const
+{
+    return m_update;
+}
+
+void FrameEncoder::acknowledge(LedFrameUpdate::Encoding sentAs)
+{
+    int ledCount = m_update.ledCount;
+    int fullSize = ledCount * 3;
+    
+    // Bei Teilaktualisierungen genügt es, die geänderten Bereiche zu übernehmen
+    if (sentAs == LedFrameUpdate::DirtyRanges && m_acknowledged.size() == ledCount) {
+        QRgb *target = m_acknowledged.data();
+        for (const LedFrameUpdate::Range &range : m_update.ranges) {
+            std::memcpy(target + range.start, m_update.colors + range.start, size_t(range.count) * sizeof(QRgb));
+        }
+    } else {
+        m_acknowledged.resize(ledCount);
+        std::memcpy(m_acknowledged.data(), m_update.colors, size_t(ledCount) * sizeof(QRgb));
+    }
+    m_valid = true;
+    
+    switch (sentAs) {
+    case LedFrameUpdate::Full:
+        m_statistics.fullFrames++;
+        m_statistics.encodedBytes += quint64(fullSize);
+        m_framesSinceFull = 0;
+        break;
+    case LedFrameUpdate::DirtyRanges:
+        m_statistics.rangeFrames++;
+        m_statistics.encodedBytes += quint64(m_encodedSize);
+        m_framesSinceFull++;
+        break;
+    case LedFrameUpdate::RunLength:
+        m_statistics.runLengthFrames++;
+        m_statistics.encodedBytes += quint64(m_encodedSize);
+        m_framesSinceFull++;
+        break;
+    }
+    m_statistics.rawBytes += quint64(fullSize);
+}
+
+void FrameEncoder::invalidate()
+{
+    m_valid = false;
+}
+
+const FrameEncoder::Statistics &FrameEncoder::statistics() const
+{
+    return m_statistics;
+}
+
+int FrameEncoder::encodeRanges(const QVector<QRgb> &frame, int limit)
+{
+    const QRgb *next = frame.constData();
+    const QRgb *last = m_acknowledged.constData();
+    int ledCount = frame.size();
+    int size = 0;
+    
+    int i = 0;
+    while (i < ledCount) {
+        if (next[i] == last[i]) {
+            ++i;
+            continue;
+        }
+        
+        // Bereich verlängern; kurze unveränderte Lücken sind billiger als ein neuer Kopf
+        int start = i;
+        int end = i + 1;
+        int j = end;
+        while (j < ledCount) {
+            if (next[j] != last[j]) {
+                end = j + 1;
+            } else if ((j + 1 - end) * 3 > RangeOverhead) {
+                break;
+            }
+            ++j;
+        }
+        
+        m_update.ranges.append({start, end - start});
+        size += RangeOverhead + (end - start) * 3;
+        if (size >= limit) {
+            return size;
+        }
+        i = j;
+    }
+    
+    return size;
+}
+
+int FrameEncoder::encodeRuns(const QVector<QRgb> &frame, int limit)
+{
+    const QRgb *next = frame.constData();
+    int ledCount = frame.size();
+    int size = 0;
+    
+    int i = 0;
+    while (i < ledCount) {
+        QRgb color = next[i];
+        int j = i + 1;
+        while (j < ledCount && j - i < MaxRunLength && next[j] == color) {
+            ++j;
+        }
+        
+        m_update.runs.append({j - i, color});
+        size += RunSize;
+        if (size >= limit) {
+            return size;
+        }
+        i = j;
+    }
+    
+    return size;
+}
@@ -0,0 +1,178 @@
+#include "core/framegovernor.h"
+#include <QDebug>
+
+#ifdef Q_OS_WIN
+#include <windows.h>
+#elif defined(Q_OS_UNIX)
+#include <time.h>
+#endif
+
+namespace {
+
+// Bildraten-Teiler, LED-Schritt und Paletten-Schritt je Stufe
+struct Level {
+    int frameDivider;
+    int ledStep;
+    int paletteStep;
+};
+
+const Level levels[FrameGovernor::MaxLevel + 1] = {
+    {1, 1, 1},
+    {2, 1, 1},
+    {2, 2, 2},
+    {3, 2, 4},
+    {4, 4, 4}
+};
+
+} // namespace
+
+FrameGovernor::FrameGovernor(QObject *parent)
+    : QObject(parent)
+    , m_budget(0.0)
+    , m_level(0)
+    , m_quietWindows(0)
+    , m_windowCpuUs(-1)
+    , m_windowFrames(0)
+{
+}
+
+void FrameGovernor::setBudget(double coreFraction)
+{
+    m_budget = qMax(0.0, coreFraction);
+    
+    // Ohne Budget sofort zurück zur vollen Qualität
+    if (m_budget <= 0.0 && m_level != 0) {
+        m_level = 0;
+        m_statistics.levelChanges++;
+        emit levelChanged(m_level, m_statistics.cpuUsage);
+    }
+    m_window.invalidate();
+}
+
+double FrameGovernor::getBudget() const
+{
+    return m_budget;
+}
+
+int FrameGovernor::getLevel() const
+{
+    return m_level;
+}
+
+int FrameGovernor::getFrameDivider() const
+{
+    return levels[m_level].frameDivider;
+}
+
+int FrameGovernor::getLedStep() const
+{
+    return levels[m_level].ledStep;
+}
+
+int FrameGovernor::getPaletteStep() const
+{
+    return levels[m_level].paletteStep;
+}
+
+void FrameGovernor::recordFrame(bool rendered)
+{
+    if (rendered) {
+        m_statistics.renderedFrames++;
+        m_windowFrames++;
+    } else {
+        m_statistics.skippedFrames++;
+    }
+    
+    if (m_budget <= 0.0) {
+        return;
+    }
+    
+    // Das erste Fenster beginnt mit dem ersten Frame, Pausen ohne Frames zählen nicht mit
+    if (!m_window.isValid()) {
+        restartWindow();
+        return;
+    }
+    
+    // Nach einer langen Pause ohne Frames neu beginnen
+    qint64 elapsedUs = m_window.nsecsElapsed() / 1000;
+    if (elapsedUs > 4 * WindowMs * 1000) {
+        restartWindow();
+        return;
+    }
+    
+    if (elapsedUs >= WindowMs * 1000) {
+        evaluate(elapsedUs);
+        restartWindow();
+    }
+}
+
+const FrameGovernor::Statistics &FrameGovernor::getStatistics() const
+{
+    return m_statistics;
+}
+
+qint64 FrameGovernor::processCpuTimeUs()
+{
+#ifdef Q_OS_WIN
+    FILETIME creation, exitTime, kernel, user;
+    if (!GetProcessTimes(GetCurrentProcess(), &creation, &exitTime, &kernel, &user)) {
+        return -1;
+    }
+    quint64 kernelTime = (quint64(kernel.dwHighDateTime) << 32) | kernel.dwLowDateTime;
+    quint64 userTime = (quint64(user.dwHighDateTime) << 32) | user.dwLowDateTime;
+    return qint64((kernelTime + userTime) / 10);
+#elif defined(Q_OS_UNIX)
+    timespec time;
+    if (clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &time) != 0) {
+        return -1;
+    }
+    return qint64(time.tv_sec) * 1000000 + time.tv_nsec / 1000;
+#else
+    return -1;
+#endif
+}
+
+void FrameGovernor::evaluate(qint64 elapsedUs)
+{
+    qint64 cpuUs = processCpuTimeUs();
+    if (cpuUs < 0 || m_windowCpuUs < 0 || elapsedUs <= 0) {
+        return;
+    }
+    
+    qint64 usedUs = cpuUs - m_windowCpuUs;
+    double usage = double(usedUs) / double(elapsedUs);
+    m_statistics.windows++;
+    m_statistics.cpuUsage = usage;
+    m_statistics.cpuPerFrameUs = m_windowFrames > 0 ? qint64(usedUs / qint64(m_windowFrames)) : 0;
+    
+    int level = m_level;
+    if (usage > m_budget) {
+        // Über dem Budget: sofort eine Stufe herunter
+        m_statistics.overBudgetWindows++;
+        m_quietWindows = 0;
+        level = qMin(m_level + 1, int(MaxLevel));
+    } else if (usage < m_budget * RampUpThreshold) {
+        // Erst nach mehreren ruhigen Fenstern wieder herauf, damit die Stufe nicht pendelt
+        if (++m_quietWindows >= RampUpWindows) {
+            m_quietWindows = 0;
+            level = qMax(m_level - 1, 0);
+        }
+    } else {
+        m_quietWindows = 0;
+    }
+    
+    if (level != m_level) {
+        m_level = level;
+        m_statistics.levelChanges++;
+        qDebug() << "CPU-Anteil" << qRound(usage * 1000.0) / 10.0 << "% bei Budget"
+                 << qRound(m_budget * 1000.0) / 10.0 << "%, Qualitätsstufe" << level;
+        emit levelChanged(level, usage);
+    }
+}
+
+void FrameGovernor::restartWindow()
+{
+    m_window.start();
+    m_windowCpuUs = processCpuTimeUs();
+    m_windowFrames = 0;
+}
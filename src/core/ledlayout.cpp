@@ -0,0 +1,198 @@
+#include "core/ledlayout.h"
+#include <QJsonArray>
+#include <QtMath>
+#include <QDebug>
+
+LedLayout::LedLayout(QObject *parent)
+    : QObject(parent)
+    , m_revision(1)
+{
+}
+
+void LedLayout::placeDevice(const QString &deviceId, int ledCount, const QVector3D &origin, const QVector3D &ledSpacing)
+{
+    QVector<QVector3D> positions;
+    positions.reserve(ledCount);
+    for (int led = 0; led < ledCount; ++led) {
+        positions.append(origin + ledSpacing * float(led));
+    }
+    
+    placeDeviceLeds(deviceId, positions);
+}
+
+void LedLayout::placeDeviceLeds(const QString &deviceId, const QVector<QVector3D> &ledPositions)
+{
+    m_ledPositions.insert(deviceId, ledPositions);
+    invalidate();
+}
+
+void LedLayout::removeDevice(const QString &deviceId)
+{
+    if (m_ledPositions.remove(deviceId) > 0) {
+        invalidate();
+    }
+}
+
+bool LedLayout::containsDevice(const QString &deviceId) const
+{
+    return m_ledPositions.contains(deviceId);
+}
+
+QStringList LedLayout::getDeviceIds() const
+{
+    return m_ledPositions.keys();
+}
+
+QVector<QVector3D> LedLayout::getLedPositions(const QString &deviceId) const
+{
+    return m_ledPositions.value(deviceId);
+}
+
+const QVector<QVector3D> &LedLayout::normalizedPositions(const QString &deviceId)
+{
+    static const QVector<QVector3D> emptyPositions;
+    
+    auto positions = m_ledPositions.constFind(deviceId);
+    if (positions == m_ledPositions.constEnd()) {
+        return emptyPositions;
+    }
+    
+    auto cached = m_normalizedPositions.constFind(deviceId);
+    if (cached != m_normalizedPositions.constEnd()) {
+        return cached.value();
+    }
+    
+    // Begrenzungsrahmen aller Geräte
+    QVector3D minimum;
+    QVector3D maximum;
+    bool first = true;
+    for (const QVector<QVector3D> &devicePositions : m_ledPositions) {
+        for (const QVector3D &position : devicePositions) {
+            if (first) {
+                minimum = maximum = position;
+                first = false;
+                continue;
+            }
+            minimum = QVector3D(qMin(minimum.x(), position.x()), qMin(minimum.y(), position.y()), qMin(minimum.z(), position.z()));
+            maximum = QVector3D(qMax(maximum.x(), position.x()), qMax(maximum.y(), position.y()), qMax(maximum.z(), position.z()));
+        }
+    }
+    
+    QVector3D extent = maximum - minimum;
+    QVector3D scale(extent.x() > 0.0f ? 1.0f / extent.x() : 0.0f,
+                    extent.y() > 0.0f ? 1.0f / extent.y() : 0.0f,
+                    extent.z() > 0.0f ? 1.0f / extent.z() : 0.0f);
+    
+    QVector<QVector3D> normalized;
+    normalized.reserve(positions->size());
+    for (const QVector3D &position : *positions) {
+        normalized.append((position - minimum) * scale);
+    }
+    
+    return m_normalizedPositions.insert(deviceId, normalized).value();
+}
+
+const QVector<quint8> &LedLayout::phaseTable(const QString &deviceId, const QVector3D &direction, qreal periods,
+                                             PhaseTable *table) const
+{
+    if (table->revision == m_revision && table->direction == direction && table->periods == periods) {
+        return table->phases;
+    }
+    
+    table->revision = m_revision;
+    table->direction = direction;
+    table->periods = periods;
+    
+    auto positions = m_ledPositions.constFind(deviceId);
+    if (positions == m_ledPositions.constEnd()) {
+        table->phases.clear();
+        return table->phases;
+    }
+    
+    // Ausdehnung des gesamten Layouts entlang der Richtung
+    QVector3D axis = direction.normalized();
+    float minProjection = 0.0f;
+    float maxProjection = 0.0f;
+    bool first = true;
+    for (const QVector<QVector3D> &devicePositions : m_ledPositions) {
+        for (const QVector3D &position : devicePositions) {
+            float projection = QVector3D::dotProduct(position, axis);
+            if (first || projection < minProjection) minProjection = projection;
+            if (first || projection > maxProjection) maxProjection = projection;
+            first = false;
+        }
+    }
+    
+    float extent = maxProjection - minProjection;
+    float scale = extent > 0.0f ? float(periods) / extent : 0.0f;
+    
+    table->phases.resize(positions->size());
+    quint8 *phases = table->phases.data();
+    for (int led = 0; led < positions->size(); ++led) {
+        float phase = (QVector3D::dotProduct(positions->at(led), axis) - minProjection) * scale;
+        phase -= std::floor(phase);
+        phases[led] = quint8(qMin(255, int(phase * 256.0f)));
+    }
+    
+    return table->phases;
+}
+
+quint64 LedLayout::getRevision() const
+{
+    return m_revision;
+}
+
+QJsonObject LedLayout::toJson() const
+{
+    QJsonArray devicesArray;
+    
+    for (auto it = m_ledPositions.cbegin(); it != m_ledPositions.cend(); ++it) {
+        QJsonArray ledsArray;
+        for (const QVector3D &position : it.value()) {
+            ledsArray.append(QJsonArray{position.x(), position.y(), position.z()});
+        }
+        
+        QJsonObject deviceObj;
+        deviceObj["id"] = it.key();
+        deviceObj["leds"] = ledsArray;
+        devicesArray.append(deviceObj);
+    }
+    
+    QJsonObject root;
+    root["devices"] = devicesArray;
+    return root;
+}
+
+bool LedLayout::fromJson(const QJsonObject &json)
+{
+    if (!json.contains("devices")) {
+        return false;
+    }
+    
+    m_ledPositions.clear();
+    
+    for (const QJsonValue &deviceValue : json["devices"].toArray()) {
+        QJsonObject deviceObj = deviceValue.toObject();
+        
+        QVector<QVector3D> positions;
+        for (const QJsonValue &ledValue : deviceObj["leds"].toArray()) {
+            QJsonArray coords = ledValue.toArray();
+            positions.append(QVector3D(float(coords.at(0).toDouble()),
+                                       float(coords.at(1).toDouble()),
+                                       float(coords.at(2).toDouble())));
+        }
+        
+        m_ledPositions.insert(deviceObj["id"].toString(), positions);
+    }
+    
+    invalidate();
+    return true;
+}
+
+void LedLayout::invalidate()
+{
+    m_normalizedPositions.clear();
+    m_revision++;
+    
+    emit layoutChanged();
+}
@@ -0,0 +1,323 @@
+#include "core/outputscheduler.h"
+#include <QTimer>
+#include <QDebug>
+#include <algorithm>
+
+OutputScheduler::OutputScheduler(QObject *parent)
+    : QObject(parent)
+    , m_timer(new QTimer(this))
+    , m_latencyCompensation(true)
+    , m_presentationDelayUs(0)
+{
+    m_timer->setSingleShot(true);
+    m_timer->setTimerType(Qt::PreciseTimer);
+    connect(m_timer, &QTimer::timeout, this, &OutputScheduler::processDue);
+    
+    m_clock.start();
+}
+
+void OutputScheduler::addDevice(IRGBDevice *device)
+{
+    if (!device || m_slots.contains(device)) {
+        return;
+    }
+    
+    Slot slot;
+    int maxFrameRate = device->getMaxFrameRate();
+    slot.minIntervalUs = maxFrameRate > 0 ? 1000000 / maxFrameRate : 0;
+    slot.latencyUs = qMax(0, device->getOutputLatencyUs());
+    slot.lastWriteUs = now() - slot.minIntervalUs;
+    m_slots.insert(device, slot);
+    updatePresentationDelay();
+    
+    if (maxFrameRate > 0 || slot.latencyUs > 0) {
+        qDebug() << "Ausgabe an" << device->getDisplayName() << "begrenzt auf" << maxFrameRate
+                 << "FPS, Latenz" << slot.latencyUs << "us";
+    }
+}
+
+void OutputScheduler::removeDevice(IRGBDevice *device)
+{
+    m_slots.remove(device);
+    m_pending.removeAll(device);
+    m_queued.removeAll(device);
+    updatePresentationDelay();
+    armTimer();
+}
+
+void OutputScheduler::setOutputLatency(IRGBDevice *device, int latencyUs)
+{
+    auto it = m_slots.find(device);
+    if (it == m_slots.end()) {
+        return;
+    }
+    
+    it->latencyUs = qMax(0, latencyUs);
+    updatePresentationDelay();
+}
+
+void OutputScheduler::setLatencyCompensationEnabled(bool enabled)
+{
+    m_latencyCompensation = enabled;
+    updatePresentationDelay();
+}
+
+bool OutputScheduler::isLatencyCompensationEnabled() const
+{
+    return m_latencyCompensation;
+}
+
+qint64 OutputScheduler::getPresentationDelayUs() const
+{
+    return m_presentationDelayUs;
+}
+
+qint64 OutputScheduler::presentationTime() const
+{
+    return now() + m_presentationDelayUs;
+}
+
+bool OutputScheduler::isDeferred(IRGBDevice *device) const
+{
+    auto it = m_slots.constFind(device);
+    if (it == m_slots.constEnd()) {
+        return false;
+    }
+    return it->minIntervalUs > 0 || (m_latencyCompensation && it->latencyUs < m_presentationDelayUs);
+}
+
+bool OutputScheduler::submit(IRGBDevice *device, const QVector<QRgb> &frame, qint64 presentationUs)
+{
+    auto it = m_slots.find(device);
+    if (it == m_slots.end()) {
+        return true;
+    }
+    
+    Slot &slot = it.value();
+    slot.statistics.submittedFrames++;
+    qint64 time = now();
+    
+    // Schnellere Geräte warten, bis der Frame auch auf dem langsamsten erscheint
+    if (m_latencyCompensation) {
+        if (presentationUs < 0) {
+            presentationUs = time + m_presentationDelayUs;
+        }
+        qint64 writeUs = presentationUs - slot.latencyUs;
+        if (writeUs > time) {
+            enqueue(slot, frame, writeUs, time);
+            if (!m_queued.contains(device)) {
+                m_queued.append(device);
+            }
+            armTimer();
+            return false;
+        }
+    }
+    
+    // Ein jetzt fälliger Frame überholt alles, was noch im Vorlauf wartet
+    if (slot.queueSize > 0) {
+        slot.statistics.coalescedFrames += quint64(slot.queueSize);
+        slot.queueSize = 0;
+        m_queued.removeAll(device);
+    }
+    
+    if (dispatch(slot, device, time)) {
+        return true;
+    }
+    
+    // Zurückhalten, ohne neu zu allokieren
+    slot.frame.resize(frame.size());
+    std::copy(frame.constBegin(), frame.constEnd(), slot.frame.begin());
+    armTimer();
+    return false;
+}
+
+OutputScheduler::Statistics OutputScheduler::getStatistics(IRGBDevice *device) const
+{
+    return m_slots.value(device).statistics;
+}
+
+int OutputScheduler::getPendingCount() const
+{
+    return m_pending.size();
+}
+
+void OutputScheduler::processDue()
+{
+    qint64 time = now();
+    
+    // Fällige Vorlauf-Frames übernehmen; sind mehrere fällig, zählt nur der neueste
+    for (int i = 0; i < m_queued.size();) {
+        IRGBDevice *device = m_queued.at(i);
+        Slot &slot = m_slots[device];
+        
+        const int capacity = slot.queue.size();
+        int due = 0;
+        while (due < slot.queueSize
+               && slot.queue[(slot.queueHead + due) % capacity].writeUs <= time) {
+            ++due;
+        }
+        
+        if (due > 0) {
+            QueuedFrame &entry = slot.queue[(slot.queueHead + due - 1) % capacity];
+            slot.statistics.coalescedFrames += quint64(due - 1);
+            
+            // Auch sofort schreibbare Frames laufen über die Fristen, damit gleichzeitig
+            // fällige Geräte in der richtigen Reihenfolge bedient werden
+            if (slot.pending) {
+                slot.statistics.coalescedFrames++;
+            } else {
+                slot.pending = true;
+                m_pending.append(device);
+            }
+            slot.releaseUs = qMax(entry.writeUs, slot.lastWriteUs + slot.minIntervalUs);
+            slot.deadlineUs = entry.writeUs;
+            slot.frame.swap(entry.colors);
+            
+            slot.queueHead = (slot.queueHead + due) % capacity;
+            slot.queueSize -= due;
+        }
+        
+        if (slot.queueSize == 0) {
+            m_queued.removeAt(i);
+        } else {
+            ++i;
+        }
+    }
+    
+    while (!m_pending.isEmpty()) {
+        time = now();
+        
+        // Unter den fälligen Frames den mit der frühesten Frist wählen
+        int next = -1;
+        qint64 nextDeadline = 0;
+        for (int i = 0; i < m_pending.size(); ++i) {
+            const Slot &slot = m_slots[m_pending.at(i)];
+            if (slot.releaseUs <= time && (next < 0 || slot.deadlineUs < nextDeadline)) {
+                next = i;
+                nextDeadline = slot.deadlineUs;
+            }
+        }
+        if (next < 0) {
+            break;
+        }
+        
+        IRGBDevice *device = m_pending.takeAt(next);
+        Slot &slot = m_slots[device];
+        slot.pending = false;
+        slot.lastWriteUs = time;
+        slot.statistics.writtenFrames++;
+        slot.statistics.maxLatenessUs = qMax(slot.statistics.maxLatenessUs, time - slot.releaseUs);
+        
+        emit frameDue(device, slot.frame);
+    }
+    
+    armTimer();
+}
+
+bool OutputScheduler::dispatch(Slot &slot, IRGBDevice *device, qint64 time)
+{
+    // Unbegrenzte Geräte und freie Intervalle: sofort schreiben
+    if (!slot.pending && time >= slot.lastWriteUs + slot.minIntervalUs) {
+        slot.lastWriteUs = time;
+        slot.statistics.writtenFrames++;
+        return true;
+    }
+    
+    // Ein noch wartender Frame wird ersetzt
+    if (slot.pending) {
+        slot.statistics.coalescedFrames++;
+    } else {
+        slot.pending = true;
+        slot.releaseUs = slot.lastWriteUs + slot.minIntervalUs;
+        slot.deadlineUs = slot.releaseUs + slot.minIntervalUs - slot.latencyUs;
+        m_pending.append(device);
+    }
+    return false;
+}
+
+void OutputScheduler::enqueue(Slot &slot, const QVector<QRgb> &frame, qint64 writeUs, qint64 time)
+{
+    if (slot.queue.isEmpty()) {
+        slot.queue.resize(LookaheadDepth);
+    }
+    
+    // Der Vorlauf umfasst mehr Frames als Plätze: Warteschlange vergrößern, damit der
+    // älteste Frame fällig werden kann, bevor er verdrängt würde
+    int capacity = slot.queue.size();
+    if (slot.queueSize == capacity && capacity < MaxLookaheadDepth) {
+        QVector<QueuedFrame> grown(qMin(capacity * 2, int(MaxLookaheadDepth)));
+        for (int i = 0; i < slot.queueSize; ++i) {
+            QueuedFrame &entry = slot.queue[(slot.queueHead + i) % capacity];
+            grown[i].colors.swap(entry.colors);
+            grown[i].writeUs = entry.writeUs;
+        }
+        slot.queue.swap(grown);
+        slot.queueHead = 0;
+        capacity = slot.queue.size();
+    }
+    
+    // Ist der Vorlauf länger, als MaxLookaheadDepth Frames abdecken, werden die Frames
+    // gleichmäßig ausgedünnt: der neueste wartende Frame nimmt neuere auf, bis er einen
+    // Mindestabstand zu seinem Vorgänger hat. Die ältesten Frames bleiben erhalten und
+    // werden pünktlich fällig.
+    qint64 spacingUs = (writeUs - time + MaxLookaheadDepth - 2) / (MaxLookaheadDepth - 1);
+    int newest = (slot.queueHead + slot.queueSize - 1 + capacity) % capacity;
+    int previous = (slot.queueHead + slot.queueSize - 2 + capacity) % capacity;
+    bool collapse = slot.queueSize == capacity
+        || (slot.queueSize >= 2 && slot.queue[newest].writeUs - slot.queue[previous].writeUs < spacingUs);
+    
+    int index = (slot.queueHead + slot.queueSize) % capacity;
+    if (collapse) {
+        index = newest;
+        slot.statistics.overflowFrames++;
+    } else {
+        slot.queueSize++;
+    }
+    
+    QueuedFrame &entry = slot.queue[index];
+    entry.colors.resize(frame.size());
+    std::copy(frame.constBegin(), frame.constEnd(), entry.colors.begin());
+    entry.writeUs = writeUs;
+}
+
+void OutputScheduler::updatePresentationDelay()
+{
+    qint64 delay = 0;
+    if (m_latencyCompensation) {
+        for (const Slot &slot : m_slots) {
+            delay = qMax(delay, slot.latencyUs);
+        }
+    }
+    m_presentationDelayUs = qMin(delay, MaxPresentationDelayUs);
+}
+
+void OutputScheduler::armTimer()
+{
+    bool found = false;
+    qint64 earliest = 0;
+    
+    for (IRGBDevice *device : m_pending) {
+        qint64 release = m_slots[device].releaseUs;
+        earliest = found ? qMin(earliest, release) : release;
+        found = true;
+    }
+    for (IRGBDevice *device : m_queued) {
+        const Slot &slot = m_slots[device];
+        qint64 write = slot.queue[slot.queueHead].writeUs;
+        earliest = found ? qMin(earliest, write) : write;
+        found = true;
+    }
+    
+    if (!found) {
+        m_timer->stop();
+        return;
+    }
+    
+    int delayMs = int(qMax<qint64>(0, (earliest - now() + 999) / 1000));
+    m_timer->start(delayMs);
+}
+
+qint64 OutputScheduler::now() const
+{
+    return m_clock.nsecsElapsed() / 1000;
+}
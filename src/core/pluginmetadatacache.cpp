@@ -0,0 +1,118 @@
+#include "core/pluginmetadatacache.h"
+#include "devices/irgbdeviceplugin.h"
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QPluginLoader>
+#include <QDebug>
+
+PluginMetadataCache::PluginMetadataCache(QObject *parent)
+    : QObject(parent)
+    , m_settings("LuminControl", "LuminControl")
+    , m_dirty(false)
+{
+    load();
+}
+
+PluginMetadataCache::~PluginMetadataCache()
+{
+    save();
+}
+
+QJsonObject PluginMetadataCache::metaData(const QString &filePath)
+{
+    QFileInfo fileInfo(filePath);
+    qint64 lastModified = fileInfo.lastModified().toMSecsSinceEpoch();
+    qint64 size = fileInfo.size();
+
+    auto it = m_entries.constFind(filePath);
+    if (it != m_entries.constEnd() && it->lastModified == lastModified && it->size == size) {
+        return it->metaData;
+    }
+
+    // Metadaten direkt aus der Datei lesen, ohne die Bibliothek zu laden
+    QPluginLoader loader(filePath);
+    QJsonObject metaData = loader.metaData();
+
+    m_entries.insert(filePath, Entry{lastModified, size, metaData});
+    m_dirty = true;
+
+    qDebug() << "Plugin-Metadaten neu gelesen:" << fileInfo.fileName();
+    return metaData;
+}
+
+bool PluginMetadataCache::isDevicePlugin(const QString &filePath)
+{
+    return metaData(filePath).value("IID").toString() == QLatin1String(qobject_interface_iid<IRGBDevicePlugin*>());
+}
+
+bool PluginMetadataCache::isEnabled(const QString &fileName) const
+{
+    return !m_disabledPlugins.contains(fileName);
+}
+
+void PluginMetadataCache::setEnabled(const QString &fileName, bool enabled)
+{
+    if (enabled == isEnabled(fileName)) {
+        return;
+    }
+
+    if (enabled) {
+        m_disabledPlugins.remove(fileName);
+    } else {
+        m_disabledPlugins.insert(fileName);
+    }
+    m_dirty = true;
+}
+
+void PluginMetadataCache::prune(const QStringList &existingPaths)
+{
+    for (auto it = m_entries.begin(); it != m_entries.end();) {
+        if (!existingPaths.contains(it.key())) {
+            it = m_entries.erase(it);
+            m_dirty = true;
+        } else {
+            ++it;
+        }
+    }
+}
+
+void PluginMetadataCache::save()
+{
+    if (!m_dirty) {
+        return;
+    }
+
+    m_settings.remove("pluginCache");
+    m_settings.beginWriteArray("pluginCache", m_entries.size());
+    int index = 0;
+    for (auto it = m_entries.cbegin(); it != m_entries.cend(); ++it, ++index) {
+        m_settings.setArrayIndex(index);
+        m_settings.setValue("path", it.key());
+        m_settings.setValue("lastModified", it->lastModified);
+        m_settings.setValue("size", it->size);
+        m_settings.setValue("metaData", QJsonDocument(it->metaData).toJson(QJsonDocument::Compact));
+    }
+    m_settings.endArray();
+
+    m_settings.setValue("plugins/disabled", QStringList(m_disabledPlugins.begin(), m_disabledPlugins.end()));
+    m_settings.sync();
+
+    m_dirty = false;
+}
+
+void PluginMetadataCache::load()
+{
+    int count = m_settings.beginReadArray("pluginCache");
+    for (int index = 0; index < count; ++index) {
+        m_settings.setArrayIndex(index);
+        Entry entry;
+        entry.lastModified = m_settings.value("lastModified").toLongLong();
+        entry.size = m_settings.value("size").toLongLong();
+        entry.metaData = QJsonDocument::fromJson(m_settings.value("metaData").toByteArray()).object();
+        m_entries.insert(m_settings.value("path").toString(), entry);
+    }
+    m_settings.endArray();
+
+    const QStringList disabled = m_settings.value("plugins/disabled").toStringList();
+    m_disabledPlugins = QSet<QString>(disabled.begin(), disabled.end());
+}
@@ -0,0 +1,240 @@
+#include "core/powerlimiter.h"
+#include <QDebug>
+
+void PowerLimiter::setDeviceBudget(const QString &deviceId, const DeviceBudget &budget)
+{
+    m_devices[deviceId].budget = budget;
+}
+
+void PowerLimiter::removeDeviceBudget(const QString &deviceId)
+{
+    m_devices.remove(deviceId);
+}
+
+PowerLimiter::DeviceBudget PowerLimiter::getDeviceBudget(const QString &deviceId) const
+{
+    return m_devices.value(deviceId).budget;
+}
+
+void PowerLimiter::setRailBudget(const QString &rail, int maxCurrentMa)
+{
+    if (maxCurrentMa <= 0) {
+        m_rails.remove(rail);
+        return;
+    }
+    m_rails.insert(rail, maxCurrentMa);
+}
+
+int PowerLimiter::getRailBudget(const QString &rail) const
+{
+    return m_rails.value(rail, 0);
+}
+
+bool PowerLimiter::isLimited(const QString &deviceId) const
+{
+    return m_devices.contains(deviceId);
+}
+
+bool PowerLimiter::limit(const QString &deviceId, const QVector<QRgb> &frame, QVector<QRgb> &output)
+{
+    auto it = m_devices.find(deviceId);
+    if (it == m_devices.end()) {
+        return false;
+    }
+    
+    int factor = update(it.value(), channelSum(frame.constData(), frame.size()), frame.size());
+    if (factor >= 256) {
+        return false;
+    }
+    
+    output.resize(frame.size());
+    scale(frame.constData(), output.data(), frame.size(), factor);
+    return true;
+}
+
+QRgb PowerLimiter::limit(const QString &deviceId, QRgb color, int ledCount)
+{
+    auto it = m_devices.find(deviceId);
+    if (it == m_devices.end()) {
+        return color;
+    }
+    
+    ledCount = qMax(1, ledCount);
+    quint64 sum = quint64(qRed(color) + qGreen(color) + qBlue(color)) * quint64(ledCount);
+    int factor = update(it.value(), sum, ledCount);
+    if (factor >= 256) {
+        return color;
+    }
+    
+    QRgb limited;
+    scale(&color, &limited, 1, factor);
+    return limited;
+}
+
+void PowerLimiter::resetDevice(const QString &deviceId)
+{
+    auto it = m_devices.find(deviceId);
+    if (it == m_devices.end()) {
+        return;
+    }
+    
+    it->ledCurrentMa = 0;
+    it->idleCurrentMa = 0;
+    it->statistics.scale = 1.0;
+}
+
+PowerLimiter::Statistics PowerLimiter::getStatistics(const QString &deviceId) const
+{
+    return m_devices.value(deviceId).statistics;
+}
+
+QStringList PowerLimiter::getLimitedDeviceIds() const
+{
+    return m_devices.keys();
+}
+
+QJsonObject PowerLimiter::toJson() const
+{
+    QJsonObject railsObj;
+    for (auto it = m_rails.cbegin(); it != m_rails.cend(); ++it) {
+        railsObj[it.key()] = it.value();
+    }
+    
+    QJsonObject devicesObj;
+    for (auto it = m_devices.cbegin(); it != m_devices.cend(); ++it) {
+        const DeviceBudget &budget = it->budget;
+        QJsonObject deviceObj;
+        deviceObj["maxCurrentMa"] = budget.maxCurrentMa;
+        if (!budget.rail.isEmpty()) {
+            deviceObj["rail"] = budget.rail;
+        }
+        deviceObj["channelCurrentMa"] = budget.channelCurrentMa;
+        deviceObj["idleCurrentMa"] = budget.idleCurrentMa;
+        devicesObj[it.key()] = deviceObj;
+    }
+    
+    QJsonObject root;
+    root["rails"] = railsObj;
+    root["devices"] = devicesObj;
+    return root;
+}
+
+bool PowerLimiter::fromJson(const QJsonObject &json)
+{
+    if (!json.contains("devices")) {
+        return false;
+    }
+    
+    m_rails.clear();
+    m_devices.clear();
+    
+    QJsonObject railsObj = json["rails"].toObject();
+    for (auto it = railsObj.constBegin(); it != railsObj.constEnd(); ++it) {
+        setRailBudget(it.key(), it.value().toInt());
+    }
+    
+    QJsonObject devicesObj = json["devices"].toObject();
+    for (auto it = devicesObj.constBegin(); it != devicesObj.constEnd(); ++it) {
+        QJsonObject deviceObj = it.value().toObject();
+        
+        DeviceBudget budget;
+        budget.maxCurrentMa = deviceObj["maxCurrentMa"].toInt(0);
+        budget.rail = deviceObj["rail"].toString();
+        budget.channelCurrentMa = deviceObj["channelCurrentMa"].toDouble(budget.channelCurrentMa);
+        budget.idleCurrentMa = deviceObj["idleCurrentMa"].toDouble(budget.idleCurrentMa);
+        
+        if (budget.maxCurrentMa <= 0 && !m_rails.contains(budget.rail)) {
+            qWarning() << "Strombudget für" << it.key() << "ohne Grenze oder bekannte Schiene, ignoriert";
+            continue;
+        }
+        setDeviceBudget(it.key(), budget);
+    }
+    
+    return true;
+}
+
+quint64 PowerLimiter::channelSum(const QRgb *colors, int count)
+{
+    quint64 total = 0;
+    
+    // Rot und Blau werden gemeinsam in einem Wort addiert; nach höchstens 256 Farben
+    // ist jede Hälfte kleiner als 65536 und wird in die Gesamtsumme übernommen.
+    // Die innere Schleife enthält nur Masken und Additionen und wird vom Compiler vektorisiert.
+    for (int start = 0; start < count; start += 256) {
+        int end = qMin(count, start + 256);
+        quint32 redBlue = 0;
+        quint32 green = 0;
+        for (int i = start; i < end; ++i) {
+            redBlue += colors[i] & 0x00ff00ffu;
+            green += (colors[i] >> 8) & 0xffu;
+        }
+        total += (redBlue & 0xffffu) + (redBlue >> 16) + green;
+    }
+    
+    return total;
+}
+
+int PowerLimiter::update(DeviceState &state, quint64 sum, int ledCount)
+{
+    const DeviceBudget &budget = state.budget;
+    state.ledCurrentMa = double(sum) * budget.channelCurrentMa / 255.0;
+    state.idleCurrentMa = budget.idleCurrentMa * ledCount;
+    
+    // Zielhelligkeit aus dem eigenen Budget
+    double target = 1.0;
+    if (budget.maxCurrentMa > 0 && state.ledCurrentMa > 0) {
+        target = qMin(target, (budget.maxCurrentMa - state.idleCurrentMa) / state.ledCurrentMa);
+    }
+    
+    // Und aus dem Budget der Schiene, gleichmäßig auf alle Geräte der Schiene verteilt
+    int railBudget = budget.rail.isEmpty() ? 0 : m_rails.value(budget.rail, 0);
+    if (railBudget > 0) {
+        double ledCurrent = 0;
+        double idleCurrent = 0;
+        for (const DeviceState &device : m_devices) {
+            if (device.budget.rail == budget.rail) {
+                ledCurrent += device.ledCurrentMa;
+                idleCurrent += device.idleCurrentMa;
+            }
+        }
+        if (ledCurrent > 0) {
+            target = qMin(target, (railBudget - idleCurrent) / ledCurrent);
+        }
+    }
+    target = qBound(0.0, target, 1.0);
+    
+    // Sofort dimmen, langsam erholen
+    Statistics &statistics = state.statistics;
+    if (target < statistics.scale) {
+        statistics.scale = target;
+    } else {
+        statistics.scale += (target - statistics.scale) * ReleaseRate;
+        if (statistics.scale > 0.999) {
+            statistics.scale = target;
+        }
+    }
+    
+    int factor = qBound(0, int(statistics.scale * 256.0), 256);
+    statistics.frames++;
+    statistics.requestedCurrentMa = state.ledCurrentMa + state.idleCurrentMa;
+    statistics.deliveredCurrentMa = state.ledCurrentMa * factor / 256.0 + state.idleCurrentMa;
+    statistics.peakCurrentMa = qMax(statistics.peakCurrentMa, statistics.requestedCurrentMa);
+    if (factor < 256) {
+        statistics.limitedFrames++;
+    }
+    
+    return factor;
+}
+
+void PowerLimiter::scale(const QRgb *source, QRgb *target, int count, int factor)
+{
+    // Rot und Blau in einem Schritt multiplizieren; bei einem Faktor bis 256 bleibt
+    // jedes Produkt innerhalb seiner 16 Bit
+    quint32 f = quint32(factor);
+    for (int i = 0; i < count; ++i) {
+        quint32 color = source[i];
+        quint32 redBlue = (((color & 0x00ff00ffu) * f) >> 8) & 0x00ff00ffu;
+        quint32 green = (((color & 0x0000ff00u) * f) >> 8) & 0x0000ff00u;
+        target[i] = (color & 0xff000000u) | redBlue | green;
+    }
+}
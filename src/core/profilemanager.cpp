@@ -14,6 +14,7 @@ using json = nlohmann::json;
 ProfileManager::ProfileManager(RGBController *rgbController, QObject *parent)
     : QObject(parent)
     , m_rgbController(rgbController)
+    , m_writer(new ProfileWriter(this))
     , m_profilesDir(QDir::current())
     , m_defaultProfilePath(QDir::current().filePath("config/default_profile.txt"))
 {
@@ -28,6 +29,12 @@ ProfileManager::ProfileManager(RGBController *rgbController, QObject *parent)
     if (!configDir.exists("config")) {
         configDir.mkdir("config");
     }
+    
+    // Rückmeldungen des I/O-Threads weiterreichen
+    connect(m_writer, &ProfileWriter::profileWritten, this, &ProfileManager::profileSaved);
+    connect(m_writer, &ProfileWriter::writeFailed, this, [this](const QString &profileName, const QString &errorMessage) {
+        emit error(QString("Fehler beim Speichern des Profils '%1': %2").arg(profileName).arg(errorMessage));
+    });
 }
 
 ProfileManager::~ProfileManager()
@@ -61,6 +68,11 @@ QStringList ProfileManager::getAvailableProfiles() const
 
 bool ProfileManager::loadProfile(const QString &profileName)
 {
+    // Einen ausstehenden oder gerade laufenden Speicherauftrag zuerst abschließen
+    if (m_writer->isPending(profileName)) {
+        m_writer->flush();
+    }
+    
     QString profilePath = getProfilePath(profileName);
     QFile file(profilePath);
     
@@ -107,41 +119,29 @@ bool ProfileManager::saveProfile(const QString &profileName, bool includeTempera
         return false;
     }
     
-    QString profilePath = getProfilePath(profileName);
-    QFile file(profilePath);
+    // Gerätezustände auf dem GUI-Thread erfassen, Serialisierung und Schreiben
+    // übernimmt der I/O-Thread
+    QJsonObject jsonObj = deviceStatesToJson(includeTemperatureRules);
+    m_writer->enqueue(profileName, getProfilePath(profileName), jsonObj);
     
-    if (!file.open(QIODevice::WriteOnly)) {
-        emit error(QString("Fehler beim Erstellen der Profildatei '%1'").arg(profileName));
-        return false;
-    }
-    
-    try {
-        // Gerätezustände in JSON konvertieren
-        QJsonObject jsonObj = deviceStatesToJson(includeTemperatureRules);
-        QJsonDocument doc(jsonObj);
-        
-        // QJsonDocument in nlohmann::json konvertieren
-        json profileJson = json::parse(doc.toJson().toStdString());
-        
-        // In Datei schreiben (mit Einrückung für bessere Lesbarkeit)
-        file.write(QByteArray::fromStdString(profileJson.dump(4)));
-        file.close();
-        
-        emit profileSaved(profileName);
-        return true;
-    } catch (const std::exception &e) {
-        file.close();
-        emit error(QString("Fehler beim Speichern des Profils '%1': %2").arg(profileName).arg(e.what()));
-        return false;
-    }
+    return true;
 }
 
 bool ProfileManager::deleteProfile(const QString &profileName)
 {
+    // Ausstehenden Speicherauftrag verwerfen und laufende Schreibvorgänge abwarten,
+    // damit die Datei nicht nach dem Löschen wieder angelegt wird
+    bool wasPending = m_writer->discard(profileName);
+    m_writer->flush();
+    
     QString profilePath = getProfilePath(profileName);
     QFile file(profilePath);
     
     if (!file.exists()) {
+        if (wasPending) {
+            emit profileDeleted(profileName);
+            return true;
+        }
         emit error(QString("Profil '%1' existiert nicht").arg(profileName));
         return false;
     }
@@ -205,6 +205,11 @@ bool ProfileManager::loadDefaultProfile()
 
 bool ProfileManager::profileExists(const QString &profileName) const
 {
+    // Ein eingereihtes oder gerade geschriebenes Profil gilt bereits als vorhanden
+    if (m_writer->isPending(profileName)) {
+        return true;
+    }
+    
     QString profilePath = getProfilePath(profileName);
     return QFile::exists(profilePath);
 }
@@ -245,13 +250,16 @@ QJsonObject ProfileManager::deviceStatesToJson(bool includeTemperatureRules) con
         colorObj["b"] = color.blue();
         deviceObj["color"] = colorObj;
         
-        // Aktiven Effekt speichern
-        QString effectName = device->getActiveEffect();
+        // Aktiven Effekt als kanonische ID speichern (Software- oder Firmware-Effekt)
+        QString effectName = m_rgbController->getActiveEffectId(device);
+        if (effectName.isEmpty()) {
+            effectName = Effect::canonicalId(device->getActiveEffect());
+        }
         deviceObj["effect"] = effectName;
         
         // Effekt-Parameter speichern (falls vorhanden)
-        if (!effectName.isEmpty() && effectName != "Statisch") {
-            QVariantMap effectParams = device->getEffectParameters();
+        if (!effectName.isEmpty() && effectName != Effect::idFromType(Effect::Static)) {
+            QVariantMap effectParams = m_rgbController->getActiveEffectParameters(device);
             QJsonObject paramsObj;
             
             for (auto it = effectParams.begin(); it != effectParams.end(); ++it) {
@@ -266,6 +274,32 @@ QJsonObject ProfileManager::deviceStatesToJson(bool includeTemperatureRules) con
     
     root["devices"] = devicesArray;
     
+    // Räumliches LED-Layout speichern, falls Geräte platziert sind
+    if (!m_rgbController->getLayout()->getDeviceIds().isEmpty()) {
+        root["layout"] = m_rgbController->getLayout()->toJson();
+    }
+    
+    // Ausgabekalibrierung speichern, falls Geräte kalibriert sind
+    QStringList calibratedIds = m_rgbController->getCalibratedDeviceIds();
+    if (!calibratedIds.isEmpty()) {
+        QJsonObject calibrationObj;
+        for (const QString &deviceId : calibratedIds) {
+            calibrationObj[deviceId] = m_rgbController->getCalibration(deviceId).toJson();
+        }
+        root["calibration"] = calibrationObj;
+    }
+    
+    // Geräte mit zeitlichem Dithering speichern
+    QStringList ditheredIds = m_rgbController->getDitheredDeviceIds();
+    if (!ditheredIds.isEmpty()) {
+        root["dithering"] = QJsonArray::fromStringList(ditheredIds);
+    }
+    
+    // Strombudgets speichern, falls festgelegt
+    if (!m_rgbController->getPowerLimiter()->getLimitedDeviceIds().isEmpty()) {
+        root["power"] = m_rgbController->getPowerLimiter()->toJson();
+    }
+    
     // Temperaturregeln speichern, falls gewünscht
     if (includeTemperatureRules) {
         QJsonObject tempRulesObj;
@@ -284,6 +318,63 @@ bool ProfileManager::applyJsonToDevices(const QJsonObject &json)
     
     QJsonArray devicesArray = json["devices"].toArray();
     
+    // Effekte und Parameter einmalig gegen ihr Schema prüfen, bevor etwas angewendet wird
+    QStringList validationErrors;
+    for (const QJsonValue &deviceValue : devicesArray) {
+        QJsonObject deviceObj = deviceValue.toObject();
+        if (!deviceObj.contains("effect")) {
+            continue;
+        }
+        
+        QString effectName = deviceObj["effect"].toString();
+        if (effectName.isEmpty()) {
+            continue;
+        }
+        
+        Effect::Type type;
+        if (!Effect::typeFromId(effectName, &type)) {
+            validationErrors << QString("Gerät %1: unbekannter Effekt '%2'").arg(deviceObj["id"].toString(), effectName);
+            continue;
+        }
+        
+        QStringList parameterErrors;
+        QVariantMap effectParams = deviceObj["effectParameters"].toObject().toVariantMap();
+        if (!Effect::validateParameters(type, effectParams, &parameterErrors)) {
+            for (const QString &parameterError : parameterErrors) {
+                validationErrors << QString("Gerät %1: %2").arg(deviceObj["id"].toString(), parameterError);
+            }
+        }
+    }
+    
+    if (!validationErrors.isEmpty()) {
+        qWarning() << "Profil ungültig:" << validationErrors;
+        emit error(QString("Ungültiges Profil: %1").arg(validationErrors.join("; ")));
+        return false;
+    }
+    
+    // Layout vor den Effekten anwenden, damit räumliche Effekte es bereits kennen
+    if (json.contains("layout")) {
+        m_rgbController->getLayout()->fromJson(json["layout"].toObject());
+    }
+    
+    // Kalibrierung vor den Farben anwenden, damit schon der erste Frame stimmt
+    if (json.contains("calibration")) {
+        QJsonObject calibrationObj = json["calibration"].toObject();
+        for (auto it = calibrationObj.constBegin(); it != calibrationObj.constEnd(); ++it) {
+            m_rgbController->setCalibration(it.key(), ColorCalibration::fromJson(it.value().toObject()));
+        }
+    }
+    
+    if (json.contains("dithering")) {
+        for (const QJsonValue &deviceValue : json["dithering"].toArray()) {
+            m_rgbController->setDitheringEnabled(deviceValue.toString(), true);
+        }
+    }
+    
+    if (json.contains("power")) {
+        m_rgbController->getPowerLimiter()->fromJson(json["power"].toObject());
+    }
+    
     // Geräte-Informationen anwenden
     for (const QJsonValue &deviceValue : devicesArray) {
         QJsonObject deviceObj = deviceValue.toObject();
@@ -298,19 +389,12 @@ bool ProfileManager::applyJsonToDevices(const QJsonObject &json)
         
         // Effekt anwenden, falls vorhanden
         if (deviceObj.contains("effect")) {
-            QString effectName = deviceObj["effect"].toString();
+            // Ältere Profile enthalten Anzeigenamen ("Atmen"), neuere kanonische IDs
+            QString effectName = Effect::canonicalId(deviceObj["effect"].toString());
             
-            if (!effectName.isEmpty() && effectName != "Statisch") {
-                QVariantMap effectParams;
-                
-                // Effekt-Parameter laden, falls vorhanden
-                if (deviceObj.contains("effectParameters")) {
-                    QJsonObject paramsObj = deviceObj["effectParameters"].toObject();
-                    
-                    for (auto it = paramsObj.begin(); it != paramsObj.end(); ++it) {
-                        effectParams[it.key()] = it.value().toVariant();
-                    }
-                }
+            if (!effectName.isEmpty() && effectName != Effect::idFromType(Effect::Static)) {
+                // Effekt-Parameter laden, falls vorhanden (bereits geprüft)
+                QVariantMap effectParams = deviceObj["effectParameters"].toObject().toVariantMap();
                 
                 m_rgbController->setEffectForDevice(device, effectName, effectParams);
             } else {
@@ -0,0 +1,126 @@
+#include "core/profilewriter.h"
+#include <QSaveFile>
+#include <QJsonDocument>
+#include <QMutexLocker>
+#include <QDebug>
+#include <nlohmann/json.hpp>
+
+using json = nlohmann::json;
+
+ProfileWriter::ProfileWriter(QObject *parent)
+    : QObject(parent)
+    , m_ioContext(new QObject())
+    , m_processScheduled(false)
+{
+    // Alle Schreibvorgänge laufen im Kontext dieses Objekts auf dem I/O-Thread
+    m_ioThread.setObjectName("ProfileWriter");
+    m_ioContext->moveToThread(&m_ioThread);
+    m_ioThread.start(QThread::LowPriority);
+}
+
+ProfileWriter::~ProfileWriter()
+{
+    // Ausstehende Profile noch schreiben, bevor der Thread beendet wird
+    flush();
+
+    m_ioThread.quit();
+    m_ioThread.wait();
+    delete m_ioContext;
+}
+
+void ProfileWriter::enqueue(const QString &profileName, const QString &filePath, const QJsonObject &json)
+{
+    QMutexLocker locker(&m_mutex);
+
+    // Älteren, noch nicht geschriebenen Stand ersetzen
+    m_pending.insert(profileName, PendingWrite{filePath, json});
+
+    if (!m_processScheduled) {
+        m_processScheduled = true;
+        QMetaObject::invokeMethod(m_ioContext, [this]() { processPending(); }, Qt::QueuedConnection);
+    }
+}
+
+bool ProfileWriter::discard(const QString &profileName)
+{
+    QMutexLocker locker(&m_mutex);
+    return m_pending.remove(profileName) > 0;
+}
+
+bool ProfileWriter::isPending(const QString &profileName) const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_pending.contains(profileName) || m_writing.contains(profileName);
+}
+
+void ProfileWriter::flush()
+{
+    if (!m_ioThread.isRunning()) {
+        return;
+    }
+
+    // Läuft nach allen bereits eingereihten Aufträgen und wartet auf deren Abschluss
+    QMetaObject::invokeMethod(m_ioContext, [this]() { processPending(); }, Qt::BlockingQueuedConnection);
+}
+
+void ProfileWriter::processPending()
+{
+    QMap<QString, PendingWrite> batch;
+    {
+        QMutexLocker locker(&m_mutex);
+        batch.swap(m_pending);
+        m_processScheduled = false;
+
+        // Bis zum Abschluss als ausstehend melden, damit Leser auf flush() warten
+        for (auto it = batch.cbegin(); it != batch.cend(); ++it) {
+            m_writing.insert(it.key());
+        }
+    }
+
+    for (auto it = batch.cbegin(); it != batch.cend(); ++it) {
+        QString errorMessage;
+        if (writeAtomically(it.value().filePath, it.value().json, &errorMessage)) {
+            emit profileWritten(it.key());
+        } else {
+            qWarning() << "Profil konnte nicht geschrieben werden:" << it.key() << "-" << errorMessage;
+            emit writeFailed(it.key(), errorMessage);
+        }
+
+        QMutexLocker locker(&m_mutex);
+        m_writing.remove(it.key());
+    }
+}
+
+bool ProfileWriter::writeAtomically(const QString &filePath, const QJsonObject &jsonObj, QString *errorMessage)
+{
+    QByteArray data;
+    try {
+        // QJsonDocument in nlohmann::json konvertieren (mit Einrückung für bessere Lesbarkeit)
+        json profileJson = json::parse(QJsonDocument(jsonObj).toJson().toStdString());
+        data = QByteArray::fromStdString(profileJson.dump(4));
+    } catch (const std::exception &e) {
+        *errorMessage = e.what();
+        return false;
+    }
+
+    // QSaveFile schreibt in eine temporäre Datei im Zielordner und ersetzt die
+    // Profildatei erst nach fsync per rename, die alte Datei bleibt bis dahin intakt
+    QSaveFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        *errorMessage = file.errorString();
+        return false;
+    }
+
+    if (file.write(data) != data.size()) {
+        *errorMessage = file.errorString();
+        file.cancelWriting();
+        return false;
+    }
+
+    if (!file.commit()) {
+        *errorMessage = file.errorString();
+        return false;
+    }
+
+    return true;
+}
@@ -1,21 +1,42 @@
 #include "core/rgbcontroller.h"
 #include <QDebug>
+#include <QtMath>
 
 RGBController::RGBController(QObject *parent)
     : QObject(parent)
-    , m_effectMapper(new QSignalMapper(this))
+    , m_effectAllocations(0)
+    , m_scheduler(new OutputScheduler(this))
+    , m_governor(new FrameGovernor(this))
+    , m_layout(new LedLayout(this))
     , m_temperatureLinkingEnabled(false)
+    , m_idle(true)
     , m_cpuTemperature(0)
     , m_gpuTemperature(0)
 {
-    connect(m_effectMapper, &QSignalMapper::mappedString, this, &RGBController::updateDeviceColor);
+    // Zurückgehaltene Frames langsamer Geräte werden zu ihrer Frist geschrieben
+    connect(m_scheduler, &OutputScheduler::frameDue, this, [this](IRGBDevice *device, const QVector<QRgb> &frame) {
+        transmitFrame(device, frame);
+    });
 }
 
 RGBController::~RGBController()
 {
-    // Alle Effekte löschen
-    qDeleteAll(m_deviceEffects);
-    m_deviceEffects.clear();
+    // Alle Ebenen löschen
+    qDeleteAll(m_compositors);
+    m_compositors.clear();
+    
+    // Alle Effekte löschen, aktive und gepoolte
+    for (EffectGroup *group : m_effectGroups) {
+        destroyEffectGroup(group);
+    }
+    for (const QList<EffectGroup*> &pool : m_groupPool) {
+        for (EffectGroup *group : pool) {
+            destroyEffectGroup(group);
+        }
+    }
+    m_effectGroups.clear();
+    m_groupPool.clear();
+    m_deviceGroups.clear();
 }
 
 void RGBController::registerDevice(IRGBDevice *device)
@@ -24,6 +45,12 @@ void RGBController::registerDevice(IRGBDevice *device)
     
     if (!m_devices.contains(device)) {
         m_devices.append(device);
+        m_scheduler->addDevice(device);
+        
+        // Geräte mit Teilaktualisierungen erhalten einen eigenen Encoder
+        if (device->getSupportedEncodings() != LedFrameUpdate::Full) {
+            m_encoders.insert(device->getId(), FrameEncoder(device->getSupportedEncodings()));
+        }
         qDebug() << "Gerät registriert:" << device->getDisplayName();
     }
 }
@@ -35,12 +62,19 @@ void RGBController::unregisterDevice(IRGBDevice *device)
     if (m_devices.contains(device)) {
         m_devices.removeAll(device);
         
-        // Effekt für das Gerät entfernen
-        QString deviceId = device->getId();
-        if (m_deviceEffects.contains(deviceId)) {
-            delete m_deviceEffects[deviceId];
-            m_deviceEffects.remove(deviceId);
+        // Effekt und Ebenen für das Gerät entfernen
+        removeEffect(device->getId());
+        m_deviceGroups.remove(device->getId());
+        m_solidFrames.remove(device->getId());
+        m_encoders.remove(device->getId());
+        m_outputFrames.remove(device->getId());
+        m_powerLimiter.resetDevice(device->getId());
+        if (m_dithers.contains(device->getId())) {
+            m_dithers[device->getId()].reset();
         }
+        m_ditherTargets.remove(device->getId());
+        m_scheduler->removeDevice(device);
+        delete m_compositors.take(device->getId());
         
         qDebug() << "Gerät entfernt:" << device->getDisplayName();
     }
@@ -68,23 +102,9 @@ bool RGBController::setColorForDevice(IRGBDevice *device, const QColor &color)
         return false;
     }
     
-    bool success = device->setColor(color);
+    bool success = applyColor(device, color);
     
     if (success) {
-        QString deviceId = device->getId();
-        
-        // Wenn ein Effekt aktiv ist, diesen stoppen
-        if (m_deviceEffects.contains(deviceId)) {
-            m_deviceEffects[deviceId]->stop();
-            delete m_deviceEffects[deviceId];
-            m_deviceEffects.remove(deviceId);
-        }
-        
-        // Statischen Effekt erstellen
-        StaticEffect *staticEffect = new StaticEffect(color, this);
-        m_deviceEffects[deviceId] = staticEffect;
-        
-        emit colorChanged(deviceId, color);
         emit actionSuccess(QString("Farbe %1 für Gerät '%2' gesetzt").arg(color.name()).arg(device->getDisplayName()));
     } else {
         emit actionError(QString("Fehler beim Setzen der Farbe für Gerät '%1'").arg(device->getDisplayName()));
@@ -93,6 +113,70 @@ bool RGBController::setColorForDevice(IRGBDevice *device, const QColor &color)
     return success;
 }
 
+bool RGBController::setFrameForDevice(IRGBDevice *device, const QVector<QRgb> &frame)
+{
+    if (!device || !device->isConnected() || frame.isEmpty()) {
+        return false;
+    }
+    
+    // Gestreamte Frames ersetzen einen laufenden Effekt
+    const QString deviceId = device->getId();
+    if (m_deviceGroups.value(deviceId, nullptr) || m_offloadedEffects.contains(deviceId)) {
+        removeEffect(deviceId);
+    }
+    
+    writeDeviceFrame(device, frame);
+    return true;
+}
+
+bool RGBController::applyColor(IRGBDevice *device, const QColor &color)
+{
+    if (!device || !device->isConnected()) {
+        return false;
+    }
+    
+    const QString deviceId = device->getId();
+    EffectCompositor *compositor = m_compositors.value(deviceId, nullptr);
+    EffectGroup *group = m_deviceGroups.value(deviceId, nullptr);
+    
+    // Eigener statischer Effekt: nur umkonfigurieren, bei gleicher Farbe gar nichts tun
+    bool inPlace = group && group->devices.size() == 1 && group->effect->getType() == Effect::Static;
+    if (inPlace && group->effect->getCurrentColor() == color) {
+        return true;
+    }
+    
+    // Mit Ebenen wird die Farbe zur Basis, die Ausgabe übernimmt der Compositor
+    if (!compositor && !outputColor(device, color)) {
+        return false;
+    }
+    
+    if (!inPlace) {
+        // Wenn ein anderer Effekt aktiv ist, diesen stoppen
+        removeEffect(deviceId);
+        
+        group = acquireEffectGroup(Effect::Static);
+        configureGroupLayout(group);
+        bindDevice(group, device);
+        group->effect->start();
+    }
+    
+    // Die Farbe wurde bereits ausgegeben, der Effekt soll sie nicht erneut verteilen
+    {
+        QSignalBlocker blocker(group->effect);
+        static_cast<StaticEffect*>(group->effect)->setParameters(StaticParameters{color});
+    }
+    
+    if (compositor) {
+        compositor->setBaseColor(color);
+    }
+    
+    emit colorChanged(deviceId, color);
+    if (!compositor) {
+        emit frameChanged(deviceId, solidFrame(device, color));
+    }
+    return true;
+}
+
 int RGBController::setColorForDevices(const QList<IRGBDevice*> &devices, const QColor &color)
 {
     int successCount = 0;
@@ -123,73 +207,725 @@ bool RGBController::setEffectForDevice(IRGBDevice *device, const QString &effect
         return false;
     }
     
-    QString deviceId = device->getId();
+    bool success = applyEffect(QList<IRGBDevice*>() << device, effectName, parameters) > 0;
     
-    // Alten Effekt entfernen, falls vorhanden
-    if (m_deviceEffects.contains(deviceId)) {
-        m_deviceEffects[deviceId]->stop();
-        delete m_deviceEffects[deviceId];
-        m_deviceEffects.remove(deviceId);
+    if (success) {
+        emit actionSuccess(QString("Effekt '%1' für Gerät '%2' gesetzt").arg(effectName).arg(device->getDisplayName()));
+    } else {
+        emit actionError(QString("Fehler beim Setzen des Effekts für Gerät '%1'").arg(device->getDisplayName()));
     }
     
-    // Neuen Effekt erstellen
-    Effect *effect = createEffect(effectName, parameters);
-    if (!effect) {
-        emit actionError(QString("Unbekannter Effekt: %1").arg(effectName));
+    return success;
+}
+
+int RGBController::setEffectForDevices(const QList<IRGBDevice*> &devices, const QString &effectName, const QVariantMap &parameters)
+{
+    // Alle Geräte ohne Firmware-Unterstützung teilen sich eine Effektinstanz
+    int successCount = applyEffect(devices, effectName, parameters);
+    
+    if (successCount > 0) {
+        emit actionSuccess(QString("Effekt '%1' für %2 Gerät(e) gesetzt").arg(effectName).arg(successCount));
+    } else if (!devices.isEmpty()) {
+        emit actionError(QString("Fehler beim Setzen des Effekts '%1' für alle Geräte").arg(effectName));
+    }
+    
+    return successCount;
+}
+
+int RGBController::setEffectForAllDevices(const QString &effectName, const QVariantMap &parameters)
+{
+    return setEffectForDevices(m_devices, effectName, parameters);
+}
+
+bool RGBController::setPhaseOffset(IRGBDevice *device, qreal phaseOffset)
+{
+    if (!device) {
         return false;
     }
     
-    // Effekt mit Gerät verbinden
-    connect(effect, &Effect::colorChanged, [this, device](const QColor &color) {
-        device->setColor(color);
-        emit colorChanged(device->getId(), color);
-    });
+    EffectGroup *group = m_deviceGroups.value(device->getId(), nullptr);
+    if (!group) {
+        return false;
+    }
+    
+    phaseOffset -= qFloor(phaseOffset);
+    if (qFuzzyIsNull(phaseOffset)) {
+        group->phaseOffsets.remove(device);
+    } else {
+        group->phaseOffsets[device] = phaseOffset;
+    }
     
-    // Effekt starten
+    return true;
+}
+
+qreal RGBController::getPhaseOffset(IRGBDevice *device) const
+{
+    if (!device) {
+        return 0.0;
+    }
+    
+    EffectGroup *group = m_deviceGroups.value(device->getId(), nullptr);
+    return group ? group->phaseOffsets.value(device, 0.0) : 0.0;
+}
+
+int RGBController::addEffectLayer(IRGBDevice *device, const QString &effectName, const QVariantMap &parameters,
+                                  EffectCompositor::BlendMode mode, qreal opacity)
+{
+    if (!device || !device->isConnected()) {
+        return -1;
+    }
+    
+    Effect::Type type;
+    if (!Effect::typeFromId(effectName, &type)) {
+        emit actionError(QString("Unbekannter Effekt: %1").arg(effectName));
+        return -1;
+    }
+    
+    QString deviceId = device->getId();
+    EffectCompositor *compositor = m_compositors.value(deviceId, nullptr);
+    
+    if (!compositor) {
+        compositor = new EffectCompositor(deviceId, device->getLedCount(), m_layout, this);
+        compositor->setFrameGovernor(m_governor);
+        m_compositors.insert(deviceId, compositor);
+        
+        connect(compositor, &EffectCompositor::frameComposed, this, [this, device, deviceId](const QVector<QRgb> &frame) {
+            outputFrame(device, frame);
+            emit colorChanged(deviceId, QColor::fromRgb(frame.first()));
+            emit frameChanged(deviceId, frame);
+        });
+        
+        // Die Basis muss in Software laufen, damit sie gemischt werden kann
+        if (m_offloadedEffects.contains(deviceId)) {
+            applyEffect(QList<IRGBDevice*>() << device, m_offloadedEffects.value(deviceId), device->getEffectParameters());
+        } else if (EffectGroup *group = m_deviceGroups.value(deviceId, nullptr)) {
+            dispatchGroupColor(group, group->effect->getCurrentColor());
+        }
+    }
+    
+    Effect *effect = Effect::createEffect(type, parameters, compositor);
+    int index = compositor->addLayer(effect, mode, opacity);
+    if (index < 0) {
+        emit actionError(QString("Fehler beim Hinzufügen der Ebene für Gerät '%1'").arg(device->getDisplayName()));
+        return -1;
+    }
     effect->start();
+    updateIdleState();
+    
+    emit actionSuccess(QString("Ebene '%1' für Gerät '%2' hinzugefügt").arg(Effect::nameFromType(type)).arg(device->getDisplayName()));
+    return index;
+}
+
+bool RGBController::removeEffectLayer(IRGBDevice *device, int layerIndex)
+{
+    if (!device) {
+        return false;
+    }
     
-    // Effekt speichern
-    m_deviceEffects[deviceId] = effect;
+    QString deviceId = device->getId();
+    EffectCompositor *compositor = m_compositors.value(deviceId, nullptr);
+    if (!compositor || !compositor->removeLayer(layerIndex)) {
+        return false;
+    }
     
-    // Effekt-Mapper verbinden
-    connect(effect, &Effect::colorChanged, m_effectMapper, [this, deviceId]() {
-        m_effectMapper->setMapping(qobject_cast<QObject*>(sender()), deviceId);
-    });
+    if (compositor->getLayerCount() == 0) {
+        clearEffectLayers(device);
+    }
+    updateIdleState();
     
-    bool success = device->setEffect(effectName, parameters);
+    return true;
+}
+
+bool RGBController::setEffectLayerMask(IRGBDevice *device, int layerIndex, const QVector<quint8> &mask)
+{
+    EffectCompositor *compositor = device ? m_compositors.value(device->getId(), nullptr) : nullptr;
+    return compositor && compositor->setLayerMask(layerIndex, mask);
+}
+
+bool RGBController::setEffectLayerOpacity(IRGBDevice *device, int layerIndex, qreal opacity)
+{
+    EffectCompositor *compositor = device ? m_compositors.value(device->getId(), nullptr) : nullptr;
+    return compositor && compositor->setLayerOpacity(layerIndex, opacity);
+}
+
+void RGBController::clearEffectLayers(IRGBDevice *device)
+{
+    if (!device) {
+        return;
+    }
     
-    if (success) {
-        emit effectChanged(deviceId, effectName);
-        emit actionSuccess(QString("Effekt '%1' für Gerät '%2' gesetzt").arg(effectName).arg(device->getDisplayName()));
-    } else {
-        emit actionError(QString("Fehler beim Setzen des Effekts für Gerät '%1'").arg(device->getDisplayName()));
+    QString deviceId = device->getId();
+    EffectCompositor *compositor = m_compositors.take(deviceId);
+    if (!compositor) {
+        return;
     }
     
-    return success;
+    delete compositor;
+    updateIdleState();
+    
+    EffectGroup *group = m_deviceGroups.value(deviceId, nullptr);
+    if (!group) {
+        return;
+    }
+    
+    // Kann die Firmware die Basis wieder selbst ausführen, wird sie erneut ausgelagert
+    Effect::Type type = group->effect->getType();
+    if (!negotiateHardwareEffect(device, type).isEmpty()) {
+        applyEffect(QList<IRGBDevice*>() << device, Effect::idFromType(type), group->effect->getParameters());
+        return;
+    }
+    
+    // Basis wieder direkt ausgeben
+    dispatchGroupColor(group, group->effect->getCurrentColor());
 }
 
-int RGBController::setEffectForDevices(const QList<IRGBDevice*> &devices, const QString &effectName, const QVariantMap &parameters)
+int RGBController::getEffectLayerCount(IRGBDevice *device) const
+{
+    EffectCompositor *compositor = device ? m_compositors.value(device->getId(), nullptr) : nullptr;
+    return compositor ? compositor->getLayerCount() : 0;
+}
+
+LedLayout* RGBController::getLayout() const
 {
+    return m_layout;
+}
+
+int RGBController::getActiveEffectCount() const
+{
+    return m_effectGroups.size();
+}
+
+quint64 RGBController::getEffectAllocationCount() const
+{
+    return m_effectAllocations;
+}
+
+int RGBController::getPooledEffectCount() const
+{
+    int count = 0;
+    for (const QList<EffectGroup*> &pool : m_groupPool) {
+        count += pool.size();
+    }
+    return count;
+}
+
+int RGBController::getEffectConnectionCount() const
+{
+    // Tatsächlich bestehende Verbindungen zählen, nicht die eigene Buchführung
+    int count = 0;
+    for (EffectGroup *group : m_effectGroups) {
+        count += group->effect->getColorReceiverCount();
+    }
+    for (const QList<EffectGroup*> &pool : m_groupPool) {
+        for (EffectGroup *group : pool) {
+            count += group->effect->getColorReceiverCount();
+        }
+    }
+    return count;
+}
+
+OutputScheduler *RGBController::getOutputScheduler() const
+{
+    return m_scheduler;
+}
+
+void RGBController::setCalibration(const QString &deviceId, const ColorCalibration &calibration)
+{
+    if (calibration.isIdentity()) {
+        m_calibrations.remove(deviceId);
+        m_outputFrames.remove(deviceId);
+        return;
+    }
+    m_calibrations.insert(deviceId, calibration);
+}
+
+ColorCalibration RGBController::getCalibration(const QString &deviceId) const
+{
+    return m_calibrations.value(deviceId);
+}
+
+QStringList RGBController::getCalibratedDeviceIds() const
+{
+    return m_calibrations.keys();
+}
+
+void RGBController::setDitheringEnabled(const QString &deviceId, bool enabled)
+{
+    if (!enabled) {
+        m_dithers.remove(deviceId);
+        m_ditherTargets.remove(deviceId);
+        m_ditherFrames.remove(deviceId);
+        return;
+    }
+    if (!m_dithers.contains(deviceId)) {
+        m_dithers.insert(deviceId, TemporalDither());
+    }
+}
+
+bool RGBController::isDitheringEnabled(const QString &deviceId) const
+{
+    return m_dithers.contains(deviceId);
+}
+
+QStringList RGBController::getDitheredDeviceIds() const
+{
+    return m_dithers.keys();
+}
+
+FrameGovernor *RGBController::getFrameGovernor() const
+{
+    return m_governor;
+}
+
+PowerLimiter *RGBController::getPowerLimiter()
+{
+    return &m_powerLimiter;
+}
+
+FrameEncoder::Statistics RGBController::getEncoderStatistics() const
+{
+    FrameEncoder::Statistics total;
+    for (const FrameEncoder &encoder : m_encoders) {
+        const FrameEncoder::Statistics &statistics = encoder.statistics();
+        total.fullFrames += statistics.fullFrames;
+        total.rangeFrames += statistics.rangeFrames;
+        total.runLengthFrames += statistics.runLengthFrames;
+        total.unchangedFrames += statistics.unchangedFrames;
+        total.encodedBytes += statistics.encodedBytes;
+        total.rawBytes += statistics.rawBytes;
+    }
+    return total;
+}
+
+int RGBController::applyEffect(const QList<IRGBDevice*> &devices, const QString &effectName, const QVariantMap &parameters)
+{
+    Effect::Type type;
+    if (!Effect::typeFromId(effectName, &type)) {
+        emit actionError(QString("Unbekannter Effekt: %1").arg(effectName));
+        return 0;
+    }
+    
+    QString displayName = Effect::nameFromType(type);
+    QList<IRGBDevice*> softwareDevices;
     int successCount = 0;
     
     for (IRGBDevice *device : devices) {
-        if (setEffectForDevice(device, effectName, parameters)) {
-            successCount++;
+        if (!device || !device->isConnected()) {
+            continue;
         }
+        
+        QString deviceId = device->getId();
+        
+        // Kann das Gerät den Effekt selbst ausführen, wird er an die Firmware ausgelagert;
+        // mit Ebenen muss die Basis jedoch in Software laufen
+        QString hardwareEffect = m_compositors.contains(deviceId) ? QString() : negotiateHardwareEffect(device, type);
+        if (!hardwareEffect.isEmpty()) {
+            // Alten Effekt entfernen, falls vorhanden
+            removeEffect(deviceId);
+            
+            if (device->setEffect(hardwareEffect, parameters)) {
+                // Die Firmware verändert die LEDs, der bestätigte Frame gilt nicht mehr
+                if (m_encoders.contains(deviceId)) {
+                    m_encoders[deviceId].invalidate();
+                }
+                m_offloadedEffects[deviceId] = Effect::idFromType(type);
+                emit effectChanged(deviceId, displayName);
+                successCount++;
+                continue;
+            }
+            
+            qWarning() << "Firmware-Effekt" << hardwareEffect << "fehlgeschlagen, verwende Software-Effekt für" << device->getDisplayName();
+        }
+        
+        softwareDevices.append(device);
     }
     
-    if (successCount > 0) {
-        emit actionSuccess(QString("Effekt '%1' für %2 Gerät(e) gesetzt").arg(effectName).arg(successCount));
-    } else if (!devices.isEmpty()) {
-        emit actionError(QString("Fehler beim Setzen des Effekts '%1' für alle Geräte").arg(effectName));
+    if (softwareDevices.isEmpty()) {
+        return successCount;
+    }
+    
+    // Laufen genau diese Geräte bereits gemeinsam mit demselben Effekttyp,
+    // wird die Instanz nur umkonfiguriert und läuft ohne Neustart weiter
+    EffectGroup *group = m_deviceGroups.value(softwareDevices.first()->getId(), nullptr);
+    bool inPlace = group && group->effect->getType() == type && group->devices.size() == softwareDevices.size();
+    for (int i = 0; inPlace && i < softwareDevices.size(); ++i) {
+        inPlace = group->devices.contains(softwareDevices.at(i));
+    }
+    
+    if (inPlace) {
+        group->effect->resetParameters(parameters);
+        configureGroupLayout(group);
+    } else {
+        for (IRGBDevice *device : softwareDevices) {
+            removeEffect(device->getId());
+        }
+        
+        // Eine gemeinsame Effektinstanz für alle übrigen Geräte, bevorzugt aus dem Pool
+        group = acquireEffectGroup(type);
+        group->effect->resetParameters(parameters);
+        configureGroupLayout(group);
+        for (IRGBDevice *device : softwareDevices) {
+            bindDevice(group, device);
+        }
+        
+        group->effect->start();
+    }
+    updateIdleState();
+    
+    // Anfangszustand sofort ausgeben
+    dispatchGroupColor(group, group->effect->getCurrentColor());
+    
+    for (IRGBDevice *device : softwareDevices) {
+        emit effectChanged(device->getId(), displayName);
+        successCount++;
     }
     
     return successCount;
 }
 
-int RGBController::setEffectForAllDevices(const QString &effectName, const QVariantMap &parameters)
+RGBController::EffectGroup* RGBController::acquireEffectGroup(Effect::Type type)
 {
-    return setEffectForDevices(m_devices, effectName, parameters);
+    EffectGroup *group = nullptr;
+    
+    QList<EffectGroup*> &pool = m_groupPool[type];
+    if (!pool.isEmpty()) {
+        group = pool.takeLast();
+    } else {
+        group = new EffectGroup;
+        group->effect = Effect::createEffect(type, QVariantMap(), this);
+        group->spatial = false;
+        group->periods = 1.0;
+        group->skippedFrames = 0;
+        m_effectAllocations++;
+        
+        // Genau eine Verbindung je Instanz, die über alle Wiederverwendungen bestehen bleibt:
+        // der Effekt wird einmal berechnet und an die aktuellen Mitglieder der Gruppe verteilt
+        group->connection = connect(group->effect, &Effect::colorChanged, this, [this, group](const QColor &color) {
+            // Ein reaktiver Effekt kann von selbst anlaufen oder abklingen
+            bool animating = group->effect->isAnimating();
+            if (m_idle == animating) {
+                updateIdleState();
+            }
+            
+            // Über dem CPU-Budget nur jeden n-ten Frame ausgeben; der letzte Frame einer
+            // abklingenden Animation wird nie ausgelassen
+            int divider = m_governor->getFrameDivider();
+            if (animating && divider > 1 && ++group->skippedFrames < divider) {
+                m_governor->recordFrame(false);
+                return;
+            }
+            group->skippedFrames = 0;
+            
+            dispatchGroupColor(group, color);
+            m_governor->recordFrame(true);
+        });
+    }
+    
+    m_effectGroups.append(group);
+    return group;
+}
+
+void RGBController::releaseEffectGroup(EffectGroup *group)
+{
+    // Größe der Pools je Typ begrenzen
+    static const int maxPooledGroups = 16;
+    
+    m_effectGroups.removeAll(group);
+    group->effect->stop();
+    group->phaseOffsets.clear();
+    group->frames.clear();
+    group->phaseTables.clear();
+    
+    QList<EffectGroup*> &pool = m_groupPool[group->effect->getType()];
+    if (pool.size() < maxPooledGroups) {
+        pool.append(group);
+    } else {
+        destroyEffectGroup(group);
+    }
+    
+    updateIdleState();
+}
+
+void RGBController::destroyEffectGroup(EffectGroup *group)
+{
+    disconnect(group->connection);
+    
+    delete group->effect;
+    delete group;
+}
+
+void RGBController::configureGroupLayout(EffectGroup *group)
+{
+    // Räumliche Ausgabe: standardmäßig für Wellen, sonst auf Wunsch über "spatial"
+    LayoutParameters layout = group->effect->getLayoutParameters();
+    qreal angle = qDegreesToRadians(layout.direction);
+    group->spatial = group->effect->isPeriodic() && layout.spatial;
+    group->direction = QVector3D(float(qCos(angle)), float(qSin(angle)), 0.0f);
+    group->periods = layout.periods;
+    if (group->spatial) {
+        group->palette.resize(256);
+    }
+}
+
+void RGBController::bindDevice(EffectGroup *group, IRGBDevice *device)
+{
+    group->devices.append(device);
+    m_deviceGroups[device->getId()] = group;
+}
+
+const QVector<QRgb> &RGBController::renderSpatialFrame(EffectGroup *group, IRGBDevice *device)
+{
+    const QVector<quint8> &phases = m_layout->phaseTable(device->getId(), group->direction, group->periods,
+                                                         &group->phaseTables[device]);
+    const QRgb *palette = group->palette.constData();
+    quint8 offset = quint8(qRound(group->phaseOffsets.value(device, 0.0) * 256.0));
+    
+    // Ein Tabellenzugriff pro LED, der Puffer wird von Frame zu Frame wiederverwendet
+    QVector<QRgb> &frame = group->frames[device];
+    frame.resize(phases.size());
+    QRgb *out = frame.data();
+    for (int led = 0; led < phases.size(); ++led) {
+        out[led] = palette[quint8(phases[led] + offset)];
+    }
+    
+    return frame;
+}
+
+const QVector<QRgb> &RGBController::renderPerLedFrame(EffectGroup *group, IRGBDevice *device)
+{
+    const QVector<QVector3D> &positions = m_layout->normalizedPositions(device->getId());
+    int ledCount = positions.isEmpty() ? device->getLedCount() : int(positions.size());
+    
+    QVector<QRgb> &frame = group->frames[device];
+    frame.resize(ledCount);
+    
+    int step = m_governor->getLedStep();
+    if (step <= 1 || ledCount < step * 2) {
+        group->effect->renderFrame(frame.data(), ledCount, positions.isEmpty() ? nullptr : positions.constData());
+        return frame;
+    }
+    
+    // Über dem CPU-Budget nur jede n-te LED berechnen und auf ihre Nachbarn übertragen
+    int sampledCount = (ledCount + step - 1) / step;
+    group->sampledFrame.resize(sampledCount);
+    const QVector3D *sampledPositions = nullptr;
+    if (!positions.isEmpty()) {
+        group->sampledPositions.resize(sampledCount);
+        for (int i = 0; i < sampledCount; ++i) {
+            group->sampledPositions[i] = positions[i * step];
+        }
+        sampledPositions = group->sampledPositions.constData();
+    }
+    group->effect->renderFrame(group->sampledFrame.data(), sampledCount, sampledPositions);
+    
+    const QRgb *sampled = group->sampledFrame.constData();
+    QRgb *out = frame.data();
+    for (int led = 0; led < ledCount; ++led) {
+        out[led] = sampled[led / step];
+    }
+    
+    return frame;
+}
+
+void RGBController::renderGroupPalette(EffectGroup *group)
+{
+    QRgb *palette = group->palette.data();
+    int size = group->palette.size();
+    int step = m_governor->getPaletteStep();
+    if (step <= 1) {
+        group->effect->renderPalette(palette, size);
+        return;
+    }
+    
+    // Weniger Stützstellen abtasten und von hinten nach vorn aufweiten; jeder gelesene
+    // Eintrag liegt vor dem geschriebenen und ist daher noch unverändert
+    group->effect->renderPalette(palette, (size + step - 1) / step);
+    for (int i = size - 1; i > 0; --i) {
+        palette[i] = palette[i / step];
+    }
+}
+
+void RGBController::writeDeviceColor(IRGBDevice *device, const QColor &color)
+{
+    EffectCompositor *compositor = m_compositors.value(device->getId(), nullptr);
+    if (compositor) {
+        compositor->setBaseColor(color);
+        return;
+    }
+    
+    outputColor(device, color);
+    emit colorChanged(device->getId(), color);
+    emit frameChanged(device->getId(), solidFrame(device, color));
+}
+
+void RGBController::writeDeviceFrame(IRGBDevice *device, const QVector<QRgb> &frame)
+{
+    EffectCompositor *compositor = m_compositors.value(device->getId(), nullptr);
+    if (compositor) {
+        compositor->setBaseFrame(frame);
+        return;
+    }
+    
+    outputFrame(device, frame);
+    if (!frame.isEmpty()) {
+        emit colorChanged(device->getId(), QColor::fromRgb(frame.first()));
+        emit frameChanged(device->getId(), frame);
+    }
+}
+
+const QVector<QRgb> &RGBController::solidFrame(IRGBDevice *device, const QColor &color)
+{
+    // Der Puffer bleibt je Gerät bestehen, ab dem zweiten Aufruf wird nur noch gefüllt
+    QVector<QRgb> &frame = m_solidFrames[device->getId()];
+    frame.resize(qMax(1, device->getLedCount()));
+    frame.fill(color.rgb());
+    return frame;
+}
+
+bool RGBController::outputColor(IRGBDevice *device, const QColor &color)
+{
+    // Mit Dithering wird die Farbe in voller Genauigkeit kalibriert; auf 8 Bit verteilt wird
+    // erst beim Schreiben, damit nur tatsächlich gesendete Frames den Fehler weitertragen
+    if (m_dithers.contains(device->getId())) {
+        QRgba64 precise = color.rgba64();
+        auto calibration = m_calibrations.constFind(device->getId());
+        if (calibration != m_calibrations.constEnd()) {
+            precise = calibration->apply(precise);
+        }
+        
+        m_ditherTargets.insert(device->getId(), precise);
+        return submitFrame(device, solidFrame(device, QColor::fromRgba64(precise)));
+    }
+    
+    if (!m_encoders.contains(device->getId()) && !m_scheduler->isDeferred(device)) {
+        auto calibration = m_calibrations.constFind(device->getId());
+        if (calibration == m_calibrations.constEnd() && !m_powerLimiter.isLimited(device->getId())) {
+            return device->setColor(color);
+        }
+        
+        QRgb output = color.rgba();
+        if (calibration != m_calibrations.constEnd()) {
+            output = calibration->apply(output);
+        }
+        output = m_powerLimiter.limit(device->getId(), output, device->getLedCount());
+        return device->setColor(QColor::fromRgba(output));
+    }
+    return outputFrame(device, solidFrame(device, color));
+}
+
+bool RGBController::outputFrame(IRGBDevice *device, const QVector<QRgb> &frame)
+{
+    // Frames pro LED werden nicht gedithert
+    m_ditherTargets.remove(device->getId());
+    
+    // Kalibrierung als letzter Schritt vor der Übertragung; neutrale sind nicht eingetragen
+    const QVector<QRgb> *output = &frame;
+    auto calibration = m_calibrations.constFind(device->getId());
+    if (calibration != m_calibrations.constEnd()) {
+        QVector<QRgb> &calibrated = m_outputFrames[device->getId()];
+        calibration->apply(frame, calibrated);
+        output = &calibrated;
+    }
+    
+    return submitFrame(device, *output);
+}
+
+bool RGBController::submitFrame(IRGBDevice *device, const QVector<QRgb> &frame)
+{
+    // Strombudget auf den tatsächlich gesendeten Werten prüfen, gedimmt wird nur bei Überschreitung;
+    // geditherte Frames entstehen erst beim Schreiben und werden dort geprüft
+    const QVector<QRgb> *output = &frame;
+    if (m_powerLimiter.isLimited(device->getId()) && !m_ditherTargets.contains(device->getId())) {
+        QVector<QRgb> &limited = m_outputFrames[device->getId()];
+        if (m_powerLimiter.limit(device->getId(), frame, limited)) {
+            output = &limited;
+        }
+    }
+    
+    // Ist das Gerät noch im Frame-Intervall, plant der Scheduler den Frame ein
+    if (!m_scheduler->submit(device, *output)) {
+        return true;
+    }
+    return transmitFrame(device, *output);
+}
+
+bool RGBController::transmitFrame(IRGBDevice *device, const QVector<QRgb> &frame)
+{
+    const QString deviceId = device->getId();
+    const QVector<QRgb> *output = &frame;
+    
+    // Den Dithering-Frame erst jetzt erzeugen: vom Scheduler ersetzte Frames verändern den
+    // Fehler nicht. Ein älterer, noch eingeplanter Frame einer anderen Farbe bleibt ungedithert
+    auto target = m_ditherTargets.constFind(deviceId);
+    if (target != m_ditherTargets.constEnd() && !frame.isEmpty()
+        && frame.first() == QColor::fromRgba64(target.value()).rgb()) {
+        QVector<QRgb> &dithered = m_ditherFrames[deviceId];
+        m_dithers[deviceId].render(target.value(), frame.size(), dithered);
+        output = &dithered;
+        
+        if (m_powerLimiter.isLimited(deviceId)) {
+            QVector<QRgb> &limited = m_outputFrames[deviceId];
+            if (m_powerLimiter.limit(deviceId, dithered, limited)) {
+                output = &limited;
+            }
+        }
+    }
+    
+    auto it = m_encoders.find(deviceId);
+    if (it == m_encoders.end()) {
+        return device->setLedColors(*output);
+    }
+    
+    FrameEncoder &encoder = it.value();
+    if (!encoder.encode(*output)) {
+        // Unverändert, das Gerät zeigt den Frame bereits
+        return true;
+    }
+    
+    const LedFrameUpdate &update = encoder.update();
+    if (update.encoding != LedFrameUpdate::Full && device->setLedUpdate(update)) {
+        encoder.acknowledge(update.encoding);
+        return true;
+    }
+    
+    // Ganzer Frame, wenn keine Kodierung kleiner ist oder das Gerät sie ablehnt
+    if (device->setLedColors(*output)) {
+        encoder.acknowledge(LedFrameUpdate::Full);
+        return true;
+    }
+    
+    encoder.invalidate();
+    return false;
+}
+
+void RGBController::dispatchGroupColor(EffectGroup *group, const QColor &color)
+{
+    bool paletteReady = false;
+    
+    for (IRGBDevice *device : group->devices) {
+        if (group->effect->rendersPerLed()) {
+            writeDeviceFrame(device, renderPerLedFrame(group, device));
+            continue;
+        }
+        
+        if (group->spatial && m_layout->containsDevice(device->getId())) {
+            // Palette einmal pro Frame für die ganze Gruppe abtasten
+            if (!paletteReady) {
+                renderGroupPalette(group);
+                paletteReady = true;
+            }
+            
+            writeDeviceFrame(device, renderSpatialFrame(group, device));
+            continue;
+        }
+        
+        auto offset = group->phaseOffsets.constFind(device);
+        QColor deviceColor = offset == group->phaseOffsets.constEnd()
+            ? color
+            : group->effect->getColorAtPhase(offset.value());
+        
+        writeDeviceColor(device, deviceColor);
+    }
 }
 
 Effect* RGBController::createEffect(const QString &effectName, const QVariantMap &parameters)
@@ -198,16 +934,94 @@ Effect* RGBController::createEffect(const QString &effectName, const QVariantMap
     return Effect::createEffect(type, parameters, this);
 }
 
+QString RGBController::getActiveEffectId(IRGBDevice *device) const
+{
+    if (!device) {
+        return QString();
+    }
+    
+    QString deviceId = device->getId();
+    if (m_offloadedEffects.contains(deviceId)) {
+        return m_offloadedEffects.value(deviceId);
+    }
+    
+    EffectGroup *group = m_deviceGroups.value(deviceId, nullptr);
+    return group ? Effect::idFromType(group->effect->getType()) : QString();
+}
+
+QVariantMap RGBController::getActiveEffectParameters(IRGBDevice *device) const
+{
+    if (!device) {
+        return QVariantMap();
+    }
+    
+    QString deviceId = device->getId();
+    if (m_offloadedEffects.contains(deviceId)) {
+        return device->getEffectParameters();
+    }
+    
+    EffectGroup *group = m_deviceGroups.value(deviceId, nullptr);
+    return group ? group->effect->getParameters() : QVariantMap();
+}
+
+bool RGBController::isEffectOffloaded(IRGBDevice *device) const
+{
+    return device && m_offloadedEffects.contains(device->getId());
+}
+
+QString RGBController::negotiateHardwareEffect(IRGBDevice *device, Effect::Type type) const
+{
+    const QString wantedId = Effect::idFromType(type);
+    
+    for (const QString &nativeEffect : device->getSupportedEffects()) {
+        if (Effect::canonicalId(nativeEffect) == wantedId) {
+            return nativeEffect;
+        }
+    }
+    
+    return QString();
+}
+
+void RGBController::removeEffect(const QString &deviceId)
+{
+    m_offloadedEffects.remove(deviceId);
+    
+    // Der Eintrag bleibt bestehen, damit ein erneutes Zuordnen keinen Knoten anlegen muss
+    auto entry = m_deviceGroups.find(deviceId);
+    if (entry == m_deviceGroups.end() || !entry.value()) {
+        return;
+    }
+    
+    EffectGroup *group = entry.value();
+    entry.value() = nullptr;
+    
+    // Gerät aus seiner Sync-Gruppe nehmen
+    for (int i = group->devices.size() - 1; i >= 0; --i) {
+        if (group->devices.at(i)->getId() == deviceId) {
+            group->phaseOffsets.remove(group->devices.at(i));
+            group->frames.remove(group->devices.at(i));
+            group->phaseTables.remove(group->devices.at(i));
+            group->devices.removeAt(i);
+        }
+    }
+    
+    // Der Effekt läuft nur so lange, wie die Gruppe Mitglieder hat
+    if (group->devices.isEmpty()) {
+        releaseEffectGroup(group);
+    }
+}
+
 QStringList RGBController::getAvailableEffects() const
 {
     QStringList effects;
-    effects << "Statisch" << "Atmen" << "Regenbogen" << "Welle" << "Reaktiv";
+    effects << "Statisch" << "Atmen" << "Regenbogen" << "Welle" << "Reaktiv" << "Ausdruck";
     return effects;
 }
 
 void RGBController::setTemperatureLinking(bool enabled)
 {
     m_temperatureLinkingEnabled = enabled;
+    updateIdleState();
     
     if (enabled) {
         // Temperaturbasierte Farben anwenden
@@ -215,6 +1029,29 @@ void RGBController::setTemperatureLinking(bool enabled)
     }
 }
 
+bool RGBController::isIdle() const
+{
+    return m_idle;
+}
+
+void RGBController::updateIdleState()
+{
+    // Temperaturkopplung hängt an sich ändernden Sensorwerten
+    bool idle = !m_temperatureLinkingEnabled;
+    
+    for (int i = 0; idle && i < m_effectGroups.size(); ++i) {
+        idle = !m_effectGroups.at(i)->effect->isAnimating();
+    }
+    for (auto it = m_compositors.cbegin(); idle && it != m_compositors.cend(); ++it) {
+        idle = !it.value()->isAnimating();
+    }
+    
+    if (idle != m_idle) {
+        m_idle = idle;
+        emit idleChanged(idle);
+    }
+}
+
 bool RGBController::isTemperatureLinkingEnabled() const
 {
     return m_temperatureLinkingEnabled;
@@ -225,28 +1062,25 @@ void RGBController::updateTemperatures(int cpuTemp, int gpuTemp)
     m_cpuTemperature = cpuTemp;
     m_gpuTemperature = gpuTemp;
     
+    // Sensorwerte an Effekte weiterreichen, die sie auswerten (z.B. Ausdrücke)
+    for (EffectGroup *group : m_effectGroups) {
+        group->effect->setInputValue(QStringLiteral("cpu"), cpuTemp);
+        group->effect->setInputValue(QStringLiteral("gpu"), gpuTemp);
+    }
+    for (EffectCompositor *compositor : m_compositors) {
+        compositor->setInputValue(QStringLiteral("cpu"), cpuTemp);
+        compositor->setInputValue(QStringLiteral("gpu"), gpuTemp);
+    }
+    
     if (m_temperatureLinkingEnabled) {
         // Höchste Temperatur für die Farbgebung verwenden
         int maxTemp = qMax(cpuTemp, gpuTemp);
         QColor tempColor = Color::fromTemperature(maxTemp);
         
-        // Farbe auf alle Geräte anwenden
-        setColorForAllDevices(tempColor);
-    }
-}
-
-void RGBController::updateDeviceColor(const QString &deviceId)
-{
-    if (!m_deviceEffects.contains(deviceId)) {
-        return;
-    }
-    
-    Effect *effect = m_deviceEffects[deviceId];
-    IRGBDevice *device = getDeviceById(deviceId);
-    
-    if (device && effect) {
-        QColor color = effect->getCurrentColor();
-        device->setColor(color);
-        emit colorChanged(deviceId, color);
+        // Farbe auf alle Geräte anwenden; läuft bei jedem Sensorwert, daher ohne
+        // Erfolgsmeldungen und mit wiederverwendeten statischen Effekten
+        for (IRGBDevice *device : m_devices) {
+            applyColor(device, tempColor);
+        }
     }
 }
@@ -0,0 +1,42 @@
+#include "core/temporaldither.h"
+
+void TemporalDither::render(QRgba64 color, int ledCount, QVector<QRgb> &frame)
+{
+    if (m_error.size() != ledCount * 3) {
+        m_error.resize(ledCount * 3);
+        reset();
+    }
+    frame.resize(ledCount);
+    
+    // Zielwerte als 8.8-Festkomma, höchstens 255.0
+    const quint32 target[3] = {
+        (quint32(color.red()) * 255u * 256u + 32767u) / 65535u,
+        (quint32(color.green()) * 255u * 256u + 32767u) / 65535u,
+        (quint32(color.blue()) * 255u * 256u + 32767u) / 65535u
+    };
+    const quint32 alpha = quint32(color.alpha8()) << 24;
+    
+    quint8 *error = m_error.data();
+    QRgb *target8 = frame.data();
+    for (int i = 0; i < ledCount; ++i) {
+        quint32 red = target[0] + error[0];
+        quint32 green = target[1] + error[1];
+        quint32 blue = target[2] + error[2];
+        
+        // Der Nachkommaanteil bleibt als Fehler für den nächsten Frame stehen
+        error[0] = quint8(red);
+        error[1] = quint8(green);
+        error[2] = quint8(blue);
+        target8[i] = alpha | ((red >> 8) << 16) | ((green >> 8) << 8) | (blue >> 8);
+        error += 3;
+    }
+}
+
+void TemporalDither::reset()
+{
+    // Startfehler über die LEDs streuen; 97 und 256 sind teilerfremd
+    int count = m_error.size();
+    for (int i = 0; i < count; ++i) {
+        m_error[i] = quint8((i / 3) * 97 + (i % 3) * 85);
+    }
+}
@@ -0,0 +1,92 @@
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QDebug>
+#include "engine/luminengine.h"
+
+int main(int argc, char *argv[])
+{
+    // Nur QCoreApplication: keine Widgets, kein Plattform-Plugin, keine Anzeige nötig
+    QCoreApplication app(argc, argv);
+    
+    // Anwendungsinformationen setzen (gleiche Einstellungen und Profile wie die GUI)
+    QCoreApplication::setApplicationName("LuminControl");
+    QCoreApplication::setApplicationVersion("0.1.0");
+    QCoreApplication::setOrganizationName("LuminControl");
+    QCoreApplication::setOrganizationDomain("lumincontrol.org");
+    
+    // Kommandozeile auswerten
+    QCommandLineParser parser;
+    parser.setApplicationDescription("LuminControl-Dienst für Systeme ohne Anzeige");
+    parser.addHelpOption();
+    parser.addVersionOption();
+    
+    QCommandLineOption profileOption(QStringList() << "p" << "profile",
+                                     "Profil, das nach dem Start angewendet wird (sonst das Standardprofil).",
+                                     "name");
+    parser.addOption(profileOption);
+    
+    QCommandLineOption noSensorsOption("no-sensor-temperatures",
+                                       "Sensortemperaturen nicht an die Effekte weiterreichen.");
+    parser.addOption(noSensorsOption);
+    
+    QCommandLineOption noParkingOption("no-idle-parking",
+                                       "Sensorüberwachung auch dann weiterlaufen lassen, wenn nichts animiert.");
+    parser.addOption(noParkingOption);
+    
+    QCommandLineOption cpuBudgetOption("cpu-budget",
+                                       "CPU-Budget in Prozent eines Kerns; darüber werden Effekte vereinfacht (Standard: 10, 0 = aus).",
+                                       "percent", "10");
+    parser.addOption(cpuBudgetOption);
+    
+    QCommandLineOption socketOption("socket",
+                                    "Name des Steuer-Sockets (Standard: lumincontrol).",
+                                    "name", QLatin1String(ControlProtocol::DefaultServerName));
+    parser.addOption(socketOption);
+    
+    QCommandLineOption noControlOption("no-control",
+                                       "Keine Steuerschnittstelle und keinen Shared-Memory-Zustand anbieten.");
+    parser.addOption(noControlOption);
+    
+    QCommandLineOption openRGBOption("openrgb-server",
+                                     "OpenRGB-SDK-Server auf localhost anbieten.");
+    parser.addOption(openRGBOption);
+    
+    QCommandLineOption openRGBPortOption("openrgb-port",
+                                         "Port des OpenRGB-SDK-Servers (Standard: 6742).",
+                                         "port", "6742");
+    parser.addOption(openRGBPortOption);
+    
+    parser.process(app);
+    
+    try {
+        // Engine erstellen und starten
+        LuminEngine engine;
+        engine.setSensorTemperaturesEnabled(!parser.isSet(noSensorsOption));
+        engine.setIdleParkingEnabled(!parser.isSet(noParkingOption));
+        engine.getRGBController()->getFrameGovernor()->setBudget(parser.value(cpuBudgetOption).toDouble() / 100.0);
+        
+        // Steuerschnittstelle vor den Plugins starten, damit Clients Geräteereignisse erhalten
+        if (!parser.isSet(noControlOption) && !engine.startControlInterface(parser.value(socketOption))) {
+            qWarning() << "Dienst läuft ohne Steuerschnittstelle";
+        }
+        
+        if (parser.isSet(openRGBOption) && !engine.startOpenRGBServer(quint16(parser.value(openRGBPortOption).toUInt()))) {
+            qWarning() << "Dienst läuft ohne OpenRGB-SDK-Server";
+        }
+        
+        engine.start(parser.value(profileOption));
+        
+        qDebug() << "LuminControl-Dienst läuft";
+        
+        // Dienst ausführen
+        return app.exec();
+    } catch (const std::exception& e) {
+        // Fehlerbehandlung
+        qCritical() << "Ein kritischer Fehler ist aufgetreten:" << e.what();
+        return 1;
+    } catch (...) {
+        // Unbekannte Fehlerbehandlung
+        qCritical() << "Ein unbekannter kritischer Fehler ist aufgetreten.";
+        return 1;
+    }
+}
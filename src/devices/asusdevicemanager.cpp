@@ -34,51 +34,71 @@ QList<AsusRGBDevice*> AsusDeviceManager::getDevices() const
     return m_devices;
 }
 
-void AsusDeviceManager::scanForDevices()
+bool AsusDeviceManager::rescanDevices(QList<AsusRGBDevice*> &addedDevices, QStringList &removedDeviceIds)
 {
-    // Zuerst vorhandene Geräte entfernen
-    clearDevices();
+    if (!m_initialized) {
+        return false;
+    }
     
-    // Simulierte Geräte für Testzwecke
-    AsusRGBDevice *motherboard = new AsusRGBDevice(
-        "asus-mb-1",
-        "ASUS ROG Strix Z690-E Gaming WiFi",
-        "Motherboard",
-        this
-    );
-    m_devices.append(motherboard);
+    QList<DeviceInfo> found = enumerateDevices();
     
-    AsusRGBDevice *gpu = new AsusRGBDevice(
-        "asus-gpu-1",
-        "ASUS ROG Strix GeForce RTX 3080",
-        "GPU",
-        this
-    );
-    m_devices.append(gpu);
+    QStringList foundIds;
+    for (const DeviceInfo &info : found) {
+        foundIds.append(info.id);
+    }
     
-    AsusRGBDevice *ram = new AsusRGBDevice(
-        "asus-ram-1",
-        "ASUS ROG Strix RGB DDR5",
-        "RAM",
-        this
-    );
-    m_devices.append(ram);
+    // Nicht mehr vorhandene Geräte entfernen
+    for (auto it = m_devices.begin(); it != m_devices.end();) {
+        AsusRGBDevice *device = *it;
+        if (!foundIds.contains(device->getId())) {
+            removedDeviceIds.append(device->getId());
+            device->deleteLater();
+            it = m_devices.erase(it);
+        } else {
+            ++it;
+        }
+    }
     
-    AsusRGBDevice *keyboard = new AsusRGBDevice(
-        "asus-kb-1",
-        "ASUS ROG Strix Scope NX",
-        "Keyboard",
-        this
-    );
-    m_devices.append(keyboard);
+    // Neue Geräte anlegen, bekannte bleiben unangetastet
+    for (const DeviceInfo &info : found) {
+        bool known = false;
+        for (AsusRGBDevice *device : m_devices) {
+            if (device->getId() == info.id) {
+                known = true;
+                break;
+            }
+        }
+        
+        if (!known) {
+            AsusRGBDevice *device = new AsusRGBDevice(info.id, info.name, info.type, this);
+            m_devices.append(device);
+            addedDevices.append(device);
+        }
+    }
     
-    AsusRGBDevice *mouse = new AsusRGBDevice(
-        "asus-mouse-1",
-        "ASUS ROG Gladius III",
-        "Mouse",
-        this
-    );
-    m_devices.append(mouse);
+    return true;
+}
+
+QList<AsusDeviceManager::DeviceInfo> AsusDeviceManager::enumerateDevices() const
+{
+    // Simulierte Geräte für Testzwecke
+    return {
+        {"asus-mb-1", "ASUS ROG Strix Z690-E Gaming WiFi", "Motherboard"},
+        {"asus-gpu-1", "ASUS ROG Strix GeForce RTX 3080", "GPU"},
+        {"asus-ram-1", "ASUS ROG Strix RGB DDR5", "RAM"},
+        {"asus-kb-1", "ASUS ROG Strix Scope NX", "Keyboard"},
+        {"asus-mouse-1", "ASUS ROG Gladius III", "Mouse"}
+    };
+}
+
+void AsusDeviceManager::scanForDevices()
+{
+    // Zuerst vorhandene Geräte entfernen
+    clearDevices();
+    
+    for (const DeviceInfo &info : enumerateDevices()) {
+        m_devices.append(new AsusRGBDevice(info.id, info.name, info.type, this));
+    }
 }
 
 void AsusDeviceManager::clearDevices()
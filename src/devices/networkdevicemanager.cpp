@@ -0,0 +1,184 @@
+#include "devices/networkdevicemanager.h"
+#include <QDir>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QDebug>
+
+const char *NetworkDeviceManager::DefaultConfigPath = "config/outputdevices.json";
+
+NetworkDeviceManager::NetworkDeviceManager(QObject *parent)
+    : QObject(parent)
+    , m_initialized(false)
+    , m_sender(nullptr)
+{
+    qDebug() << "NetworkDeviceManager konstruiert";
+}
+
+NetworkDeviceManager::~NetworkDeviceManager()
+{
+    // Geräte vor dem Sender freigeben, sie melden ihre Paketströme dort ab
+    clearDevices();
+}
+
+bool NetworkDeviceManager::initialize(const QString &configPath)
+{
+    if (m_initialized) {
+        return true;
+    }
+    
+    qDebug() << "Initialisiere Netzwerk-Gerätemanager";
+    
+    m_configPath = QDir::current().filePath(configPath);
+    
+    QList<NetworkRGBDevice::Config> configs;
+    if (!readConfig(configs)) {
+        return false;
+    }
+    
+    for (const NetworkRGBDevice::Config &config : configs) {
+        m_devices.append(new NetworkRGBDevice(config, ensureSender(), this));
+    }
+    m_initialized = true;
+    
+    qDebug() << "Netzwerk-Gerätemanager initialisiert mit" << m_devices.size() << "Geräten";
+    
+    return true;
+}
+
+QList<NetworkRGBDevice*> NetworkDeviceManager::getDevices() const
+{
+    return m_devices;
+}
+
+bool NetworkDeviceManager::rescanDevices(QList<NetworkRGBDevice*> &addedDevices, QStringList &removedDeviceIds)
+{
+    if (!m_initialized) {
+        return false;
+    }
+    
+    QList<NetworkRGBDevice::Config> configs;
+    if (!readConfig(configs)) {
+        return false;
+    }
+    
+    QStringList configuredIds;
+    for (const NetworkRGBDevice::Config &config : configs) {
+        configuredIds.append(config.id);
+    }
+    
+    // Nicht mehr konfigurierte Geräte entfernen
+    for (auto it = m_devices.begin(); it != m_devices.end();) {
+        NetworkRGBDevice *device = *it;
+        if (!configuredIds.contains(device->getId())) {
+            removedDeviceIds.append(device->getId());
+            device->deleteLater();
+            it = m_devices.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    
+    // Neue Geräte anlegen, bekannte bleiben unangetastet
+    for (const NetworkRGBDevice::Config &config : configs) {
+        bool known = false;
+        for (NetworkRGBDevice *device : m_devices) {
+            if (device->getId() == config.id) {
+                known = true;
+                break;
+            }
+        }
+        
+        if (!known) {
+            NetworkRGBDevice *device = new NetworkRGBDevice(config, ensureSender(), this);
+            m_devices.append(device);
+            addedDevices.append(device);
+        }
+    }
+    
+    return true;
+}
+
+NetworkOutputSender *NetworkDeviceManager::getSender() const
+{
+    return m_sender;
+}
+
+NetworkOutputSender *NetworkDeviceManager::ensureSender()
+{
+    // Socket und Sendethread erst anlegen, wenn ein Gerät sie braucht
+    if (!m_sender) {
+        m_sender = new NetworkOutputSender(this);
+    }
+    return m_sender;
+}
+
+bool NetworkDeviceManager::readConfig(QList<NetworkRGBDevice::Config> &configs) const
+{
+    QFile file(m_configPath);
+    if (!file.exists()) {
+        return true;
+    }
+    
+    if (!file.open(QIODevice::ReadOnly)) {
+        qWarning() << "Konfiguration der Netzwerkgeräte konnte nicht geöffnet werden:" << m_configPath;
+        return false;
+    }
+    
+    QJsonParseError parseError;
+    QJsonDocument document = QJsonDocument::fromJson(file.readAll(), &parseError);
+    if (parseError.error != QJsonParseError::NoError || !document.isObject()) {
+        qWarning() << "Ungültige Konfiguration der Netzwerkgeräte:" << parseError.errorString();
+        return false;
+    }
+    
+    const QJsonArray devices = document.object().value("devices").toArray();
+    for (const QJsonValue &value : devices) {
+        QJsonObject entry = value.toObject();
+        
+        NetworkRGBDevice::Config config;
+        config.id = entry.value("id").toString();
+        config.name = entry.value("name").toString(config.id);
+        config.host = entry.value("host").toString();
+        config.port = quint16(entry.value("port").toInt(0));
+        config.ledCount = entry.value("ledCount").toInt(0);
+        config.startUniverse = entry.value("startUniverse").toInt(-1);
+        config.channelsPerUniverse = entry.value("channelsPerUniverse").toInt(510);
+        config.priority = entry.value("priority").toInt(100);
+        config.maxFrameRate = entry.value("maxFps").toInt(0);
+        config.latencyUs = entry.value("latencyMs").toInt(0) * 1000;
+        
+        if (config.id.isEmpty() || config.ledCount <= 0) {
+            qWarning() << "Netzwerkgerät ohne ID oder LED-Anzahl wird übersprungen:" << entry;
+            continue;
+        }
+        if (!NetworkRGBDevice::protocolFromName(entry.value("protocol").toString("e131"), config.protocol)) {
+            qWarning() << "Unbekanntes Protokoll für Netzwerkgerät" << config.id << ":" << entry.value("protocol");
+            continue;
+        }
+        if (!config.host.isEmpty() && QHostAddress(config.host).protocol() != QAbstractSocket::IPv4Protocol) {
+            qWarning() << "Netzwerkgerät" << config.id << "benötigt eine IPv4-Adresse, nicht" << config.host;
+            continue;
+        }
+        if (config.host.isEmpty() && config.protocol == NetworkRGBDevice::Ddp) {
+            qWarning() << "DDP-Gerät" << config.id << "benötigt eine Zieladresse";
+            continue;
+        }
+        if (config.channelsPerUniverse % 3 != 0 || config.channelsPerUniverse < 3 || config.channelsPerUniverse > 512) {
+            qWarning() << "Ungültige Kanalanzahl pro Universum für Netzwerkgerät" << config.id
+                       << ", verwende 510";
+            config.channelsPerUniverse = 510;
+        }
+        
+        configs.append(config);
+    }
+    
+    return true;
+}
+
+void NetworkDeviceManager::clearDevices()
+{
+    qDeleteAll(m_devices);
+    m_devices.clear();
+}
@@ -0,0 +1,289 @@
+#include "devices/networkoutputsender.h"
+#include <QMutexLocker>
+#include <QDebug>
+
+#ifdef Q_OS_LINUX
+#include <arpa/inet.h>
+#include <cerrno>
+#include <cstring>
+#include <unistd.h>
+#else
+#include <QUdpSocket>
+#endif
+
+NetworkOutputStream::NetworkOutputStream(int packetCount, int packetCapacity)
+    : m_packetCount(packetCount)
+    , m_packetCapacity(packetCapacity)
+    , m_addresses(packetCount)
+    , m_ports(packetCount, 0)
+#ifdef Q_OS_LINUX
+    , m_destinations(packetCount)
+#endif
+    , m_write(0)
+    , m_ready(1)
+    , m_sending(2)
+    , m_pending(false)
+{
+    for (int i = 0; i < 3; ++i) {
+        m_buffers[i].fill('\0', packetCount * packetCapacity);
+        m_lengths[i].fill(0, packetCount);
+        m_activeCounts[i] = packetCount;
+    }
+}
+
+int NetworkOutputStream::getPacketCount() const
+{
+    return m_packetCount;
+}
+
+char *NetworkOutputStream::packet(int index)
+{
+    return m_buffers[m_write].data() + index * m_packetCapacity;
+}
+
+void NetworkOutputStream::setPacket(int index, int length, const QHostAddress &address, quint16 port)
+{
+    for (QVector<quint16> &lengths : m_lengths) {
+        lengths[index] = quint16(qMin(length, m_packetCapacity));
+    }
+    m_addresses[index] = address;
+    m_ports[index] = port;
+
+#ifdef Q_OS_LINUX
+    sockaddr_in &destination = m_destinations[index];
+    std::memset(&destination, 0, sizeof(destination));
+    destination.sin_family = AF_INET;
+    destination.sin_port = htons(port);
+    destination.sin_addr.s_addr = htonl(address.toIPv4Address());
+#endif
+}
+
+void NetworkOutputStream::setPacketLength(int index, int length)
+{
+    m_lengths[m_write][index] = quint16(qMin(length, m_packetCapacity));
+}
+
+void NetworkOutputStream::setActivePacketCount(int count)
+{
+    m_activeCounts[m_write] = qBound(0, count, m_packetCount);
+}
+
+void NetworkOutputStream::commitTemplate()
+{
+    for (int i = 0; i < 3; ++i) {
+        if (i != m_write) {
+            std::copy(m_buffers[m_write].constBegin(), m_buffers[m_write].constEnd(), m_buffers[i].begin());
+        }
+    }
+}
+
+NetworkOutputSender::NetworkOutputSender(QObject *parent)
+    : QObject(parent)
+    , m_sendContext(new QObject())
+    , m_processScheduled(false)
+#ifdef Q_OS_LINUX
+    , m_socket(-1)
+#else
+    , m_udpSocket(nullptr)
+#endif
+    , m_sentPackets(0)
+    , m_sendCalls(0)
+    , m_droppedFrames(0)
+    , m_sendErrors(0)
+{
+#ifdef Q_OS_LINUX
+    m_socket = ::socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+    if (m_socket < 0) {
+        qWarning() << "UDP-Socket für Netzwerkausgabe konnte nicht angelegt werden:" << strerror(errno);
+    } else {
+        // Ausreichend Puffer für einen Frame mit vielen Universen
+        int bufferSize = 4 * 1024 * 1024;
+        ::setsockopt(m_socket, SOL_SOCKET, SO_SNDBUF, &bufferSize, sizeof(bufferSize));
+        
+        // Multicast (sACN) im lokalen Netz belassen
+        int ttl = 1;
+        ::setsockopt(m_socket, IPPROTO_IP, IP_MULTICAST_TTL, &ttl, sizeof(ttl));
+        
+        // Art-Net ohne Zieladresse sendet per Broadcast
+        int broadcast = 1;
+        ::setsockopt(m_socket, SOL_SOCKET, SO_BROADCAST, &broadcast, sizeof(broadcast));
+    }
+    std::memset(m_messages, 0, sizeof(m_messages));
+#endif
+
+    // Alle Sendevorgänge laufen im Kontext dieses Objekts auf dem Sendethread
+    m_sendThread.setObjectName("NetworkOutputSender");
+    m_sendContext->moveToThread(&m_sendThread);
+    m_sendThread.start(QThread::TimeCriticalPriority);
+}
+
+NetworkOutputSender::~NetworkOutputSender()
+{
+    m_sendThread.quit();
+    m_sendThread.wait();
+    delete m_sendContext;
+
+#ifdef Q_OS_LINUX
+    if (m_socket >= 0) {
+        ::close(m_socket);
+    }
+#else
+    delete m_udpSocket;
+#endif
+
+    qDeleteAll(m_streams);
+}
+
+NetworkOutputStream *NetworkOutputSender::createStream(int packetCount, int packetCapacity)
+{
+    NetworkOutputStream *stream = new NetworkOutputStream(packetCount, packetCapacity);
+    
+    QMutexLocker locker(&m_mutex);
+    m_streams.append(stream);
+    return stream;
+}
+
+void NetworkOutputSender::removeStream(NetworkOutputStream *stream)
+{
+    {
+        QMutexLocker locker(&m_mutex);
+        m_streams.removeAll(stream);
+        m_pending.removeAll(stream);
+    }
+    
+    // Ein laufender Sendevorgang kann den Strom noch verwenden
+    QMutexLocker sendLocker(&m_sendMutex);
+    m_processing.removeAll(stream);
+    delete stream;
+}
+
+void NetworkOutputSender::submit(NetworkOutputStream *stream)
+{
+    QMutexLocker locker(&m_mutex);
+    
+    // Der geschriebene Frame wird zum neuesten bereitliegenden; ein noch nicht
+    // gesendeter älterer Frame wird dabei verworfen
+    qSwap(stream->m_write, stream->m_ready);
+    if (stream->m_pending) {
+        m_droppedFrames++;
+    } else {
+        stream->m_pending = true;
+        m_pending.append(stream);
+    }
+    
+    if (!m_processScheduled) {
+        m_processScheduled = true;
+        QMetaObject::invokeMethod(m_sendContext, [this]() { processPending(); }, Qt::QueuedConnection);
+    }
+}
+
+bool NetworkOutputSender::isPending(NetworkOutputStream *stream) const
+{
+    QMutexLocker locker(&m_mutex);
+    return stream->m_pending;
+}
+
+quint64 NetworkOutputSender::getSentPacketCount() const
+{
+    return m_sentPackets;
+}
+
+quint64 NetworkOutputSender::getSendCallCount() const
+{
+    return m_sendCalls;
+}
+
+quint64 NetworkOutputSender::getDroppedFrameCount() const
+{
+    return m_droppedFrames;
+}
+
+quint64 NetworkOutputSender::getSendErrorCount() const
+{
+    return m_sendErrors;
+}
+
+void NetworkOutputSender::processPending()
+{
+    QMutexLocker sendLocker(&m_sendMutex);
+    
+    {
+        // Bereitliegende Frames übernehmen; die Liste behält ihre Kapazität
+        QMutexLocker locker(&m_mutex);
+        m_processScheduled = false;
+        for (NetworkOutputStream *stream : m_pending) {
+            qSwap(stream->m_ready, stream->m_sending);
+            stream->m_pending = false;
+            m_processing.append(stream);
+        }
+        m_pending.clear();
+    }
+    
+    for (NetworkOutputStream *stream : m_processing) {
+        sendStream(stream);
+    }
+    m_processing.clear();
+}
+
+void NetworkOutputSender::sendStream(NetworkOutputStream *stream)
+{
+    char *buffer = stream->m_buffers[stream->m_sending].data();
+    const QVector<quint16> &lengths = stream->m_lengths[stream->m_sending];
+    int packetCount = stream->m_activeCounts[stream->m_sending];
+
+#ifdef Q_OS_LINUX
+    if (m_socket < 0) {
+        return;
+    }
+    
+    // Pakete in Blöcken zu BatchSize mit je einem Systemaufruf senden
+    for (int first = 0; first < packetCount; first += BatchSize) {
+        int count = qMin(BatchSize, packetCount - first);
+        
+        for (int i = 0; i < count; ++i) {
+            int index = first + i;
+            m_vectors[i].iov_base = buffer + index * stream->m_packetCapacity;
+            m_vectors[i].iov_len = lengths.at(index);
+            
+            msghdr &header = m_messages[i].msg_hdr;
+            header.msg_name = &stream->m_destinations[index];
+            header.msg_namelen = sizeof(sockaddr_in);
+            header.msg_iov = &m_vectors[i];
+            header.msg_iovlen = 1;
+        }
+        
+        int sent = 0;
+        while (sent < count) {
+            int result = ::sendmmsg(m_socket, m_messages + sent, unsigned(count - sent), 0);
+            m_sendCalls++;
+            if (result < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                m_sendErrors++;
+                break;
+            }
+            sent += result;
+        }
+        m_sentPackets += quint64(sent);
+    }
+#else
+    if (!m_udpSocket) {
+        m_udpSocket = new QUdpSocket();
+        m_udpSocket->setSocketOption(QAbstractSocket::MulticastTtlOption, 1);
+    }
+    
+    for (int index = 0; index < packetCount; ++index) {
+        qint64 result = m_udpSocket->writeDatagram(buffer + index * stream->m_packetCapacity,
+                                                   lengths.at(index),
+                                                   stream->m_addresses.at(index),
+                                                   stream->m_ports.at(index));
+        m_sendCalls++;
+        if (result < 0) {
+            m_sendErrors++;
+        } else {
+            m_sentPackets++;
+        }
+    }
+#endif
+}
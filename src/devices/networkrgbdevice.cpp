@@ -0,0 +1,391 @@
+#include "devices/networkrgbdevice.h"
+#include <QUuid>
+#include <QDebug>
+#include <cstring>
+
+namespace {
+
+// Größen der Paketköpfe und der Nutzdaten
+const int E131HeaderSize = 126;
+const int ArtNetHeaderSize = 18;
+const int DdpHeaderSize = 10;
+const int MaxUniverseChannels = 512;
+const int DdpMaxLeds = 480;
+
+void writeBigEndian16(char *data, quint16 value)
+{
+    data[0] = char(value >> 8);
+    data[1] = char(value & 0xFF);
+}
+
+void writeBigEndian32(char *data, quint32 value)
+{
+    data[0] = char(value >> 24);
+    data[1] = char((value >> 16) & 0xFF);
+    data[2] = char((value >> 8) & 0xFF);
+    data[3] = char(value & 0xFF);
+}
+
+void writeDdpHeader(char *packet, quint32 byteOffset, int length, bool push)
+{
+    packet[0] = char(push ? 0x41 : 0x40);
+    packet[2] = char(0x0B);
+    packet[3] = 0x01;
+    writeBigEndian32(packet + 4, byteOffset);
+    writeBigEndian16(packet + 8, quint16(length));
+}
+
+} // namespace
+
+bool NetworkRGBDevice::protocolFromName(const QString &name, Protocol &protocol)
+{
+    QString key = name.trimmed().toLower();
+    if (key == "e131" || key == "e1.31" || key == "sacn") {
+        protocol = E131;
+    } else if (key == "artnet" || key == "art-net") {
+        protocol = ArtNet;
+    } else if (key == "ddp") {
+        protocol = Ddp;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+quint16 NetworkRGBDevice::defaultPort(Protocol protocol)
+{
+    switch (protocol) {
+    case E131:
+        return 5568;
+    case ArtNet:
+        return 6454;
+    case Ddp:
+        return 4048;
+    }
+    return 0;
+}
+
+NetworkRGBDevice::NetworkRGBDevice(const Config &config, NetworkOutputSender *sender, QObject *parent)
+    : QObject(parent)
+    , m_config(config)
+    , m_sender(sender)
+    , m_stream(nullptr)
+    , m_address(config.host)
+    , m_ledsPerPacket(0)
+    , m_dataOffset(0)
+    , m_sequence(0)
+    , m_currentColor(Qt::black)
+    , m_frame(config.ledCount, qRgb(0, 0, 0))
+{
+    if (m_config.port == 0) {
+        m_config.port = defaultPort(m_config.protocol);
+    }
+    if (m_config.startUniverse < 0) {
+        m_config.startUniverse = m_config.protocol == E131 ? 1 : 0;
+    }
+    
+    int packetCapacity = 0;
+    switch (m_config.protocol) {
+    case E131:
+    case ArtNet:
+        m_ledsPerPacket = qBound(3, m_config.channelsPerUniverse, MaxUniverseChannels) / 3;
+        m_dataOffset = m_config.protocol == E131 ? E131HeaderSize : ArtNetHeaderSize;
+        packetCapacity = m_dataOffset + MaxUniverseChannels;
+        break;
+    case Ddp:
+        m_ledsPerPacket = DdpMaxLeds;
+        m_dataOffset = DdpHeaderSize;
+        packetCapacity = m_dataOffset + DdpMaxLeds * 3;
+        break;
+    }
+    
+    int packetCount = qMax(1, (m_config.ledCount + m_ledsPerPacket - 1) / m_ledsPerPacket);
+    m_stream = m_sender->createStream(packetCount, packetCapacity);
+    buildPacketHeaders();
+    
+    qDebug() << "Netzwerkgerät" << m_config.name << "mit" << m_config.ledCount << "LEDs in"
+             << packetCount << "Paketen angelegt";
+}
+
+NetworkRGBDevice::~NetworkRGBDevice()
+{
+    m_sender->removeStream(m_stream);
+}
+
+QString NetworkRGBDevice::getId() const
+{
+    return m_config.id;
+}
+
+QString NetworkRGBDevice::getDisplayName() const
+{
+    return m_config.name;
+}
+
+QString NetworkRGBDevice::getType() const
+{
+    return "LED Strip";
+}
+
+bool NetworkRGBDevice::setColor(const QColor &color)
+{
+    m_currentColor = color;
+    m_frame.fill(color.rgb());
+    return setLedColors(m_frame);
+}
+
+int NetworkRGBDevice::getLedCount() const
+{
+    return m_config.ledCount;
+}
+
+bool NetworkRGBDevice::setLedColors(const QVector<QRgb> &colors)
+{
+    int available = qMin(colors.size(), m_config.ledCount);
+    const QRgb *source = colors.constData();
+    
+    advanceSequence();
+    
+    int packetCount = m_stream->getPacketCount();
+    for (int p = 0; p < packetCount; ++p) {
+        char *packet = m_stream->packet(p);
+        char *data = packet + m_dataOffset;
+        int first = p * m_ledsPerPacket;
+        int count = qMin(m_ledsPerPacket, m_config.ledCount - first);
+        
+        // Farbwerte direkt in das vorbelegte Paket schreiben
+        int filled = qBound(0, available - first, count);
+        for (int i = 0; i < filled; ++i) {
+            QRgb rgb = source[first + i];
+            data[0] = char(qRed(rgb));
+            data[1] = char(qGreen(rgb));
+            data[2] = char(qBlue(rgb));
+            data += 3;
+        }
+        if (filled < count) {
+            std::memset(data, 0, size_t(count - filled) * 3);
+        }
+        
+        switch (m_config.protocol) {
+        case E131:
+            packet[111] = char(m_sequence);
+            break;
+        case ArtNet:
+            packet[12] = char(m_sequence);
+            break;
+        case Ddp:
+            // Der Puffer kann zuvor eine Teilaktualisierung enthalten haben
+            writeDdpHeader(packet, quint32(first * 3), count * 3, p == packetCount - 1);
+            packet[1] = char(m_sequence & 0x0F);
+            m_stream->setPacketLength(p, m_dataOffset + count * 3);
+            break;
+        }
+    }
+    
+    m_stream->setActivePacketCount(packetCount);
+    m_sender->submit(m_stream);
+    return true;
+}
+
+int NetworkRGBDevice::getSupportedEncodings() const
+{
+    // DDP adressiert Daten über einen Byte-Offset, geänderte Bereiche passen direkt in Pakete
+    return m_config.protocol == Ddp ? int(LedFrameUpdate::DirtyRanges) : int(LedFrameUpdate::Full);
+}
+
+bool NetworkRGBDevice::setLedUpdate(const LedFrameUpdate &update)
+{
+    if (m_config.protocol != Ddp || update.encoding != LedFrameUpdate::DirtyRanges
+        || update.ledCount != m_config.ledCount) {
+        return false;
+    }
+    
+    // Nur so viele Pakete, wie für den ganzen Frame vorbelegt sind; sonst ganzer Frame
+    int needed = 0;
+    for (const LedFrameUpdate::Range &range : update.ranges) {
+        needed += (range.count + m_ledsPerPacket - 1) / m_ledsPerPacket;
+    }
+    if (needed == 0 || needed > m_stream->getPacketCount()) {
+        return false;
+    }
+    
+    // Ein noch nicht gesendeter Frame würde ersetzt und seine Änderungen gingen dem
+    // Empfänger verloren, obwohl der Encoder sie als übertragen führt; dann ganzer Frame
+    if (m_sender->isPending(m_stream)) {
+        return false;
+    }
+    
+    advanceSequence();
+    
+    int p = 0;
+    for (const LedFrameUpdate::Range &range : update.ranges) {
+        for (int offset = 0; offset < range.count; offset += m_ledsPerPacket) {
+            int first = range.start + offset;
+            int count = qMin(m_ledsPerPacket, range.count - offset);
+            char *packet = m_stream->packet(p);
+            
+            writeDdpHeader(packet, quint32(first * 3), count * 3, p == needed - 1);
+            packet[1] = char(m_sequence & 0x0F);
+            
+            char *data = packet + m_dataOffset;
+            const QRgb *source = update.colors + first;
+            for (int i = 0; i < count; ++i) {
+                data[0] = char(qRed(source[i]));
+                data[1] = char(qGreen(source[i]));
+                data[2] = char(qBlue(source[i]));
+                data += 3;
+            }
+            
+            m_stream->setPacketLength(p, m_dataOffset + count * 3);
+            ++p;
+        }
+    }
+    
+    m_stream->setActivePacketCount(needed);
+    m_sender->submit(m_stream);
+    return true;
+}
+
+int NetworkRGBDevice::getMaxFrameRate() const
+{
+    return m_config.maxFrameRate;
+}
+
+int NetworkRGBDevice::getOutputLatencyUs() const
+{
+    return m_config.latencyUs;
+}
+
+QColor NetworkRGBDevice::getColor() const
+{
+    return m_currentColor;
+}
+
+bool NetworkRGBDevice::setEffect(const QString &effectName, const QVariantMap &parameters)
+{
+    Q_UNUSED(parameters);
+    
+    // Netzwerkgeräte haben keine eigenen Effekte; Effekte rendert der RGBController
+    qWarning() << "Effekt" << effectName << "wird nicht vom Netzwerkgerät" << m_config.name << "unterstützt";
+    return false;
+}
+
+QString NetworkRGBDevice::getActiveEffect() const
+{
+    return "Static";
+}
+
+QVariantMap NetworkRGBDevice::getEffectParameters() const
+{
+    return QVariantMap();
+}
+
+bool NetworkRGBDevice::isConnected() const
+{
+    // UDP ist verbindungslos; das Gerät gilt als verbunden, solange der Sender existiert
+    return m_stream != nullptr;
+}
+
+void NetworkRGBDevice::advanceSequence()
+{
+    // Sequenznummer 0 bedeutet bei Art-Net "keine Reihenfolge", bei DDP sind nur 4 Bit belegt
+    m_sequence++;
+    if (m_config.protocol == ArtNet && m_sequence == 0) {
+        m_sequence = 1;
+    }
+    if (m_config.protocol == Ddp && (m_sequence & 0x0F) == 0) {
+        m_sequence++;
+    }
+}
+
+int NetworkRGBDevice::getPacketCount() const
+{
+    return m_stream->getPacketCount();
+}
+
+void NetworkRGBDevice::buildPacketHeaders()
+{
+    QByteArray cid = QUuid::createUuidV5(QUuid(), m_config.id).toRfc4122();
+    QByteArray sourceName = m_config.name.toUtf8().left(63);
+    
+    int packetCount = m_stream->getPacketCount();
+    for (int p = 0; p < packetCount; ++p) {
+        char *packet = m_stream->packet(p);
+        int count = qMin(m_ledsPerPacket, m_config.ledCount - p * m_ledsPerPacket);
+        int channels = qMax(0, count) * 3;
+        int universe = m_config.startUniverse + p;
+        int length = 0;
+        
+        switch (m_config.protocol) {
+        case E131: {
+            length = E131HeaderSize + channels;
+            
+            // Root Layer
+            writeBigEndian16(packet + 0, 0x0010);
+            writeBigEndian16(packet + 2, 0x0000);
+            std::memcpy(packet + 4, "ASC-E1.17\0\0\0", 12);
+            writeBigEndian16(packet + 16, quint16(0x7000 | (length - 16)));
+            writeBigEndian32(packet + 18, 0x00000004);
+            std::memcpy(packet + 22, cid.constData(), 16);
+            
+            // Framing Layer
+            writeBigEndian16(packet + 38, quint16(0x7000 | (length - 38)));
+            writeBigEndian32(packet + 40, 0x00000002);
+            std::memcpy(packet + 44, sourceName.constData(), size_t(sourceName.size()));
+            packet[108] = char(qBound(0, m_config.priority, 200));
+            writeBigEndian16(packet + 109, 0);
+            packet[111] = 0;
+            packet[112] = 0;
+            writeBigEndian16(packet + 113, quint16(universe));
+            
+            // DMP Layer
+            writeBigEndian16(packet + 115, quint16(0x7000 | (length - 115)));
+            packet[117] = char(0x02);
+            packet[118] = char(0xA1);
+            writeBigEndian16(packet + 119, 0x0000);
+            writeBigEndian16(packet + 121, 0x0001);
+            writeBigEndian16(packet + 123, quint16(channels + 1));
+            packet[125] = 0;
+            break;
+        }
+        case ArtNet: {
+            // Art-Net verlangt eine gerade Datenlänge von mindestens 2
+            int dataLength = qMax(2, channels + (channels & 1));
+            length = ArtNetHeaderSize + dataLength;
+            
+            std::memcpy(packet, "Art-Net\0", 8);
+            packet[8] = 0x00;
+            packet[9] = 0x50;
+            packet[10] = 0;
+            packet[11] = 14;
+            packet[12] = 0;
+            packet[13] = 0;
+            packet[14] = char(universe & 0xFF);
+            packet[15] = char((universe >> 8) & 0x7F);
+            writeBigEndian16(packet + 16, quint16(dataLength));
+            break;
+        }
+        case Ddp:
+            length = DdpHeaderSize + channels;
+            writeDdpHeader(packet, quint32(p * m_ledsPerPacket * 3), channels, p == packetCount - 1);
+            break;
+        }
+        
+        m_stream->setPacket(p, length, destinationFor(universe), m_config.port);
+    }
+    
+    m_stream->commitTemplate();
+}
+
+QHostAddress NetworkRGBDevice::destinationFor(int universe) const
+{
+    if (!m_address.isNull()) {
+        return m_address;
+    }
+    
+    // Ohne Zieladresse: sACN-Multicast je Universum bzw. Art-Net-Broadcast
+    if (m_config.protocol == E131) {
+        return QHostAddress(quint32(0xEFFF0000u | quint32(universe & 0xFFFF)));
+    }
+    return QHostAddress::Broadcast;
+}
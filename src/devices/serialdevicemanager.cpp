@@ -0,0 +1,161 @@
+#include "devices/serialdevicemanager.h"
+#include <QDir>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QDebug>
+
+const char *SerialDeviceManager::DefaultConfigPath = "config/serialdevices.json";
+
+SerialDeviceManager::SerialDeviceManager(QObject *parent)
+    : QObject(parent)
+    , m_initialized(false)
+{
+    qDebug() << "SerialDeviceManager konstruiert";
+}
+
+SerialDeviceManager::~SerialDeviceManager()
+{
+    clearDevices();
+}
+
+bool SerialDeviceManager::initialize(const QString &configPath)
+{
+    if (m_initialized) {
+        return true;
+    }
+    
+    qDebug() << "Initialisiere seriellen Gerätemanager";
+    
+    m_configPath = QDir::current().filePath(configPath);
+    
+    QList<SerialRGBDevice::Config> configs;
+    if (!readConfig(configs)) {
+        return false;
+    }
+    
+    for (const SerialRGBDevice::Config &config : configs) {
+        m_devices.append(createDevice(config));
+    }
+    m_initialized = true;
+    
+    qDebug() << "Serieller Gerätemanager initialisiert mit" << m_devices.size() << "Geräten";
+    
+    return true;
+}
+
+QList<SerialRGBDevice*> SerialDeviceManager::getDevices() const
+{
+    return m_devices;
+}
+
+bool SerialDeviceManager::rescanDevices(QList<SerialRGBDevice*> &addedDevices, QStringList &removedDeviceIds)
+{
+    if (!m_initialized) {
+        return false;
+    }
+    
+    QList<SerialRGBDevice::Config> configs;
+    if (!readConfig(configs)) {
+        return false;
+    }
+    
+    QStringList configuredIds;
+    for (const SerialRGBDevice::Config &config : configs) {
+        configuredIds.append(config.id);
+    }
+    
+    // Nicht mehr konfigurierte Geräte entfernen, getrennte erneut öffnen
+    for (auto it = m_devices.begin(); it != m_devices.end();) {
+        SerialRGBDevice *device = *it;
+        if (!configuredIds.contains(device->getId())) {
+            removedDeviceIds.append(device->getId());
+            device->close();
+            device->deleteLater();
+            it = m_devices.erase(it);
+        } else {
+            if (!device->isConnected()) {
+                device->open();
+            }
+            ++it;
+        }
+    }
+    
+    // Neue Geräte anlegen, bekannte bleiben unangetastet
+    for (const SerialRGBDevice::Config &config : configs) {
+        bool known = false;
+        for (SerialRGBDevice *device : m_devices) {
+            if (device->getId() == config.id) {
+                known = true;
+                break;
+            }
+        }
+        
+        if (!known) {
+            SerialRGBDevice *device = createDevice(config);
+            m_devices.append(device);
+            addedDevices.append(device);
+        }
+    }
+    
+    return true;
+}
+
+bool SerialDeviceManager::readConfig(QList<SerialRGBDevice::Config> &configs) const
+{
+    QFile file(m_configPath);
+    if (!file.exists()) {
+        return true;
+    }
+    
+    if (!file.open(QIODevice::ReadOnly)) {
+        qWarning() << "Konfiguration der seriellen Geräte konnte nicht geöffnet werden:" << m_configPath;
+        return false;
+    }
+    
+    QJsonParseError parseError;
+    QJsonDocument document = QJsonDocument::fromJson(file.readAll(), &parseError);
+    if (parseError.error != QJsonParseError::NoError || !document.isObject()) {
+        qWarning() << "Ungültige Konfiguration der seriellen Geräte:" << parseError.errorString();
+        return false;
+    }
+    
+    const QJsonArray devices = document.object().value("devices").toArray();
+    for (const QJsonValue &value : devices) {
+        QJsonObject entry = value.toObject();
+        
+        SerialRGBDevice::Config config;
+        config.id = entry.value("id").toString();
+        config.name = entry.value("name").toString(config.id);
+        config.portName = entry.value("port").toString();
+        config.baudRate = entry.value("baudRate").toInt(115200);
+        config.ledCount = entry.value("ledCount").toInt(0);
+        config.maxFrameRate = entry.value("maxFps").toInt(0);
+        
+        // Adalight überträgt die LED-Anzahl minus eins in 16 Bit
+        if (config.id.isEmpty() || config.portName.isEmpty() || config.ledCount <= 0 || config.ledCount > 65536) {
+            qWarning() << "Serielles Gerät ohne ID, Schnittstelle oder gültige LED-Anzahl wird übersprungen:" << entry;
+            continue;
+        }
+        
+        configs.append(config);
+    }
+    
+    return true;
+}
+
+SerialRGBDevice *SerialDeviceManager::createDevice(const SerialRGBDevice::Config &config)
+{
+    SerialRGBDevice *device = new SerialRGBDevice(config, this);
+    if (!device->open()) {
+        qWarning() << "Serielles Gerät" << config.name << "ist vorerst getrennt";
+    }
+    return device;
+}
+
+void SerialDeviceManager::clearDevices()
+{
+    qDeleteAll(m_devices);
+    m_devices.clear();
+}
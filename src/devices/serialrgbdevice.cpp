@@ -0,0 +1,344 @@
+#include "devices/serialrgbdevice.h"
+#include <QSocketNotifier>
+#include <QTimer>
+#include <QDebug>
+#include <cstring>
+
+#ifdef Q_OS_UNIX
+#include <cerrno>
+#include <fcntl.h>
+#include <termios.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+// "Ada", LED-Anzahl (2 Byte) und Prüfsumme
+const int AdalightHeaderSize = 6;
+
+#ifdef Q_OS_UNIX
+bool baudRateConstant(int baudRate, speed_t &speed)
+{
+    switch (baudRate) {
+    case 9600: speed = B9600; return true;
+    case 19200: speed = B19200; return true;
+    case 38400: speed = B38400; return true;
+    case 57600: speed = B57600; return true;
+    case 115200: speed = B115200; return true;
+    case 230400: speed = B230400; return true;
+#ifdef B460800
+    case 460800: speed = B460800; return true;
+#endif
+#ifdef B500000
+    case 500000: speed = B500000; return true;
+#endif
+#ifdef B921600
+    case 921600: speed = B921600; return true;
+#endif
+#ifdef B1000000
+    case 1000000: speed = B1000000; return true;
+#endif
+#ifdef B2000000
+    case 2000000: speed = B2000000; return true;
+#endif
+    default:
+        return false;
+    }
+}
+#endif
+
+} // namespace
+
+SerialRGBDevice::SerialRGBDevice(const Config &config, QObject *parent)
+    : QObject(parent)
+    , m_config(config)
+    , m_fd(-1)
+    , m_writeNotifier(nullptr)
+    , m_pacingTimer(new QTimer(this))
+    , m_inFlightOffset(0)
+    , m_writing(false)
+    , m_hasPending(false)
+    , m_nextFrameStartUs(0)
+    , m_frameDurationUs(0)
+    , m_currentColor(Qt::black)
+    , m_frame(config.ledCount, qRgb(0, 0, 0))
+    , m_writtenFrames(0)
+    , m_replacedFrames(0)
+{
+    // Beide Frame-Puffer einmalig anlegen; der Kopf ist für alle Frames gleich
+    int frameSize = AdalightHeaderSize + m_config.ledCount * 3;
+    quint16 count = quint16(qMax(0, m_config.ledCount - 1));
+    quint8 high = quint8(count >> 8);
+    quint8 low = quint8(count & 0xFF);
+    
+    m_pending.fill('\0', frameSize);
+    m_pending[0] = 'A';
+    m_pending[1] = 'd';
+    m_pending[2] = 'a';
+    m_pending[3] = char(high);
+    m_pending[4] = char(low);
+    m_pending[5] = char(high ^ low ^ 0x55);
+    m_inFlight = m_pending;
+    m_inFlight.detach();
+    
+    // 8N1: 10 Bit pro Byte auf der Leitung
+    m_frameDurationUs = qint64(frameSize) * 10 * 1000000 / qMax(1, m_config.baudRate);
+    
+    m_pacingTimer->setSingleShot(true);
+    m_pacingTimer->setTimerType(Qt::PreciseTimer);
+    connect(m_pacingTimer, &QTimer::timeout, this, &SerialRGBDevice::startPendingFrame);
+    
+    m_clock.start();
+}
+
+SerialRGBDevice::~SerialRGBDevice()
+{
+    close();
+}
+
+bool SerialRGBDevice::open()
+{
+#ifdef Q_OS_UNIX
+    if (m_fd >= 0) {
+        return true;
+    }
+    
+    speed_t speed;
+    if (!baudRateConstant(m_config.baudRate, speed)) {
+        qWarning() << "Nicht unterstützte Baudrate" << m_config.baudRate << "für" << m_config.portName;
+        return false;
+    }
+    
+    int fd = ::open(m_config.portName.toLocal8Bit().constData(), O_RDWR | O_NOCTTY | O_NONBLOCK | O_CLOEXEC);
+    if (fd < 0) {
+        qWarning() << "Serielle Schnittstelle" << m_config.portName << "konnte nicht geöffnet werden:" << strerror(errno);
+        return false;
+    }
+    
+    // Rohdaten ohne Zeilenaufbereitung, 8N1, keine Flusssteuerung
+    termios options;
+    if (tcgetattr(fd, &options) != 0) {
+        qWarning() << m_config.portName << "ist keine serielle Schnittstelle:" << strerror(errno);
+        ::close(fd);
+        return false;
+    }
+    cfmakeraw(&options);
+    options.c_cflag |= CLOCAL | CREAD;
+    options.c_cflag &= ~(CSTOPB | PARENB | CRTSCTS);
+    cfsetispeed(&options, speed);
+    cfsetospeed(&options, speed);
+    if (tcsetattr(fd, TCSANOW, &options) != 0) {
+        qWarning() << "Serielle Schnittstelle" << m_config.portName << "konnte nicht eingestellt werden:" << strerror(errno);
+        ::close(fd);
+        return false;
+    }
+    tcflush(fd, TCIOFLUSH);
+    
+    m_fd = fd;
+    m_writeNotifier = new QSocketNotifier(qintptr(m_fd), QSocketNotifier::Write, this);
+    m_writeNotifier->setEnabled(false);
+    connect(m_writeNotifier, &QSocketNotifier::activated, this, &SerialRGBDevice::onWritable);
+    
+    qDebug() << "Serielles Gerät" << m_config.name << "an" << m_config.portName << "mit" << m_config.baudRate
+             << "Baud geöffnet, Frame-Dauer" << m_frameDurationUs << "us";
+    return true;
+#else
+    qWarning() << "Serielle Geräte werden auf dieser Plattform nicht unterstützt:" << m_config.portName;
+    return false;
+#endif
+}
+
+void SerialRGBDevice::close()
+{
+    m_pacingTimer->stop();
+    
+    // close() kann aus dem activated-Signal des Notifiers heraus aufgerufen werden
+    if (m_writeNotifier) {
+        m_writeNotifier->setEnabled(false);
+        m_writeNotifier->deleteLater();
+        m_writeNotifier = nullptr;
+    }
+
+#ifdef Q_OS_UNIX
+    if (m_fd >= 0) {
+        ::close(m_fd);
+    }
+#endif
+    m_fd = -1;
+    m_writing = false;
+    m_hasPending = false;
+}
+
+QString SerialRGBDevice::getId() const
+{
+    return m_config.id;
+}
+
+QString SerialRGBDevice::getDisplayName() const
+{
+    return m_config.name;
+}
+
+QString SerialRGBDevice::getType() const
+{
+    return "LED Strip";
+}
+
+bool SerialRGBDevice::setColor(const QColor &color)
+{
+    m_currentColor = color;
+    m_frame.fill(color.rgb());
+    return setLedColors(m_frame);
+}
+
+int SerialRGBDevice::getLedCount() const
+{
+    return m_config.ledCount;
+}
+
+bool SerialRGBDevice::setLedColors(const QVector<QRgb> &colors)
+{
+    if (m_fd < 0) {
+        return false;
+    }
+    
+    // Ein noch nicht begonnener Frame wird durch den neuen ersetzt
+    if (m_hasPending) {
+        m_replacedFrames++;
+    }
+    
+    char *data = m_pending.data() + AdalightHeaderSize;
+    int available = qMin(colors.size(), m_config.ledCount);
+    for (int i = 0; i < available; ++i) {
+        QRgb rgb = colors.at(i);
+        data[0] = char(qRed(rgb));
+        data[1] = char(qGreen(rgb));
+        data[2] = char(qBlue(rgb));
+        data += 3;
+    }
+    if (available < m_config.ledCount) {
+        std::memset(data, 0, size_t(m_config.ledCount - available) * 3);
+    }
+    
+    m_hasPending = true;
+    startPendingFrame();
+    return true;
+}
+
+int SerialRGBDevice::getMaxFrameRate() const
+{
+    // Mehr Frames, als die Leitung überträgt, würden hier ohnehin ersetzt
+    int lineRate = int(qMax<qint64>(1, 1000000 / qMax<qint64>(1, m_frameDurationUs)));
+    return m_config.maxFrameRate > 0 ? qMin(m_config.maxFrameRate, lineRate) : lineRate;
+}
+
+int SerialRGBDevice::getOutputLatencyUs() const
+{
+    return int(m_frameDurationUs);
+}
+
+QColor SerialRGBDevice::getColor() const
+{
+    return m_currentColor;
+}
+
+bool SerialRGBDevice::setEffect(const QString &effectName, const QVariantMap &parameters)
+{
+    Q_UNUSED(parameters);
+    
+    // Adalight kennt keine Firmware-Effekte; Effekte rendert der RGBController
+    qWarning() << "Effekt" << effectName << "wird nicht vom seriellen Gerät" << m_config.name << "unterstützt";
+    return false;
+}
+
+QString SerialRGBDevice::getActiveEffect() const
+{
+    return "Static";
+}
+
+QVariantMap SerialRGBDevice::getEffectParameters() const
+{
+    return QVariantMap();
+}
+
+bool SerialRGBDevice::isConnected() const
+{
+    return m_fd >= 0;
+}
+
+qint64 SerialRGBDevice::getFrameDurationUs() const
+{
+    return m_frameDurationUs;
+}
+
+quint64 SerialRGBDevice::getWrittenFrameCount() const
+{
+    return m_writtenFrames;
+}
+
+quint64 SerialRGBDevice::getReplacedFrameCount() const
+{
+    return m_replacedFrames;
+}
+
+void SerialRGBDevice::onWritable()
+{
+    m_writeNotifier->setEnabled(false);
+    writeInFlight();
+}
+
+void SerialRGBDevice::startPendingFrame()
+{
+    if (!m_hasPending || m_writing || m_fd < 0) {
+        return;
+    }
+    
+    // Nicht schneller senden, als die Leitung den vorherigen Frame übertragen kann
+    qint64 now = m_clock.nsecsElapsed() / 1000;
+    if (now < m_nextFrameStartUs) {
+        if (!m_pacingTimer->isActive()) {
+            m_pacingTimer->start(int((m_nextFrameStartUs - now + 999) / 1000));
+        }
+        return;
+    }
+    
+    // Puffer tauschen statt kopieren; der Kopf steht in beiden
+    m_inFlight.swap(m_pending);
+    m_hasPending = false;
+    m_inFlightOffset = 0;
+    m_writing = true;
+    m_nextFrameStartUs = now + m_frameDurationUs;
+    
+    writeInFlight();
+}
+
+void SerialRGBDevice::writeInFlight()
+{
+#ifdef Q_OS_UNIX
+    while (m_inFlightOffset < m_inFlight.size()) {
+        ssize_t written = ::write(m_fd, m_inFlight.constData() + m_inFlightOffset,
+                                  size_t(m_inFlight.size() - m_inFlightOffset));
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                // Treiberpuffer voll: weiterschreiben, sobald wieder Platz ist
+                m_writeNotifier->setEnabled(true);
+                return;
+            }
+            qWarning() << "Schreibfehler an" << m_config.portName << ":" << strerror(errno);
+            close();
+            return;
+        }
+        m_inFlightOffset += int(written);
+    }
+#endif
+
+    m_writing = false;
+    m_writtenFrames++;
+    
+    if (m_hasPending) {
+        startPendingFrame();
+    }
+}
@@ -0,0 +1,374 @@
+#include "engine/controlserver.h"
+#include "engine/sharedstate.h"
+#include <QtEndian>
+#include <QDebug>
+#include <cstring>
+
+namespace {
+
+/**
+ * @brief Liest Werte aus den Nutzdaten einer Nachricht mit Bereichsprüfung
+ */
+class PayloadReader
+{
+public:
+    explicit PayloadReader(const QByteArray &data) : m_data(data), m_position(0), m_ok(true) {}
+    
+    bool ok() const { return m_ok; }
+    bool atEnd() const { return m_position == m_data.size(); }
+    
+    template <typename T>
+    T read()
+    {
+        if (!require(int(sizeof(T)))) {
+            return T();
+        }
+        T value = qFromLittleEndian<T>(m_data.constData() + m_position);
+        m_position += int(sizeof(T));
+        return value;
+    }
+    
+    double readDouble()
+    {
+        quint64 bits = read<quint64>();
+        double value;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+    
+    QString readString()
+    {
+        int length = read<quint16>();
+        if (!require(length)) {
+            return QString();
+        }
+        QString value = QString::fromUtf8(m_data.constData() + m_position, length);
+        m_position += length;
+        return value;
+    }
+
+private:
+    bool require(int size)
+    {
+        if (!m_ok || m_data.size() - m_position < size) {
+            m_ok = false;
+        }
+        return m_ok;
+    }
+    
+    const QByteArray &m_data;
+    int m_position;
+    bool m_ok;
+};
+
+/**
+ * @brief Schreibt Werte in die Nutzdaten einer Nachricht
+ */
+class PayloadWriter
+{
+public:
+    template <typename T>
+    void write(T value)
+    {
+        char bytes[sizeof(T)];
+        qToLittleEndian<T>(value, bytes);
+        m_data.append(bytes, int(sizeof(T)));
+    }
+    
+    void writeString(const QString &value)
+    {
+        QByteArray utf8 = value.toUtf8().left(0xFFFF);
+        write<quint16>(quint16(utf8.size()));
+        m_data.append(utf8);
+    }
+    
+    const QByteArray &data() const { return m_data; }
+
+private:
+    QByteArray m_data;
+};
+
+} // namespace
+
+ControlServer::ControlServer(DeviceManager *deviceManager, RGBController *rgbController, ProfileManager *profileManager,
+                             SensorMonitor *sensorMonitor, SharedState *sharedState, QObject *parent)
+    : QObject(parent)
+    , m_server(new QLocalServer(this))
+    , m_deviceManager(deviceManager)
+    , m_rgbController(rgbController)
+    , m_profileManager(profileManager)
+    , m_sensorMonitor(sensorMonitor)
+    , m_sharedState(sharedState)
+{
+    connect(m_server, &QLocalServer::newConnection, this, &ControlServer::onNewConnection);
+    connect(m_sensorMonitor, &SensorMonitor::sensorsUpdated, this, &ControlServer::onSensorsUpdated);
+    connect(m_deviceManager, &DeviceManager::deviceDiscovered, this, &ControlServer::onDeviceDiscovered);
+    connect(m_deviceManager, &DeviceManager::deviceRemoved, this, &ControlServer::onDeviceRemoved);
+}
+
+ControlServer::~ControlServer()
+{
+    m_server->close();
+}
+
+bool ControlServer::listen(const QString &name)
+{
+    // Nach einem Absturz kann der Socket noch existieren
+    QLocalServer::removeServer(name);
+    m_server->setSocketOptions(QLocalServer::UserAccessOption);
+    
+    if (!m_server->listen(name)) {
+        qWarning() << "Steuerschnittstelle konnte nicht gestartet werden:" << m_server->errorString();
+        return false;
+    }
+    
+    qDebug() << "Steuerschnittstelle lauscht auf" << m_server->fullServerName();
+    return true;
+}
+
+int ControlServer::getClientCount() const
+{
+    return m_clients.size();
+}
+
+bool ControlServer::hasSubscribers(ControlProtocol::Subscription subscription) const
+{
+    for (const Client &client : m_clients) {
+        if (client.subscriptions & subscription) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void ControlServer::onNewConnection()
+{
+    while (QLocalSocket *socket = m_server->nextPendingConnection()) {
+        m_clients.insert(socket, Client{QByteArray(), 0});
+        connect(socket, &QLocalSocket::readyRead, this, &ControlServer::onReadyRead);
+        connect(socket, &QLocalSocket::disconnected, this, &ControlServer::onDisconnected);
+    }
+}
+
+void ControlServer::onReadyRead()
+{
+    QLocalSocket *socket = qobject_cast<QLocalSocket*>(sender());
+    auto it = m_clients.find(socket);
+    if (it == m_clients.end()) {
+        return;
+    }
+    
+    Client &client = it.value();
+    client.buffer.append(socket->readAll());
+    
+    // Alle vollständigen Nachrichten im Puffer verarbeiten
+    int position = 0;
+    while (client.buffer.size() - position >= ControlProtocol::HeaderSize) {
+        const char *header = client.buffer.constData() + position;
+        quint16 magic = qFromLittleEndian<quint16>(header);
+        quint8 command = quint8(header[2]);
+        quint32 length = qFromLittleEndian<quint32>(header + 4);
+        
+        if (magic != ControlProtocol::Magic || length > ControlProtocol::MaxPayloadSize) {
+            qWarning() << "Steuerschnittstelle: ungültige Nachricht, Verbindung wird getrennt";
+            socket->disconnectFromServer();
+            return;
+        }
+        
+        if (quint32(client.buffer.size() - position - ControlProtocol::HeaderSize) < length) {
+            break;
+        }
+        
+        QByteArray payload = client.buffer.mid(position + ControlProtocol::HeaderSize, int(length));
+        position += ControlProtocol::HeaderSize + int(length);
+        
+        if (!handleMessage(socket, &client, command, payload)) {
+            sendResult(socket, command, false, "Fehlerhafte Nachricht");
+        }
+    }
+    
+    client.buffer.remove(0, position);
+}
+
+void ControlServer::onDisconnected()
+{
+    QLocalSocket *socket = qobject_cast<QLocalSocket*>(sender());
+    m_clients.remove(socket);
+    socket->deleteLater();
+    emit subscriptionsChanged();
+}
+
+bool ControlServer::handleMessage(QLocalSocket *socket, Client *client, quint8 command, const QByteArray &payload)
+{
+    PayloadReader reader(payload);
+    
+    switch (command) {
+    case ControlProtocol::SetColor: {
+        QString deviceId = reader.readString();
+        quint8 red = reader.read<quint8>();
+        quint8 green = reader.read<quint8>();
+        quint8 blue = reader.read<quint8>();
+        if (!reader.ok()) {
+            return false;
+        }
+        
+        QColor color(red, green, blue);
+        if (deviceId.isEmpty()) {
+            sendResult(socket, command, m_rgbController->setColorForAllDevices(color) > 0);
+        } else {
+            IRGBDevice *device = m_rgbController->getDeviceById(deviceId);
+            sendResult(socket, command, m_rgbController->setColorForDevice(device, color),
+                       device ? QString() : QString("Unbekanntes Gerät: %1").arg(deviceId));
+        }
+        return true;
+    }
+    
+    case ControlProtocol::SetEffect: {
+        QString deviceId = reader.readString();
+        QString effectName = reader.readString();
+        quint16 count = reader.read<quint16>();
+        
+        QVariantMap parameters;
+        for (quint16 i = 0; i < count && reader.ok(); ++i) {
+            QString key = reader.readString();
+            switch (reader.read<quint8>()) {
+            case ControlProtocol::Int32:
+                parameters.insert(key, reader.read<qint32>());
+                break;
+            case ControlProtocol::Double:
+                parameters.insert(key, reader.readDouble());
+                break;
+            case ControlProtocol::Bool:
+                parameters.insert(key, reader.read<quint8>() != 0);
+                break;
+            case ControlProtocol::String:
+                parameters.insert(key, reader.readString());
+                break;
+            default:
+                return false;
+            }
+        }
+        if (!reader.ok()) {
+            return false;
+        }
+        
+        if (deviceId.isEmpty()) {
+            sendResult(socket, command, m_rgbController->setEffectForAllDevices(effectName, parameters) > 0);
+        } else {
+            IRGBDevice *device = m_rgbController->getDeviceById(deviceId);
+            sendResult(socket, command, m_rgbController->setEffectForDevice(device, effectName, parameters),
+                       device ? QString() : QString("Unbekanntes Gerät: %1").arg(deviceId));
+        }
+        return true;
+    }
+    
+    case ControlProtocol::LoadProfile: {
+        QString name = reader.readString();
+        if (!reader.ok()) {
+            return false;
+        }
+        
+        sendResult(socket, command, m_profileManager->loadProfile(name));
+        return true;
+    }
+    
+    case ControlProtocol::Subscribe: {
+        quint32 mask = reader.read<quint32>();
+        if (!reader.ok()) {
+            return false;
+        }
+        
+        client->subscriptions = mask;
+        sendResult(socket, command, true);
+        emit subscriptionsChanged();
+        return true;
+    }
+    
+    case ControlProtocol::ListDevices: {
+        const QList<IRGBDevice*> devices = m_rgbController->getDevices();
+        
+        PayloadWriter writer;
+        writer.write<quint16>(quint16(devices.size()));
+        for (IRGBDevice *device : devices) {
+            writer.writeString(device->getId());
+            writer.writeString(device->getDisplayName());
+            writer.write<quint32>(quint32(device->getLedCount()));
+        }
+        send(socket, ControlProtocol::DeviceList, writer.data());
+        return true;
+    }
+    
+    case ControlProtocol::GetStateInfo: {
+        PayloadWriter writer;
+        writer.writeString(m_sharedState ? m_sharedState->getKey() : QString());
+        writer.write<quint32>(quint32(m_sharedState ? m_sharedState->getSize() : 0));
+        writer.write<quint16>(SharedState::LayoutVersion);
+        send(socket, ControlProtocol::StateInfo, writer.data());
+        return true;
+    }
+    
+    default:
+        sendResult(socket, command, false, QString("Unbekannter Befehl: %1").arg(command));
+        return true;
+    }
+}
+
+void ControlServer::send(QLocalSocket *socket, quint8 command, const QByteArray &payload)
+{
+    char header[ControlProtocol::HeaderSize];
+    qToLittleEndian<quint16>(ControlProtocol::Magic, header);
+    header[2] = char(command);
+    header[3] = 0;
+    qToLittleEndian<quint32>(quint32(payload.size()), header + 4);
+    
+    socket->write(header, ControlProtocol::HeaderSize);
+    socket->write(payload);
+}
+
+void ControlServer::broadcast(quint32 subscription, quint8 command, const QByteArray &payload)
+{
+    for (auto it = m_clients.constBegin(); it != m_clients.constEnd(); ++it) {
+        if (it.value().subscriptions & subscription) {
+            send(it.key(), command, payload);
+        }
+    }
+}
+
+void ControlServer::sendResult(QLocalSocket *socket, quint8 command, bool success, const QString &message)
+{
+    PayloadWriter writer;
+    writer.write<quint8>(command);
+    writer.write<quint8>(success ? 0 : 1);
+    writer.writeString(message);
+    send(socket, ControlProtocol::Result, writer.data());
+}
+
+void ControlServer::onSensorsUpdated()
+{
+    if (m_clients.isEmpty()) {
+        return;
+    }
+    
+    PayloadWriter writer;
+    writer.write<qint16>(qint16(m_sensorMonitor->getCpuTemperature()));
+    writer.write<qint16>(qint16(m_sensorMonitor->getCpuUsage()));
+    writer.write<qint16>(qint16(m_sensorMonitor->getGpuTemperature()));
+    writer.write<qint16>(qint16(m_sensorMonitor->getGpuUsage()));
+    broadcast(ControlProtocol::SensorEvents, ControlProtocol::SensorEvent, writer.data());
+}
+
+void ControlServer::onDeviceDiscovered(IRGBDevice *device)
+{
+    PayloadWriter writer;
+    writer.write<quint8>(1);
+    writer.writeString(device->getId());
+    broadcast(ControlProtocol::DeviceEvents, ControlProtocol::DeviceEvent, writer.data());
+}
+
+void ControlServer::onDeviceRemoved(IRGBDevice *device)
+{
+    PayloadWriter writer;
+    writer.write<quint8>(0);
+    writer.writeString(device->getId());
+    broadcast(ControlProtocol::DeviceEvents, ControlProtocol::DeviceEvent, writer.data());
+}
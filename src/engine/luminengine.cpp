@@ -0,0 +1,211 @@
+#include "engine/luminengine.h"
+#include "engine/controlserver.h"
+#include "engine/sharedstate.h"
+#include "engine/openrgbserver.h"
+#include <QCoreApplication>
+#include <QDebug>
+
+LuminEngine::LuminEngine(QObject *parent)
+    : QObject(parent)
+    , m_deviceManager(new DeviceManager(this))
+    , m_rgbController(new RGBController(this))
+    , m_sensorMonitor(new SensorMonitor(2000, this))
+    , m_profileManager(new ProfileManager(m_rgbController, this))
+    , m_sharedState(nullptr)
+    , m_controlServer(nullptr)
+    , m_openRGBServer(nullptr)
+    , m_startupPending(false)
+    , m_sensorTemperatures(true)
+    , m_idleParking(true)
+    , m_running(false)
+    , m_parked(false)
+    , m_wakeups(0)
+    , m_parkedWakeups(0)
+{
+    // Diese Verbindungen entstehen vor denen eines Clients, der Controller kennt ein
+    // neues Gerät also bereits, wenn der Client davon erfährt
+    connect(m_deviceManager, &DeviceManager::deviceDiscovered, m_rgbController, &RGBController::registerDevice);
+    connect(m_deviceManager, &DeviceManager::deviceRemoved, m_rgbController, &RGBController::unregisterDevice);
+    connect(m_deviceManager, &DeviceManager::pluginLoadingFinished, this, &LuminEngine::onPluginLoadingFinished);
+    connect(m_sensorMonitor, &SensorMonitor::sensorsUpdated, this, &LuminEngine::onSensorsUpdated);
+    connect(m_rgbController, &RGBController::idleChanged, this, &LuminEngine::updateParking);
+    
+    // Weckrufe zählen, um das Parken überprüfen zu können
+    if (QCoreApplication::instance()) {
+        QCoreApplication::instance()->installEventFilter(this);
+    }
+}
+
+LuminEngine::~LuminEngine()
+{
+    stop();
+}
+
+void LuminEngine::start(const QString &startupProfile)
+{
+    m_startupProfile = startupProfile;
+    m_startupPending = true;
+    
+    // Plugins laden im Hintergrund; das Profil wird erst angewendet, wenn die Geräte bekannt sind
+    m_deviceManager->loadPlugins();
+    m_running = true;
+    m_sensorMonitor->startMonitoring();
+    updateParking();
+}
+
+void LuminEngine::stop()
+{
+    m_running = false;
+    m_parked = false;
+    m_sensorMonitor->stopMonitoring();
+}
+
+void LuminEngine::setSensorTemperaturesEnabled(bool enabled)
+{
+    m_sensorTemperatures = enabled;
+}
+
+void LuminEngine::setIdleParkingEnabled(bool enabled)
+{
+    m_idleParking = enabled;
+    updateParking();
+}
+
+bool LuminEngine::isParked() const
+{
+    return m_parked;
+}
+
+quint64 LuminEngine::getWakeupCount() const
+{
+    return m_wakeups;
+}
+
+quint64 LuminEngine::getParkedWakeupCount() const
+{
+    return m_parkedWakeups;
+}
+
+bool LuminEngine::eventFilter(QObject *watched, QEvent *event)
+{
+    if (event->type() == QEvent::Timer) {
+        m_wakeups++;
+        if (m_parked) {
+            m_parkedWakeups++;
+        }
+    }
+    return QObject::eventFilter(watched, event);
+}
+
+bool LuminEngine::startControlInterface(const QString &serverName)
+{
+    if (m_controlServer) {
+        return true;
+    }
+    
+    // Zustand veröffentlichen; ohne Shared Memory bleibt der Socket trotzdem nutzbar
+    m_sharedState = new SharedState(m_rgbController, m_sensorMonitor, this);
+    if (m_sharedState->create(serverName + QLatin1String(".state"))) {
+        connect(m_deviceManager, &DeviceManager::deviceDiscovered, m_sharedState, &SharedState::rebuildLayout);
+        connect(m_deviceManager, &DeviceManager::deviceRemoved, m_sharedState, &SharedState::rebuildLayout);
+    } else {
+        delete m_sharedState;
+        m_sharedState = nullptr;
+    }
+    
+    m_controlServer = new ControlServer(m_deviceManager, m_rgbController, m_profileManager,
+                                        m_sensorMonitor, m_sharedState, this);
+    if (!m_controlServer->listen(serverName)) {
+        delete m_controlServer;
+        m_controlServer = nullptr;
+        return false;
+    }
+    
+    // Abonnierte Sensorereignisse halten die Sensorüberwachung wach
+    connect(m_controlServer, &ControlServer::subscriptionsChanged, this, &LuminEngine::updateParking);
+    return true;
+}
+
+bool LuminEngine::startOpenRGBServer(quint16 port)
+{
+    if (m_openRGBServer) {
+        return true;
+    }
+    
+    m_openRGBServer = new OpenRGBServer(m_deviceManager, m_rgbController, this);
+    if (!m_openRGBServer->listen(port)) {
+        delete m_openRGBServer;
+        m_openRGBServer = nullptr;
+        return false;
+    }
+    
+    return true;
+}
+
+DeviceManager* LuminEngine::getDeviceManager() const
+{
+    return m_deviceManager;
+}
+
+RGBController* LuminEngine::getRGBController() const
+{
+    return m_rgbController;
+}
+
+SensorMonitor* LuminEngine::getSensorMonitor() const
+{
+    return m_sensorMonitor;
+}
+
+ProfileManager* LuminEngine::getProfileManager() const
+{
+    return m_profileManager;
+}
+
+void LuminEngine::onPluginLoadingFinished(int loadedPlugins)
+{
+    if (!m_startupPending) {
+        return;
+    }
+    m_startupPending = false;
+    
+    qDebug() << "Engine gestartet," << loadedPlugins << "Plugins geladen";
+    
+    if (!m_startupProfile.isEmpty()) {
+        if (!m_profileManager->loadProfile(m_startupProfile)) {
+            qWarning() << "Startprofil konnte nicht geladen werden:" << m_startupProfile;
+        }
+    } else if (!m_profileManager->getDefaultProfile().isEmpty()) {
+        m_profileManager->loadDefaultProfile();
+    }
+    
+    emit started();
+}
+
+void LuminEngine::onSensorsUpdated()
+{
+    if (m_sensorTemperatures) {
+        m_rgbController->updateTemperatures(m_sensorMonitor->getCpuTemperature(),
+                                            m_sensorMonitor->getGpuTemperature());
+    }
+}
+
+void LuminEngine::updateParking()
+{
+    bool sensorsWanted = m_controlServer && m_controlServer->hasSubscribers(ControlProtocol::SensorEvents);
+    bool park = m_idleParking && m_running && m_rgbController->isIdle() && !sensorsWanted;
+    if (park == m_parked) {
+        return;
+    }
+    
+    m_parked = park;
+    if (park) {
+        m_sensorMonitor->stopMonitoring();
+        qDebug() << "Alle Ausgaben statisch, Timer geparkt";
+    } else {
+        m_sensorMonitor->startMonitoring();
+        qDebug() << "Ausgaben animieren wieder, Sensorüberwachung läuft";
+    }
+    
+    emit parkedChanged(park);
+}
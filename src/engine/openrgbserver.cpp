@@ -0,0 +1,472 @@
+#include "engine/openrgbserver.h"
+#include <QHostAddress>
+#include <QTimer>
+#include <QtEndian>
+#include <QDebug>
+
+namespace {
+
+// Paketkopf: "ORGB", u32 Geräteindex, u32 Pakettyp, u32 Nutzdatengröße
+const int HeaderSize = 16;
+const quint32 MaxPacketSize = 1024 * 1024;
+
+// Pakettypen des OpenRGB-SDK
+enum PacketId : quint32 {
+    RequestControllerCount = 0,
+    RequestControllerData = 1,
+    RequestProtocolVersion = 40,
+    SetClientName = 50,
+    DeviceListUpdated = 100,
+    ResizeZone = 1000,
+    UpdateLeds = 1050,
+    UpdateZoneLeds = 1051,
+    UpdateSingleLed = 1052,
+    SetCustomMode = 1100,
+    UpdateMode = 1101
+};
+
+// Gerätetypen des OpenRGB-SDK
+enum DeviceType : qint32 {
+    TypeMotherboard = 0,
+    TypeDram = 1,
+    TypeGpu = 2,
+    TypeCooler = 3,
+    TypeLedStrip = 4,
+    TypeKeyboard = 5,
+    TypeMouse = 6,
+    TypeHeadset = 8,
+    TypeUnknown = 19
+};
+
+// Modus-Flags und Farbmodus für "Direct"
+const quint32 ModeFlagHasPerLedColor = 1 << 5;
+const quint32 ModeColorsPerLed = 1;
+
+// Zonentyp
+const qint32 ZoneTypeLinear = 1;
+
+/**
+ * @brief Ordnet den Gerätetyp-Text einem OpenRGB-Gerätetyp zu
+ */
+qint32 deviceTypeFor(const QString &type)
+{
+    static const struct {
+        const char *keyword;
+        qint32 type;
+    } table[] = {
+        { "motherboard", TypeMotherboard },
+        { "mainboard", TypeMotherboard },
+        { "ram", TypeDram },
+        { "gpu", TypeGpu },
+        { "grafik", TypeGpu },
+        { "cooler", TypeCooler },
+        { "fan", TypeCooler },
+        { "lüfter", TypeCooler },
+        { "strip", TypeLedStrip },
+        { "keyboard", TypeKeyboard },
+        { "tastatur", TypeKeyboard },
+        { "mouse", TypeMouse },
+        { "maus", TypeMouse },
+        { "headset", TypeHeadset },
+    };
+    
+    for (const auto &entry : table) {
+        if (type.contains(QString::fromUtf8(entry.keyword), Qt::CaseInsensitive)) {
+            return entry.type;
+        }
+    }
+    return TypeUnknown;
+}
+
+void appendU16(QByteArray &data, quint16 value)
+{
+    char bytes[2];
+    qToLittleEndian<quint16>(value, bytes);
+    data.append(bytes, 2);
+}
+
+void appendU32(QByteArray &data, quint32 value)
+{
+    char bytes[4];
+    qToLittleEndian<quint32>(value, bytes);
+    data.append(bytes, 4);
+}
+
+// Zeichenketten: u16-Länge einschließlich Nullterminator, danach die Bytes samt Terminator
+void appendString(QByteArray &data, const QString &value)
+{
+    QByteArray utf8 = value.toUtf8().left(0xFFFE);
+    appendU16(data, quint16(utf8.size() + 1));
+    data.append(utf8);
+    data.append('\0');
+}
+
+// Farben: Bytes r, g, b, 0
+void appendColor(QByteArray &data, QRgb color)
+{
+    const char bytes[4] = { char(qRed(color)), char(qGreen(color)), char(qBlue(color)), 0 };
+    data.append(bytes, 4);
+}
+
+/**
+ * @brief Dekodiert count Farben (r, g, b, 0) ab Index first in einen Frame
+ */
+void decodeColors(const char *data, int count, QRgb *frame, int first, int ledCount)
+{
+    int end = qMin(first + count, ledCount);
+    const uchar *bytes = reinterpret_cast<const uchar*>(data);
+    for (int i = first; i < end; ++i, bytes += 4) {
+        frame[i] = qRgb(bytes[0], bytes[1], bytes[2]);
+    }
+}
+
+} // namespace
+
+OpenRGBServer::OpenRGBServer(DeviceManager *deviceManager, RGBController *rgbController, QObject *parent)
+    : QObject(parent)
+    , m_server(new QTcpServer(this))
+    , m_deviceManager(deviceManager)
+    , m_rgbController(rgbController)
+    , m_flushScheduled(false)
+    , m_receivedUpdates(0)
+    , m_appliedFrames(0)
+{
+    connect(m_server, &QTcpServer::newConnection, this, &OpenRGBServer::onNewConnection);
+    connect(m_deviceManager, &DeviceManager::deviceDiscovered, this, &OpenRGBServer::onDeviceListChanged);
+    connect(m_deviceManager, &DeviceManager::deviceRemoved, this, &OpenRGBServer::onDeviceListChanged);
+    
+    m_devices = m_rgbController->getDevices();
+}
+
+OpenRGBServer::~OpenRGBServer()
+{
+    m_server->close();
+}
+
+bool OpenRGBServer::listen(quint16 port)
+{
+    // Nur lokal erreichbar
+    if (!m_server->listen(QHostAddress::LocalHost, port)) {
+        qWarning() << "OpenRGB-SDK-Server konnte nicht gestartet werden:" << m_server->errorString();
+        return false;
+    }
+    
+    qDebug() << "OpenRGB-SDK-Server lauscht auf Port" << m_server->serverPort();
+    return true;
+}
+
+quint16 OpenRGBServer::getPort() const
+{
+    return m_server->serverPort();
+}
+
+int OpenRGBServer::getClientCount() const
+{
+    return m_clients.size();
+}
+
+quint64 OpenRGBServer::getReceivedUpdateCount() const
+{
+    return m_receivedUpdates;
+}
+
+quint64 OpenRGBServer::getAppliedFrameCount() const
+{
+    return m_appliedFrames;
+}
+
+void OpenRGBServer::onNewConnection()
+{
+    while (QTcpSocket *socket = m_server->nextPendingConnection()) {
+        // Kleine Antwortpakete nicht verzögern
+        socket->setSocketOption(QAbstractSocket::LowDelayOption, 1);
+        
+        m_clients.insert(socket, Client{QByteArray(), 0, QString()});
+        connect(socket, &QTcpSocket::readyRead, this, &OpenRGBServer::onReadyRead);
+        connect(socket, &QTcpSocket::disconnected, this, &OpenRGBServer::onDisconnected);
+    }
+}
+
+void OpenRGBServer::onReadyRead()
+{
+    QTcpSocket *socket = qobject_cast<QTcpSocket*>(sender());
+    auto it = m_clients.find(socket);
+    if (it == m_clients.end()) {
+        return;
+    }
+    
+    Client &client = it.value();
+    client.buffer.append(socket->readAll());
+    
+    // Alle vollständigen Pakete direkt aus dem Puffer verarbeiten
+    int position = 0;
+    while (client.buffer.size() - position >= HeaderSize) {
+        const char *header = client.buffer.constData() + position;
+        if (qstrncmp(header, "ORGB", 4) != 0) {
+            qWarning() << "OpenRGB-SDK: ungültiger Paketkopf, Verbindung wird getrennt";
+            socket->disconnectFromHost();
+            return;
+        }
+        
+        quint32 deviceIndex = qFromLittleEndian<quint32>(header + 4);
+        quint32 packetId = qFromLittleEndian<quint32>(header + 8);
+        quint32 size = qFromLittleEndian<quint32>(header + 12);
+        
+        if (size > MaxPacketSize) {
+            qWarning() << "OpenRGB-SDK: Paket zu groß, Verbindung wird getrennt";
+            socket->disconnectFromHost();
+            return;
+        }
+        
+        if (quint32(client.buffer.size() - position - HeaderSize) < size) {
+            break;
+        }
+        
+        handlePacket(socket, &client, deviceIndex, packetId, header + HeaderSize, size);
+        position += HeaderSize + int(size);
+    }
+    
+    client.buffer.remove(0, position);
+}
+
+void OpenRGBServer::onDisconnected()
+{
+    QTcpSocket *socket = qobject_cast<QTcpSocket*>(sender());
+    m_clients.remove(socket);
+    socket->deleteLater();
+}
+
+void OpenRGBServer::onDeviceListChanged()
+{
+    m_devices = m_rgbController->getDevices();
+    
+    // Puffer entfernter Geräte freigeben
+    for (auto it = m_frames.begin(); it != m_frames.end();) {
+        if (m_devices.contains(it.key())) {
+            ++it;
+        } else {
+            it = m_frames.erase(it);
+        }
+    }
+    
+    for (auto it = m_clients.constBegin(); it != m_clients.constEnd(); ++it) {
+        send(it.key(), 0, DeviceListUpdated, QByteArray());
+    }
+}
+
+void OpenRGBServer::handlePacket(QTcpSocket *socket, Client *client, quint32 deviceIndex, quint32 packetId,
+                                 const char *data, quint32 size)
+{
+    IRGBDevice *device = deviceIndex < quint32(m_devices.size()) ? m_devices.at(int(deviceIndex)) : nullptr;
+    
+    switch (packetId) {
+    case RequestControllerCount: {
+        QByteArray payload;
+        appendU32(payload, quint32(m_devices.size()));
+        send(socket, 0, RequestControllerCount, payload);
+        break;
+    }
+    
+    case RequestControllerData: {
+        if (!device) {
+            break;
+        }
+        
+        // Ab Protokoll 1 schickt der Client seine Version mit
+        quint32 version = size >= 4 ? qFromLittleEndian<quint32>(data) : 0;
+        send(socket, deviceIndex, RequestControllerData, controllerData(device, qMin(version, ProtocolVersion)));
+        break;
+    }
+    
+    case RequestProtocolVersion: {
+        quint32 version = size >= 4 ? qFromLittleEndian<quint32>(data) : 0;
+        client->protocolVersion = qMin(version, ProtocolVersion);
+        
+        QByteArray payload;
+        appendU32(payload, ProtocolVersion);
+        send(socket, 0, RequestProtocolVersion, payload);
+        break;
+    }
+    
+    case SetClientName:
+        client->name = QString::fromUtf8(data, int(qstrnlen(data, size)));
+        qDebug() << "OpenRGB-SDK-Client verbunden:" << client->name;
+        break;
+    
+    case UpdateLeds: {
+        // u32 Datengröße, u16 Farbanzahl, Farben
+        if (!device || size < 6) {
+            break;
+        }
+        
+        int count = qFromLittleEndian<quint16>(data + 4);
+        count = qMin(count, int((size - 6) / 4));
+        
+        DeviceFrame &frame = frameFor(device);
+        decodeColors(data + 6, count, frame.colors.data(), 0, frame.colors.size());
+        frame.dirty = true;
+        m_receivedUpdates++;
+        scheduleFlush();
+        break;
+    }
+    
+    case UpdateZoneLeds: {
+        // u32 Datengröße, u32 Zonenindex, u16 Farbanzahl, Farben; es gibt nur Zone 0
+        if (!device || size < 10 || qFromLittleEndian<quint32>(data + 4) != 0) {
+            break;
+        }
+        
+        int count = qFromLittleEndian<quint16>(data + 8);
+        count = qMin(count, int((size - 10) / 4));
+        
+        DeviceFrame &frame = frameFor(device);
+        decodeColors(data + 10, count, frame.colors.data(), 0, frame.colors.size());
+        frame.dirty = true;
+        m_receivedUpdates++;
+        scheduleFlush();
+        break;
+    }
+    
+    case UpdateSingleLed: {
+        // i32 LED-Index, Farbe
+        if (!device || size < 8) {
+            break;
+        }
+        
+        qint32 index = qFromLittleEndian<qint32>(data);
+        DeviceFrame &frame = frameFor(device);
+        if (index >= 0) {
+            decodeColors(data + 4, 1, frame.colors.data(), index, frame.colors.size());
+            frame.dirty = true;
+            m_receivedUpdates++;
+            scheduleFlush();
+        }
+        break;
+    }
+    
+    case SetCustomMode:
+    case UpdateMode:
+    case ResizeZone:
+        // Es gibt nur den Modus "Direct" und eine Zone fester Größe
+        break;
+    
+    default:
+        qDebug() << "OpenRGB-SDK: nicht unterstütztes Paket" << packetId;
+        break;
+    }
+}
+
+void OpenRGBServer::send(QTcpSocket *socket, quint32 deviceIndex, quint32 packetId, const QByteArray &payload)
+{
+    char header[HeaderSize] = { 'O', 'R', 'G', 'B' };
+    qToLittleEndian<quint32>(deviceIndex, header + 4);
+    qToLittleEndian<quint32>(packetId, header + 8);
+    qToLittleEndian<quint32>(quint32(payload.size()), header + 12);
+    
+    socket->write(header, HeaderSize);
+    if (!payload.isEmpty()) {
+        socket->write(payload);
+    }
+}
+
+QByteArray OpenRGBServer::controllerData(IRGBDevice *device, quint32 protocolVersion)
+{
+    const int ledCount = qMax(1, device->getLedCount());
+    
+    // Aktuelle Farben: zuletzt gestreamter Frame, sonst die Gerätefarbe
+    auto frame = m_frames.constFind(device);
+    const QRgb fallback = device->getColor().rgb();
+    
+    QByteArray data;
+    appendU32(data, 0); // Gesamtgröße, wird am Ende eingetragen
+    appendU32(data, quint32(deviceTypeFor(device->getType())));
+    appendString(data, device->getDisplayName());
+    if (protocolVersion >= 1) {
+        appendString(data, QString()); // Hersteller
+    }
+    appendString(data, device->getType()); // Beschreibung
+    appendString(data, QString());  // Version
+    appendString(data, device->getId()); // Seriennummer
+    appendString(data, QLatin1String("LuminControl")); // Ort
+    
+    // Ein Modus "Direct" mit Farbe je LED
+    appendU16(data, 1);
+    appendU32(data, 0); // aktiver Modus
+    appendString(data, QLatin1String("Direct"));
+    appendU32(data, 0); // Wert
+    appendU32(data, ModeFlagHasPerLedColor);
+    appendU32(data, 0); // speed_min
+    appendU32(data, 0); // speed_max
+    if (protocolVersion >= 3) {
+        appendU32(data, 0); // brightness_min
+        appendU32(data, 0); // brightness_max
+    }
+    appendU32(data, 0); // colors_min
+    appendU32(data, 0); // colors_max
+    appendU32(data, 0); // speed
+    if (protocolVersion >= 3) {
+        appendU32(data, 0); // brightness
+    }
+    appendU32(data, 0); // direction
+    appendU32(data, ModeColorsPerLed);
+    appendU16(data, 0); // Modusfarben
+    
+    // Eine lineare Zone über alle LEDs
+    appendU16(data, 1);
+    appendString(data, QLatin1String("LEDs"));
+    appendU32(data, quint32(ZoneTypeLinear));
+    appendU32(data, quint32(ledCount)); // leds_min
+    appendU32(data, quint32(ledCount)); // leds_max
+    appendU32(data, quint32(ledCount)); // leds_count
+    appendU16(data, 0); // keine Matrix
+    
+    // LEDs
+    appendU16(data, quint16(ledCount));
+    for (int i = 0; i < ledCount; ++i) {
+        appendString(data, QString("LED %1").arg(i + 1));
+        appendU32(data, quint32(i));
+    }
+    
+    // Farben
+    appendU16(data, quint16(ledCount));
+    for (int i = 0; i < ledCount; ++i) {
+        bool streamed = frame != m_frames.constEnd() && i < frame->colors.size();
+        appendColor(data, streamed ? frame->colors.at(i) : fallback);
+    }
+    
+    qToLittleEndian<quint32>(quint32(data.size()), data.data());
+    return data;
+}
+
+OpenRGBServer::DeviceFrame &OpenRGBServer::frameFor(IRGBDevice *device)
+{
+    auto it = m_frames.find(device);
+    if (it == m_frames.end()) {
+        DeviceFrame frame;
+        frame.colors.fill(device->getColor().rgb(), qMax(1, device->getLedCount()));
+        frame.dirty = false;
+        it = m_frames.insert(device, frame);
+    }
+    return it.value();
+}
+
+void OpenRGBServer::scheduleFlush()
+{
+    if (!m_flushScheduled) {
+        m_flushScheduled = true;
+        QTimer::singleShot(0, this, &OpenRGBServer::flushFrames);
+    }
+}
+
+void OpenRGBServer::flushFrames()
+{
+    m_flushScheduled = false;
+    
+    for (auto it = m_frames.begin(); it != m_frames.end(); ++it) {
+        if (it->dirty) {
+            it->dirty = false;
+            m_rgbController->setFrameForDevice(it.key(), it->colors);
+            m_appliedFrames++;
+        }
+    }
+}
@@ -0,0 +1,181 @@
+#include "engine/sharedstate.h"
+#include <QDateTime>
+#include <QDebug>
+#include <cstring>
+#include <new>
+
+static_assert(std::atomic<quint32>::is_always_lock_free, "Seqlock-Zähler muss ohne Sperre auskommen");
+
+namespace {
+
+// "LCST" in Little Endian
+const quint32 StateMagic = 0x5453434C;
+
+} // namespace
+
+SharedState::SharedState(RGBController *rgbController, SensorMonitor *sensorMonitor, QObject *parent)
+    : QObject(parent)
+    , m_rgbController(rgbController)
+    , m_sensorMonitor(sensorMonitor)
+{
+    connect(m_rgbController, &RGBController::frameChanged, this, &SharedState::onFrameChanged);
+    connect(m_sensorMonitor, &SensorMonitor::sensorsUpdated, this, &SharedState::onSensorsUpdated);
+}
+
+SharedState::~SharedState()
+{
+    if (m_memory.isAttached()) {
+        m_memory.detach();
+    }
+}
+
+bool SharedState::create(const QString &key, int size)
+{
+    const int minimumSize = int(sizeof(Header) + MaxDevices * sizeof(DeviceSlot));
+    if (size < minimumSize) {
+        qWarning() << "Shared Memory zu klein:" << size << "Byte, mindestens" << minimumSize;
+        return false;
+    }
+    
+    m_memory.setKey(key);
+    
+    // Ein nach einem Absturz verbliebenes Segment wird durch Anhängen und Lösen freigegeben
+    if (m_memory.attach()) {
+        m_memory.detach();
+    }
+    
+    if (!m_memory.create(size)) {
+        qWarning() << "Shared Memory konnte nicht angelegt werden:" << m_memory.errorString();
+        return false;
+    }
+    
+    std::memset(m_memory.data(), 0, size_t(size));
+    
+    Header *state = new (m_memory.data()) Header;
+    state->magic = StateMagic;
+    state->version = LayoutVersion;
+    state->maxDevices = MaxDevices;
+    state->sequence.store(0, std::memory_order_relaxed);
+    state->deviceCount = 0;
+    state->size = quint32(size);
+    state->timestamp = QDateTime::currentMSecsSinceEpoch();
+    
+    rebuildLayout();
+    
+    qDebug() << "Shared Memory angelegt:" << key << size << "Byte";
+    return true;
+}
+
+void SharedState::rebuildLayout()
+{
+    if (!m_memory.isAttached()) {
+        return;
+    }
+    
+    m_slotIndex.clear();
+    
+    beginWrite();
+    
+    Header *state = header();
+    quint32 offset = quint32(sizeof(Header) + MaxDevices * sizeof(DeviceSlot));
+    int index = 0;
+    
+    for (IRGBDevice *device : m_rgbController->getDevices()) {
+        if (index >= MaxDevices) {
+            qWarning() << "Shared Memory: zu viele Geräte, weitere werden nicht veröffentlicht";
+            break;
+        }
+        
+        quint32 ledCount = quint32(qMax(1, device->getLedCount()));
+        if (offset + ledCount * sizeof(QRgb) > state->size) {
+            qWarning() << "Shared Memory: kein Platz für den Frame von" << device->getId();
+            continue;
+        }
+        
+        DeviceSlot *entry = deviceSlot(index);
+        std::memset(entry, 0, sizeof(DeviceSlot));
+        QByteArray id = device->getId().toUtf8().left(int(sizeof(entry->id)) - 1);
+        std::memcpy(entry->id, id.constData(), size_t(id.size()));
+        entry->ledCount = ledCount;
+        entry->frameOffset = offset;
+        std::memset(static_cast<char*>(m_memory.data()) + offset, 0, ledCount * sizeof(QRgb));
+        
+        m_slotIndex.insert(device->getId(), index);
+        offset += ledCount * sizeof(QRgb);
+        index++;
+    }
+    
+    // Nicht mehr belegte Einträge leeren
+    for (int i = index; i < int(state->deviceCount); ++i) {
+        std::memset(deviceSlot(i), 0, sizeof(DeviceSlot));
+    }
+    state->deviceCount = quint32(index);
+    
+    endWrite();
+}
+
+QString SharedState::getKey() const
+{
+    return m_memory.isAttached() ? m_memory.key() : QString();
+}
+
+int SharedState::getSize() const
+{
+    return m_memory.isAttached() ? int(m_memory.size()) : 0;
+}
+
+void SharedState::onFrameChanged(const QString &deviceId, const QVector<QRgb> &frame)
+{
+    auto it = m_slotIndex.constFind(deviceId);
+    if (it == m_slotIndex.constEnd()) {
+        return;
+    }
+    
+    DeviceSlot *entry = deviceSlot(it.value());
+    int count = qMin(int(entry->ledCount), int(frame.size()));
+    
+    beginWrite();
+    std::memcpy(static_cast<char*>(m_memory.data()) + entry->frameOffset, frame.constData(), size_t(count) * sizeof(QRgb));
+    entry->frameCounter++;
+    endWrite();
+}
+
+void SharedState::onSensorsUpdated()
+{
+    if (!m_memory.isAttached()) {
+        return;
+    }
+    
+    beginWrite();
+    Header *state = header();
+    state->cpuTemperature = qint16(m_sensorMonitor->getCpuTemperature());
+    state->cpuUsage = qint16(m_sensorMonitor->getCpuUsage());
+    state->gpuTemperature = qint16(m_sensorMonitor->getGpuTemperature());
+    state->gpuUsage = qint16(m_sensorMonitor->getGpuUsage());
+    endWrite();
+}
+
+void SharedState::beginWrite()
+{
+    Header *state = header();
+    quint32 sequence = state->sequence.load(std::memory_order_relaxed);
+    state->sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+}
+
+void SharedState::endWrite()
+{
+    Header *state = header();
+    state->timestamp = QDateTime::currentMSecsSinceEpoch();
+    state->sequence.store(state->sequence.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+SharedState::Header* SharedState::header() const
+{
+    return static_cast<Header*>(const_cast<void*>(m_memory.constData()));
+}
+
+SharedState::DeviceSlot* SharedState::deviceSlot(int index) const
+{
+    return reinterpret_cast<DeviceSlot*>(header() + 1) + index;
+}
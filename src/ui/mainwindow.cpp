@@ -23,10 +23,11 @@ MainWindow::MainWindow(QWidget *parent)
     , tabWidget(new QTabWidget(this))
     , currentColor(Qt::white)
     , temperatureUpdateTimer(new QTimer(this))
-    , deviceManager(new DeviceManager(this))
-    , rgbController(new RGBController(this))
-    , sensorMonitor(new SensorMonitor(2000, this))
-    , profileManager(new ProfileManager(rgbController, this))
+    , engine(new LuminEngine(this))
+    , deviceManager(engine->getDeviceManager())
+    , rgbController(engine->getRGBController())
+    , sensorMonitor(engine->getSensorMonitor())
+    , profileManager(engine->getProfileManager())
 {
     setupUi();
     createDevicesTab();
@@ -37,20 +38,18 @@ MainWindow::MainWindow(QWidget *parent)
     setupCharts();
     connectSignals();
     
+    // Die Temperaturen für die Effekte liefert hier der Update-Timer der Oberfläche
+    engine->setSensorTemperaturesEnabled(false);
+    
+    // Die Überwachungsansicht braucht laufende Sensorwerte
+    engine->setIdleParkingEnabled(false);
+    
     initializePluginSystem();
     
-    // Temperatur-Update-Timer starten
+    // Temperatur-Update-Timer starten (Anzeige, Effekteingänge und Temperaturkopplung)
     temperatureUpdateTimer->setInterval(2000); // Alle 2 Sekunden aktualisieren
     temperatureUpdateTimer->start();
     
-    // Sensor-Monitoring starten
-    sensorMonitor->startMonitoring();
-    
-    // Standardprofil laden, falls vorhanden
-    if (!profileManager->getDefaultProfile().isEmpty()) {
-        profileManager->loadDefaultProfile();
-    }
-    
     statusBar()->showMessage("Ready");
     setWindowTitle("LuminControl");
     resize(1000, 800);
@@ -58,8 +57,8 @@ MainWindow::MainWindow(QWidget *parent)
 
 MainWindow::~MainWindow()
 {
-    // Sensor-Monitoring stoppen
-    sensorMonitor->stopMonitoring();
+    // Engine anhalten (Sensor-Monitoring stoppen)
+    engine->stop();
     
     // Qt will handle deleting the UI elements
 }
@@ -119,10 +118,17 @@ void MainWindow::createDevicesTab()
     rgbConfigureButton = new QPushButton("RGB konfigurieren", devicesTab);
     rgbConfigureButton->setEnabled(false); // Erst aktivieren, wenn Geräte ausgewählt sind
     
+    // Create rescan button
+    rescanDevicesButton = new QPushButton("Geräte neu suchen", devicesTab);
+    
+    QHBoxLayout *devicesButtonLayout = new QHBoxLayout();
+    devicesButtonLayout->addWidget(rgbConfigureButton);
+    devicesButtonLayout->addWidget(rescanDevicesButton);
+    
     // Add widgets to layout
     devicesLayout->addWidget(new QLabel("<h2>Geräteübersicht</h2>"));
     devicesLayout->addWidget(devicesTableView);
-    devicesLayout->addWidget(rgbConfigureButton);
+    devicesLayout->addLayout(devicesButtonLayout);
     
     // Add tab to tab widget
     tabWidget->addTab(devicesTab, "Geräte");
@@ -416,6 +422,9 @@ void MainWindow::connectSignals()
     // RGB Configure button
     connect(rgbConfigureButton, &QPushButton::clicked, this, &MainWindow::onRGBConfigureClicked);
     
+    // Rescan button
+    connect(rescanDevicesButton, &QPushButton::clicked, this, &MainWindow::onRescanDevicesClicked);
+    
     // Color picker
     connect(colorPicker, &QColorDialog::currentColorChanged, this, &MainWindow::onColorSelected);
     
@@ -464,6 +473,7 @@ void MainWindow::connectSignals()
     
     // Device Manager signals
     connect(deviceManager, &DeviceManager::deviceDiscovered, this, &MainWindow::onDeviceDiscovered);
+    connect(deviceManager, &DeviceManager::deviceRemoved, this, &MainWindow::onDeviceRemoved);
     
     // RGB Controller signals
     connect(rgbController, &RGBController::colorChanged, this, &MainWindow::onRGBColorChanged);
@@ -725,8 +735,10 @@ void MainWindow::updateColorPreview()
 
 void MainWindow::initializePluginSystem()
 {
-    // System initialisieren
-    deviceManager->loadPlugins();
+    // Plugins einmalig laden und Sensoren starten; die Geräte treffen über deviceDiscovered()
+    // ein, sobald das jeweilige Plugin im Hintergrund initialisiert wurde. Das Standardprofil
+    // wendet die Engine an, wenn alle Plugins geladen sind.
+    engine->start();
     
     // Statusmeldung anzeigen
     statusBar()->showMessage("LuminControl bereit");
@@ -743,12 +755,15 @@ void MainWindow::onDeviceDiscovered(IRGBDevice *device)
 {
     if (!device) return;
     
+    // Beim RGB-Controller hat die Engine das Gerät bereits angemeldet
+    
     // Gerät zur Liste hinzufügen
     int row = devicesModel->rowCount();
     devicesModel->insertRow(row);
     
-    // Gerätename
+    // Gerätename (die ID wird für die Zuordnung in der Auswahl mitgeführt)
     QStandardItem *nameItem = new QStandardItem(device->getDisplayName());
+    nameItem->setData(device->getId(), Qt::UserRole);
     devicesModel->setItem(row, 0, nameItem);
     
     // Gerätestatus
@@ -764,6 +779,33 @@ void MainWindow::onDeviceDiscovered(IRGBDevice *device)
     showStatusMessage(QString("Neues Gerät erkannt: %1").arg(device->getDisplayName()));
 }
 
+void MainWindow::onDeviceRemoved(IRGBDevice *device)
+{
+    if (!device) return;
+    
+    // Die laufenden Effekte hat die Engine bereits beendet
+    selectedDevices.removeAll(device);
+    
+    // Gerät aus der Liste entfernen
+    QString deviceId = device->getId();
+    for (int row = 0; row < devicesModel->rowCount(); ++row) {
+        if (devicesModel->data(devicesModel->index(row, 0), Qt::UserRole).toString() == deviceId) {
+            devicesModel->removeRow(row);
+            break;
+        }
+    }
+    
+    showStatusMessage(QString("Gerät entfernt: %1").arg(device->getDisplayName()));
+}
+
+void MainWindow::onRescanDevicesClicked()
+{
+    int changes = deviceManager->rescanDevices();
+    if (changes == 0) {
+        showStatusMessage("Keine Geräteänderungen gefunden");
+    }
+}
+
 void MainWindow::onDeviceSelectionChanged(const QItemSelection &selected, const QItemSelection &deselected)
 {
     // Liste der ausgewählten Geräte aktualisieren
@@ -876,7 +918,8 @@ void MainWindow::updateTemperatures()
     cpuTempBar->setValue(cpuTemp);
     gpuTempBar->setValue(gpuTemp);
     
-    // Temperaturwerte an den RGBController weitergeben
+    // Temperaturwerte immer an den RGBController weitergeben: Ausdrücke und Ebenen werten
+    // sie aus, die Farbe koppelt er nur bei eingeschalteter Temperaturkopplung
     rgbController->updateTemperatures(cpuTemp, gpuTemp);
 }
 
@@ -0,0 +1,135 @@
+#include "core/rgbcontroller.h"
+#include "testdevice.h"
+#include <QCoreApplication>
+#include <QLoggingCategory>
+#include <QStringList>
+#include <QFile>
+#include <QDebug>
+#include <cstdlib>
+
+#ifdef Q_OS_UNIX
+#include <unistd.h>
+#endif
+
+namespace {
+
+// Effektwechsel insgesamt; per Argument für schnelle Läufe verringerbar
+const qint64 DefaultIterations = 2000000;
+
+// Zulässiger Zuwachs des Arbeitsspeichers nach dem Einschwingen
+const qint64 MaxRssGrowthBytes = 2 * 1024 * 1024;
+
+/**
+ * @brief Liest den belegten Arbeitsspeicher des Prozesses
+ * @return Bytes, -1 wenn das System ihn nicht meldet
+ */
+qint64 residentSetBytes()
+{
+#ifdef Q_OS_UNIX
+    QFile statm("/proc/self/statm");
+    if (!statm.open(QIODevice::ReadOnly)) {
+        return -1;
+    }
+    QList<QByteArray> fields = statm.readAll().split(' ');
+    if (fields.size() < 2) {
+        return -1;
+    }
+    return fields.at(1).toLongLong() * qint64(sysconf(_SC_PAGESIZE));
+#else
+    return -1;
+#endif
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    // Millionen Effektwechsel würden sonst das Log füllen
+    QLoggingCategory::setFilterRules("*.debug=false");
+
+    qint64 iterations = DefaultIterations;
+    if (argc > 1) {
+        iterations = qMax<qint64>(1000, QByteArray(argv[1]).toLongLong());
+    }
+
+    RGBController controller;
+    TestDevice strip("soak-strip", 60);
+    TestDevice single("soak-single", 1);
+    controller.registerDevice(&strip);
+    controller.registerDevice(&single);
+
+    const QStringList effects = QStringList() << "Statisch" << "Atmen" << "Regenbogen" << "Welle" << "Reaktiv";
+    TestDevice *devices[] = { &strip, &single };
+
+    auto step = [&](qint64 i) {
+        TestDevice *device = devices[i % 2];
+        if (i % 7 == 0) {
+            controller.setColorForDevice(device, QColor::fromHsv(int(i % 360), 255, 255));
+        } else {
+            controller.setEffectForDevice(device, effects.at(int(i % effects.size())));
+        }
+
+        // Gelegentlich laufende Effekte ticken und verzögerte Löschungen ausführen lassen
+        if (i % 1024 == 0) {
+            QCoreApplication::processEvents();
+            QCoreApplication::sendPostedEvents(nullptr, QEvent::DeferredDelete);
+        }
+    };
+
+    // Einschwingen: Pools und Puffer erreichen ihre endgültige Größe
+    qint64 warmup = iterations / 10;
+    for (qint64 i = 0; i < warmup; ++i) {
+        step(i);
+    }
+
+    const int connections = controller.getEffectConnectionCount();
+    const quint64 allocations = controller.getEffectAllocationCount();
+    const qint64 rssBefore = residentSetBytes();
+
+    bool ok = true;
+    for (qint64 i = warmup; i < iterations; ++i) {
+        step(i);
+
+        if (i % 100000 == 0 || i == iterations - 1) {
+            // Genau eine Verbindung je Instanz, aktiv oder gepoolt
+            const int instances = controller.getActiveEffectCount() + controller.getPooledEffectCount();
+            if (controller.getEffectConnectionCount() != instances) {
+                qWarning() << "Verbindungen nach" << i << "Wechseln:" << controller.getEffectConnectionCount()
+                           << "bei" << instances << "Effektinstanzen";
+                ok = false;
+                break;
+            }
+            if (controller.getEffectConnectionCount() != connections) {
+                qWarning() << "Verbindungen nach" << i << "Wechseln:" << controller.getEffectConnectionCount()
+                           << "statt" << connections;
+                ok = false;
+                break;
+            }
+            if (controller.getEffectAllocationCount() != allocations) {
+                qWarning() << "Effekt-Allokationen nach" << i << "Wechseln:" << controller.getEffectAllocationCount()
+                           << "statt" << allocations;
+                ok = false;
+                break;
+            }
+        }
+    }
+
+    const qint64 rssAfter = residentSetBytes();
+    if (ok && rssBefore >= 0 && rssAfter - rssBefore > MaxRssGrowthBytes) {
+        qWarning() << "Arbeitsspeicher gewachsen:" << rssBefore << "->" << rssAfter << "Bytes";
+        ok = false;
+    }
+
+    qInfo() << "Effektwechsel:" << iterations
+            << "Verbindungen:" << controller.getEffectConnectionCount()
+            << "Allokationen:" << controller.getEffectAllocationCount()
+            << "RSS:" << rssBefore << "->" << rssAfter << "Bytes"
+            << "Frames:" << strip.getWrites() + single.getWrites();
+
+    controller.unregisterDevice(&strip);
+    controller.unregisterDevice(&single);
+
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
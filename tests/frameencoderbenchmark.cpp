@@ -0,0 +1,125 @@
+#include "core/frameencoder.h"
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QVector>
+#include <QDebug>
+#include <cstdlib>
+
+namespace {
+
+const int DefaultFrames = 200000;
+const int LedCount = 300;
+
+// Vorberechnete Frames je Szenario, damit nur das Kodieren gemessen wird
+const int FramePoolSize = 64;
+
+/**
+ * @brief Einfacher deterministischer Zufallsgenerator (LCG)
+ */
+quint32 nextRandom(quint32 &state)
+{
+    state = state * 1664525u + 1013904223u;
+    return state >> 8;
+}
+
+QVector<QVector<QRgb>> unchangedFrames()
+{
+    QVector<QRgb> frame(LedCount);
+    for (int led = 0; led < LedCount; ++led) {
+        frame[led] = qRgb(led & 0xFF, 64, 255 - (led & 0xFF));
+    }
+    return QVector<QVector<QRgb>>(1, frame);
+}
+
+// Wenige LEDs ändern sich je Frame (z.B. ein Lauflicht oder reaktive Tasten)
+QVector<QVector<QRgb>> sparseFrames()
+{
+    QVector<QVector<QRgb>> frames;
+    QVector<QRgb> frame = unchangedFrames().first();
+    quint32 random = 1;
+    for (int i = 0; i < FramePoolSize; ++i) {
+        for (int change = 0; change < 4; ++change) {
+            frame[int(nextRandom(random) % LedCount)] = qRgb(255, int(nextRandom(random) & 0xFF), 0);
+        }
+        frames.append(frame);
+    }
+    return frames;
+}
+
+// Wandernder Farbverlauf in Stufen zu 10 LEDs: alles ändert sich, aber in Läufen
+QVector<QVector<QRgb>> gradientFrames()
+{
+    QVector<QVector<QRgb>> frames;
+    for (int i = 0; i < FramePoolSize; ++i) {
+        QVector<QRgb> frame(LedCount);
+        for (int led = 0; led < LedCount; ++led) {
+            int step = (led / 10 + i) % 30;
+            frame[led] = qRgb(step * 8, 255 - step * 8, 128);
+        }
+        frames.append(frame);
+    }
+    return frames;
+}
+
+// Jede LED ändert sich in jedem Frame (Rauschen)
+QVector<QVector<QRgb>> fullChangeFrames()
+{
+    QVector<QVector<QRgb>> frames;
+    quint32 random = 7;
+    for (int i = 0; i < FramePoolSize; ++i) {
+        QVector<QRgb> frame(LedCount);
+        for (int led = 0; led < LedCount; ++led) {
+            frame[led] = nextRandom(random) | 0xFF000000u;
+        }
+        frames.append(frame);
+    }
+    return frames;
+}
+
+void runScenario(const char *name, const QVector<QVector<QRgb>> &frames, int frameCount)
+{
+    FrameEncoder encoder(LedFrameUpdate::DirtyRanges | LedFrameUpdate::RunLength);
+
+    QElapsedTimer timer;
+    timer.start();
+    for (int i = 0; i < frameCount; ++i) {
+        const QVector<QRgb> &frame = frames.at(i % frames.size());
+        if (encoder.encode(frame)) {
+            encoder.acknowledge(encoder.update().encoding);
+        }
+    }
+    qint64 elapsedNs = qMax<qint64>(1, timer.nsecsElapsed());
+
+    const FrameEncoder::Statistics &statistics = encoder.statistics();
+    double framesPerSecond = double(frameCount) * 1e9 / double(elapsedNs);
+    double ratio = statistics.rawBytes > 0 ? double(statistics.encodedBytes) / double(statistics.rawBytes) : 0.0;
+
+    qInfo().noquote() << QString("%1 %2 Frames/s, kodiert/roh %3, ganz %4, Bereiche %5, Läufe %6, unverändert %7")
+                             .arg(QString::fromLatin1(name), -12)
+                             .arg(framesPerSecond, 12, 'f', 0)
+                             .arg(ratio, 0, 'f', 3)
+                             .arg(statistics.fullFrames)
+                             .arg(statistics.rangeFrames)
+                             .arg(statistics.runLengthFrames)
+                             .arg(statistics.unchangedFrames);
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    int frameCount = DefaultFrames;
+    if (argc > 1) {
+        frameCount = qMax(1, QByteArray(argv[1]).toInt());
+    }
+
+    qInfo() << "FrameEncoder:" << frameCount << "Frames zu" << LedCount << "LEDs je Szenario";
+    runScenario("unverändert", unchangedFrames(), frameCount);
+    runScenario("vereinzelt", sparseFrames(), frameCount);
+    runScenario("Verlauf", gradientFrames(), frameCount);
+    runScenario("vollständig", fullChangeFrames(), frameCount);
+
+    return EXIT_SUCCESS;
+}
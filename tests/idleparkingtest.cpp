@@ -0,0 +1,94 @@
+#include "engine/luminengine.h"
+#include "testdevice.h"
+#include <QCoreApplication>
+#include <QLoggingCategory>
+#include <QElapsedTimer>
+#include <QThread>
+#include <QDebug>
+#include <functional>
+#include <cstdlib>
+
+namespace {
+
+const int TimeoutMs = 5000;
+
+// Länger als das Intervall der Sensorüberwachung (2 s), die im Parken ruhen muss
+const int ParkedMs = 3000;
+
+bool failed = false;
+
+void check(bool condition, const char *message)
+{
+    if (!condition) {
+        qWarning() << "Fehlgeschlagen:" << message;
+        failed = true;
+    }
+}
+
+/**
+ * @brief Bedient die Ereignisschleife ohne eigenen Timer
+ *
+ * Ein Timer zum Warten würde selbst als Weckruf zählen.
+ * @return false bei Zeitüberschreitung
+ */
+bool runUntil(const std::function<bool()> &condition, int timeoutMs)
+{
+    QElapsedTimer timer;
+    timer.start();
+    while (!condition()) {
+        if (timer.elapsed() > timeoutMs) {
+            return false;
+        }
+        QCoreApplication::processEvents();
+        QThread::msleep(5);
+    }
+    return true;
+}
+
+void runFor(int ms)
+{
+    runUntil([]() { return false; }, ms);
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QLoggingCategory::setFilterRules("*.debug=false");
+
+    LuminEngine engine;
+    RGBController *controller = engine.getRGBController();
+    TestDevice strip("parking-strip", 30);
+    controller->registerDevice(&strip);
+    controller->setColorForDevice(&strip, QColor(255, 120, 0));
+
+    engine.start();
+    check(runUntil([&]() { return engine.isParked(); }, TimeoutMs), "Statische Ausgabe parkt die Engine");
+
+    // Geparkt: weder Sensorüberwachung noch Effekte noch Temperaturwerte wecken den Prozess
+    runFor(ParkedMs);
+    controller->updateTemperatures(60, 70);
+    runFor(ParkedMs / 3);
+    check(engine.isParked(), "Temperaturwerte ohne Kopplung lassen die Engine geparkt");
+    check(engine.getParkedWakeupCount() == 0, "Keine Weckrufe im Parken");
+
+    // Eine Animation weckt die Engine, danach parkt sie wieder
+    quint64 wakeups = engine.getWakeupCount();
+    controller->setEffectForDevice(&strip, "Atmen");
+    check(!engine.isParked(), "Animation beendet das Parken");
+    runFor(500);
+    check(engine.getWakeupCount() > wakeups, "Animation läuft mit Timer");
+
+    controller->setColorForDevice(&strip, QColor(0, 80, 255));
+    check(runUntil([&]() { return engine.isParked(); }, TimeoutMs), "Erneut geparkt nach statischer Farbe");
+    quint64 parkedWakeups = engine.getParkedWakeupCount();
+    runFor(ParkedMs);
+    check(engine.getParkedWakeupCount() == parkedWakeups, "Keine Weckrufe nach erneutem Parken");
+
+    qInfo() << "Weckrufe:" << engine.getWakeupCount() << "davon geparkt:" << engine.getParkedWakeupCount();
+
+    engine.stop();
+    controller->unregisterDevice(&strip);
+    return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,315 @@
+#include "devices/networkrgbdevice.h"
+#include "devices/networkoutputsender.h"
+#include <QCoreApplication>
+#include <QLoggingCategory>
+#include <QUdpSocket>
+#include <QNetworkDatagram>
+#include <QHostAddress>
+#include <QElapsedTimer>
+#include <QDebug>
+#include <functional>
+#include <cstdlib>
+
+namespace {
+
+const int TimeoutMs = 5000;
+
+// Zwei volle Universen bzw. ein volles und ein angebrochenes DDP-Paket
+const int UniverseLedCount = 200;
+const int DdpLedCount = 600;
+
+bool failed = false;
+
+void check(bool condition, const char *message)
+{
+    if (!condition) {
+        qWarning() << "Fehlgeschlagen:" << message;
+        failed = true;
+    }
+}
+
+/**
+ * @brief Lässt die Ereignisschleife laufen, bis die Bedingung erfüllt ist
+ * @return false bei Zeitüberschreitung
+ */
+bool waitFor(const std::function<bool()> &condition)
+{
+    QElapsedTimer timer;
+    timer.start();
+    while (!condition()) {
+        if (timer.elapsed() > TimeoutMs) {
+            return false;
+        }
+        QCoreApplication::processEvents(QEventLoop::AllEvents, 10);
+    }
+    return true;
+}
+
+quint16 bigEndian16(const QByteArray &packet, int offset)
+{
+    return quint16((quint8(packet.at(offset)) << 8) | quint8(packet.at(offset + 1)));
+}
+
+quint32 bigEndian32(const QByteArray &packet, int offset)
+{
+    return (quint32(bigEndian16(packet, offset)) << 16) | bigEndian16(packet, offset + 2);
+}
+
+QVector<QRgb> testFrame(int ledCount, int frame)
+{
+    QVector<QRgb> colors(ledCount);
+    for (int led = 0; led < ledCount; ++led) {
+        colors[led] = qRgb((frame * 11 + led) & 0xFF, (led >> 2) & 0xFF, (frame * 5) & 0xFF);
+    }
+    return colors;
+}
+
+// Prüft die Farbwerte eines Pakets gegen den gesendeten Frame
+bool payloadMatches(const QByteArray &packet, int dataOffset, const QVector<QRgb> &colors, int first, int count)
+{
+    if (packet.size() < dataOffset + count * 3) {
+        return false;
+    }
+    const char *data = packet.constData() + dataOffset;
+    for (int i = 0; i < count; ++i) {
+        QRgb rgb = colors.at(first + i);
+        if (quint8(data[0]) != qRed(rgb) || quint8(data[1]) != qGreen(rgb) || quint8(data[2]) != qBlue(rgb)) {
+            return false;
+        }
+        data += 3;
+    }
+    return true;
+}
+
+/**
+ * @brief UDP-Empfänger auf 127.0.0.1 mit freiem Port
+ */
+class LoopbackReceiver
+{
+public:
+    bool bind()
+    {
+        return m_socket.bind(QHostAddress::LocalHost, 0);
+    }
+
+    quint16 port() const
+    {
+        return m_socket.localPort();
+    }
+
+    /**
+     * @brief Wartet auf eine bestimmte Anzahl an Paketen
+     * @return Empfangene Pakete in Empfangsreihenfolge, weniger bei Zeitüberschreitung
+     */
+    QList<QByteArray> receive(int count)
+    {
+        QList<QByteArray> packets;
+        waitFor([&]() {
+            while (m_socket.hasPendingDatagrams()) {
+                packets.append(m_socket.receiveDatagram().data());
+            }
+            return packets.size() >= count;
+        });
+        return packets;
+    }
+
+private:
+    QUdpSocket m_socket;
+};
+
+NetworkRGBDevice::Config loopbackConfig(const QString &id, NetworkRGBDevice::Protocol protocol, int ledCount,
+                                        quint16 port)
+{
+    NetworkRGBDevice::Config config;
+    config.id = id;
+    config.name = id;
+    config.protocol = protocol;
+    config.host = QHostAddress(QHostAddress::LocalHost).toString();
+    config.port = port;
+    config.ledCount = ledCount;
+    return config;
+}
+
+void testE131(NetworkOutputSender *sender)
+{
+    LoopbackReceiver receiver;
+    if (!receiver.bind()) {
+        check(false, "E1.31: Empfänger binden");
+        return;
+    }
+
+    NetworkRGBDevice::Config config = loopbackConfig("e131-strip", NetworkRGBDevice::E131, UniverseLedCount,
+                                                     receiver.port());
+    config.startUniverse = 7;
+    config.priority = 150;
+    NetworkRGBDevice device(config, sender);
+    check(device.getPacketCount() == 2, "E1.31: zwei Universen");
+
+    int previousSequence = -1;
+    for (int frame = 0; frame < 2; ++frame) {
+        QVector<QRgb> colors = testFrame(UniverseLedCount, frame);
+        device.setLedColors(colors);
+
+        QList<QByteArray> packets = receiver.receive(2);
+        if (packets.size() != 2) {
+            check(false, "E1.31: Pakete empfangen");
+            return;
+        }
+
+        int sequence = quint8(packets.first().at(111));
+        for (const QByteArray &packet : packets) {
+            int universe = bigEndian16(packet, 113);
+            int index = universe - config.startUniverse;
+            int count = index == 0 ? 170 : UniverseLedCount - 170;
+
+            check(index == 0 || index == 1, "E1.31: Universum fortlaufend ab startUniverse");
+            check(packet.size() == 126 + count * 3, "E1.31: Paketlänge");
+            check(bigEndian16(packet, 0) == 0x0010, "E1.31: Preamble");
+            check(packet.mid(4, 12) == QByteArray("ASC-E1.17\0\0\0", 12), "E1.31: ACN-Kennung");
+            check(bigEndian16(packet, 16) == (0x7000 | (packet.size() - 16)), "E1.31: Länge Root Layer");
+            check(bigEndian32(packet, 18) == 0x00000004, "E1.31: Root-Vektor");
+            check(bigEndian16(packet, 38) == (0x7000 | (packet.size() - 38)), "E1.31: Länge Framing Layer");
+            check(bigEndian32(packet, 40) == 0x00000002, "E1.31: Framing-Vektor");
+            check(packet.mid(44, 10) == QByteArray("e131-strip"), "E1.31: Quellname");
+            check(quint8(packet.at(108)) == 150, "E1.31: Priorität");
+            check(quint8(packet.at(111)) == sequence, "E1.31: gleiche Sequenznummer je Frame");
+            check(bigEndian16(packet, 115) == (0x7000 | (packet.size() - 115)), "E1.31: Länge DMP Layer");
+            check(quint8(packet.at(117)) == 0x02 && quint8(packet.at(118)) == 0xA1, "E1.31: DMP-Vektor");
+            check(bigEndian16(packet, 123) == count * 3 + 1, "E1.31: Anzahl der Kanäle");
+            check(packet.at(125) == 0, "E1.31: Startcode");
+            check(payloadMatches(packet, 126, colors, index * 170, count), "E1.31: Farbwerte");
+        }
+
+        if (previousSequence >= 0) {
+            check(sequence == ((previousSequence + 1) & 0xFF), "E1.31: Sequenznummer steigt je Frame");
+        }
+        previousSequence = sequence;
+    }
+}
+
+void testArtNet(NetworkOutputSender *sender)
+{
+    LoopbackReceiver receiver;
+    if (!receiver.bind()) {
+        check(false, "Art-Net: Empfänger binden");
+        return;
+    }
+
+    NetworkRGBDevice::Config config = loopbackConfig("artnet-strip", NetworkRGBDevice::ArtNet, UniverseLedCount,
+                                                     receiver.port());
+    NetworkRGBDevice device(config, sender);
+    check(device.getPacketCount() == 2, "Art-Net: zwei Universen");
+
+    int previousSequence = -1;
+    for (int frame = 0; frame < 2; ++frame) {
+        QVector<QRgb> colors = testFrame(UniverseLedCount, frame);
+        device.setLedColors(colors);
+
+        QList<QByteArray> packets = receiver.receive(2);
+        if (packets.size() != 2) {
+            check(false, "Art-Net: Pakete empfangen");
+            return;
+        }
+
+        int sequence = quint8(packets.first().at(12));
+        for (const QByteArray &packet : packets) {
+            // Standard-Startuniversum für Art-Net ist 0; Subnetz und Universum im Low-Byte
+            int universe = quint8(packet.at(14)) | (quint8(packet.at(15)) << 8);
+            int count = universe == 0 ? 170 : UniverseLedCount - 170;
+            int dataLength = count * 3 + ((count * 3) & 1);
+
+            check(universe == 0 || universe == 1, "Art-Net: Universum fortlaufend ab 0");
+            check(packet.startsWith(QByteArray("Art-Net\0", 8)), "Art-Net: Kennung");
+            check(packet.at(8) == 0x00 && packet.at(9) == 0x50, "Art-Net: OpDmx");
+            check(bigEndian16(packet, 10) == 14, "Art-Net: Protokollversion");
+            check(quint8(packet.at(12)) == sequence && sequence != 0, "Art-Net: Sequenznummer ungleich 0 je Frame");
+            check(bigEndian16(packet, 16) == dataLength, "Art-Net: Datenlänge");
+            check(packet.size() == 18 + dataLength, "Art-Net: Paketlänge");
+            check(payloadMatches(packet, 18, colors, universe * 170, count), "Art-Net: Farbwerte");
+        }
+
+        if (previousSequence >= 0) {
+            check(sequence == (previousSequence == 255 ? 1 : previousSequence + 1), "Art-Net: Sequenznummer steigt je Frame");
+        }
+        previousSequence = sequence;
+    }
+}
+
+void testDdp(NetworkOutputSender *sender)
+{
+    LoopbackReceiver receiver;
+    if (!receiver.bind()) {
+        check(false, "DDP: Empfänger binden");
+        return;
+    }
+
+    NetworkRGBDevice device(loopbackConfig("ddp-matrix", NetworkRGBDevice::Ddp, DdpLedCount, receiver.port()), sender);
+    check(device.getPacketCount() == 2, "DDP: zwei Pakete");
+
+    QVector<QRgb> colors = testFrame(DdpLedCount, 0);
+    device.setLedColors(colors);
+
+    QList<QByteArray> packets = receiver.receive(2);
+    if (packets.size() != 2) {
+        check(false, "DDP: Pakete empfangen");
+        return;
+    }
+
+    int sequence = quint8(packets.first().at(1));
+    for (const QByteArray &packet : packets) {
+        quint32 byteOffset = bigEndian32(packet, 4);
+        int first = int(byteOffset / 3);
+        int count = first == 0 ? 480 : DdpLedCount - 480;
+        bool last = first + count == DdpLedCount;
+
+        check(byteOffset % 3 == 0 && (first == 0 || first == 480), "DDP: Byte-Offset");
+        check(quint8(packet.at(0)) == (last ? 0x41 : 0x40), "DDP: Push nur im letzten Paket");
+        check(quint8(packet.at(1)) == sequence && (sequence & 0x0F) != 0, "DDP: Sequenznummer 1 - 15 je Frame");
+        check(packet.at(2) == 0x0B && packet.at(3) == 0x01, "DDP: Datentyp und Ziel");
+        check(bigEndian16(packet, 8) == count * 3 && packet.size() == 10 + count * 3, "DDP: Datenlänge");
+        check(payloadMatches(packet, 10, colors, first, count), "DDP: Farbwerte");
+    }
+
+    // Teilaktualisierung: nur der geänderte Bereich, mit eigenem Offset und Push. Der
+    // vorige Frame ist empfangen und wartet daher nicht mehr beim Sender
+    QVector<QRgb> changed = testFrame(DdpLedCount, 1);
+    LedFrameUpdate update;
+    update.encoding = LedFrameUpdate::DirtyRanges;
+    update.colors = changed.constData();
+    update.ledCount = DdpLedCount;
+    update.ranges.append(LedFrameUpdate::Range{ 500, 10 });
+    check(device.setLedUpdate(update), "DDP: Teilaktualisierung angenommen");
+
+    packets = receiver.receive(1);
+    if (packets.size() != 1) {
+        check(false, "DDP: Teilaktualisierung empfangen");
+        return;
+    }
+    const QByteArray &packet = packets.first();
+    check(quint8(packet.at(0)) == 0x41, "DDP: Push in der Teilaktualisierung");
+    check((quint8(packet.at(1)) & 0x0F) == ((sequence & 0x0F) == 15 ? 1 : (sequence & 0x0F) + 1),
+          "DDP: Sequenznummer der Teilaktualisierung");
+    check(bigEndian32(packet, 4) == 500 * 3, "DDP: Offset der Teilaktualisierung");
+    check(bigEndian16(packet, 8) == 30 && packet.size() == 40, "DDP: Länge der Teilaktualisierung");
+    check(payloadMatches(packet, 10, changed, 500, 10), "DDP: Farbwerte der Teilaktualisierung");
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QLoggingCategory::setFilterRules("*.debug=false");
+
+    NetworkOutputSender sender;
+    testE131(&sender);
+    testArtNet(&sender);
+    testDdp(&sender);
+
+    qInfo() << "Gesendete Pakete:" << sender.getSentPacketCount()
+            << "Systemaufrufe:" << sender.getSendCallCount()
+            << "Sendefehler:" << sender.getSendErrorCount();
+    check(sender.getSendErrorCount() == 0, "Keine Sendefehler");
+
+    return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,231 @@
+#include "engine/openrgbserver.h"
+#include "core/devicemanager.h"
+#include "core/rgbcontroller.h"
+#include "testdevice.h"
+#include <QCoreApplication>
+#include <QLoggingCategory>
+#include <QTcpSocket>
+#include <QHostAddress>
+#include <QElapsedTimer>
+#include <QtEndian>
+#include <QDebug>
+#include <functional>
+#include <cstdlib>
+
+namespace {
+
+// Pakettypen des OpenRGB-SDK (siehe openrgbserver.cpp)
+const quint32 RequestControllerCount = 0;
+const quint32 RequestControllerData = 1;
+const quint32 RequestProtocolVersion = 40;
+const quint32 SetClientName = 50;
+const quint32 UpdateLeds = 1050;
+
+const int HeaderSize = 16;
+const int LedCount = 32;
+const int TimeoutMs = 5000;
+
+bool failed = false;
+
+void check(bool condition, const char *message)
+{
+    if (!condition) {
+        qWarning() << "Fehlgeschlagen:" << message;
+        failed = true;
+    }
+}
+
+/**
+ * @brief Lässt die Ereignisschleife laufen, bis die Bedingung erfüllt ist
+ * @return false bei Zeitüberschreitung
+ */
+bool waitFor(const std::function<bool()> &condition)
+{
+    QElapsedTimer timer;
+    timer.start();
+    while (!condition()) {
+        if (timer.elapsed() > TimeoutMs) {
+            return false;
+        }
+        QCoreApplication::processEvents(QEventLoop::AllEvents, 10);
+    }
+    return true;
+}
+
+QByteArray packet(quint32 deviceIndex, quint32 packetId, const QByteArray &payload)
+{
+    char header[HeaderSize] = { 'O', 'R', 'G', 'B' };
+    qToLittleEndian<quint32>(deviceIndex, header + 4);
+    qToLittleEndian<quint32>(packetId, header + 8);
+    qToLittleEndian<quint32>(quint32(payload.size()), header + 12);
+    return QByteArray(header, HeaderSize) + payload;
+}
+
+QByteArray u32(quint32 value)
+{
+    char bytes[4];
+    qToLittleEndian<quint32>(value, bytes);
+    return QByteArray(bytes, 4);
+}
+
+/**
+ * @brief Baut ein UpdateLEDs-Paket: u32 Datengröße, u16 Farbanzahl, Farben (r, g, b, 0)
+ */
+QByteArray updateLeds(const QVector<QRgb> &colors)
+{
+    QByteArray payload(4 + 2 + colors.size() * 4, '\0');
+    char *data = payload.data();
+    qToLittleEndian<quint32>(quint32(payload.size()), data);
+    qToLittleEndian<quint16>(quint16(colors.size()), data + 4);
+    for (int i = 0; i < colors.size(); ++i) {
+        char *color = data + 6 + i * 4;
+        color[0] = char(qRed(colors.at(i)));
+        color[1] = char(qGreen(colors.at(i)));
+        color[2] = char(qBlue(colors.at(i)));
+    }
+    return packet(0, UpdateLeds, payload);
+}
+
+QVector<QRgb> testFrame(int frame)
+{
+    QVector<QRgb> colors(LedCount);
+    for (int led = 0; led < LedCount; ++led) {
+        colors[led] = qRgb((frame * 7 + led) & 0xFF, (frame * 3) & 0xFF, led * 8);
+    }
+    return colors;
+}
+
+/**
+ * @brief Loopback-Client, der Antworten des Servers paketweise liest
+ */
+class LoopbackClient
+{
+public:
+    bool connectTo(quint16 port)
+    {
+        m_socket.connectToHost(QHostAddress::LocalHost, port);
+        return waitFor([this]() { return m_socket.state() == QAbstractSocket::ConnectedState; });
+    }
+
+    void send(const QByteArray &data)
+    {
+        m_socket.write(data);
+        m_socket.flush();
+    }
+
+    /**
+     * @brief Wartet auf das nächste Paket vom Server
+     * @return false bei Zeitüberschreitung oder falschem Pakettyp
+     */
+    bool receive(quint32 expectedId, QByteArray *payload)
+    {
+        bool complete = waitFor([this]() {
+            m_buffer.append(m_socket.readAll());
+            return m_buffer.size() >= HeaderSize
+                && m_buffer.size() >= HeaderSize + int(qFromLittleEndian<quint32>(m_buffer.constData() + 12));
+        });
+        if (!complete || !m_buffer.startsWith("ORGB")) {
+            return false;
+        }
+
+        quint32 packetId = qFromLittleEndian<quint32>(m_buffer.constData() + 8);
+        int size = int(qFromLittleEndian<quint32>(m_buffer.constData() + 12));
+        *payload = m_buffer.mid(HeaderSize, size);
+        m_buffer.remove(0, HeaderSize + size);
+        return packetId == expectedId;
+    }
+
+private:
+    QTcpSocket m_socket;
+    QByteArray m_buffer;
+};
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QLoggingCategory::setFilterRules("*.debug=false");
+
+    DeviceManager deviceManager;
+    RGBController controller;
+    TestDevice strip("loopback-strip", LedCount, "LED Strip");
+    controller.registerDevice(&strip);
+
+    OpenRGBServer server(&deviceManager, &controller);
+    if (!server.listen(0)) {
+        qWarning() << "Server konnte nicht gestartet werden";
+        return EXIT_FAILURE;
+    }
+
+    LoopbackClient client;
+    if (!client.connectTo(server.getPort())) {
+        qWarning() << "Keine Verbindung zum Server";
+        return EXIT_FAILURE;
+    }
+    client.send(packet(0, SetClientName, QByteArray("loopback test") + '\0'));
+
+    // Protokollversion aushandeln
+    QByteArray payload;
+    client.send(packet(0, RequestProtocolVersion, u32(OpenRGBServer::ProtocolVersion)));
+    check(client.receive(RequestProtocolVersion, &payload) && payload.size() == 4
+          && qFromLittleEndian<quint32>(payload.constData()) == OpenRGBServer::ProtocolVersion,
+          "Protokollversion");
+    check(server.getClientCount() == 1, "Anzahl der Clients");
+
+    // Anzahl der Controller
+    client.send(packet(0, RequestControllerCount, QByteArray()));
+    check(client.receive(RequestControllerCount, &payload) && payload.size() == 4
+          && qFromLittleEndian<quint32>(payload.constData()) == 1,
+          "Anzahl der Controller");
+
+    // Controller-Daten: Gesamtgröße, Name und die Farbliste am Ende
+    client.send(packet(0, RequestControllerData, u32(OpenRGBServer::ProtocolVersion)));
+    if (client.receive(RequestControllerData, &payload) && payload.size() > 10) {
+        const char *data = payload.constData();
+        check(qFromLittleEndian<quint32>(data) == quint32(payload.size()), "Größe der Controller-Daten");
+
+        int nameLength = qFromLittleEndian<quint16>(data + 8);
+        check(QByteArray(data + 10, nameLength - 1) == strip.getDisplayName().toUtf8(), "Controller-Name");
+
+        int colorsOffset = payload.size() - LedCount * 4 - 2;
+        check(colorsOffset > 0 && qFromLittleEndian<quint16>(data + colorsOffset) == LedCount, "Anzahl der Farben");
+    } else {
+        check(false, "Controller-Daten");
+    }
+
+    // Viele Frames am Stück: kommen sie im selben Lesevorgang an, werden sie zusammengefasst
+    const int burstFrames = 120;
+    QByteArray burst;
+    for (int frame = 0; frame < burstFrames; ++frame) {
+        burst.append(updateLeds(testFrame(frame)));
+    }
+    client.send(burst);
+
+    bool received = waitFor([&]() { return server.getReceivedUpdateCount() == quint64(burstFrames); });
+    check(received, "Alle UpdateLEDs-Pakete des Bursts empfangen");
+    waitFor([&]() { return strip.getFrame() == testFrame(burstFrames - 1); });
+    check(strip.getFrame() == testFrame(burstFrames - 1), "Letzter Frame des Bursts ausgegeben");
+    check(server.getAppliedFrameCount() >= 1 && server.getAppliedFrameCount() <= server.getReceivedUpdateCount(),
+          "Ausgegebene Frames nach dem Burst");
+
+    // Gestreamt im Takt der Ereignisschleife: jeder Frame wird einzeln ausgegeben
+    const int streamedFrames = 60;
+    for (int frame = 0; frame < streamedFrames; ++frame) {
+        quint64 applied = server.getAppliedFrameCount();
+        client.send(updateLeds(testFrame(burstFrames + frame)));
+        if (!waitFor([&]() { return server.getAppliedFrameCount() > applied; })) {
+            check(false, "Gestreamter Frame nicht ausgegeben");
+            break;
+        }
+        check(strip.getFrame() == testFrame(burstFrames + frame), "Gestreamter Frame");
+    }
+    check(server.getReceivedUpdateCount() == quint64(burstFrames + streamedFrames), "Empfangene Updates gesamt");
+
+    qInfo() << "Empfangen:" << server.getReceivedUpdateCount()
+            << "Ausgegeben:" << server.getAppliedFrameCount()
+            << "Geschrieben:" << strip.getWrites();
+
+    controller.unregisterDevice(&strip);
+    return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,139 @@
+#include "core/outputscheduler.h"
+#include "testdevice.h"
+#include <QCoreApplication>
+#include <QLoggingCategory>
+#include <QElapsedTimer>
+#include <QVector>
+#include <QDebug>
+#include <cstdlib>
+
+namespace {
+
+// Latenz des langsamen Geräts: die übrigen Geräte laufen um so viel im Vorlauf
+const qint64 PresentationDelayUs = OutputScheduler::MaxPresentationDelayUs;
+
+// 1 kHz über eine Sekunde, also weit mehr Frames im Vorlauf als MaxLookaheadDepth
+const qint64 SubmitIntervalUs = 1000;
+const qint64 SubmitDurationUs = 1000000;
+
+// Größte zulässige Pause zwischen zwei Ausgaben; ein Stau liefe auf den ganzen Vorlauf hinaus
+const qint64 MaxGapUs = 50000;
+
+const int LedCount = 16;
+
+bool failed = false;
+
+void check(bool condition, const char *message)
+{
+    if (!condition) {
+        qWarning() << "Fehlgeschlagen:" << message;
+        failed = true;
+    }
+}
+
+// Die Nummer des Frames steckt in der Farbe der LEDs
+QVector<QRgb> numberedFrame(int number)
+{
+    return QVector<QRgb>(LedCount, qRgb((number >> 16) & 0xFF, (number >> 8) & 0xFF, number & 0xFF));
+}
+
+int frameNumber(const QVector<QRgb> &frame)
+{
+    QRgb rgb = frame.first();
+    return (qRed(rgb) << 16) | (qGreen(rgb) << 8) | qBlue(rgb);
+}
+
+struct Output {
+    qint64 timeUs;
+    int number;
+};
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QLoggingCategory::setFilterRules("*.debug=false");
+
+    OutputScheduler scheduler;
+    TestDevice slow("slow-strip", LedCount);
+    TestDevice fast("fast-strip", LedCount);
+    scheduler.addDevice(&slow);
+    scheduler.addDevice(&fast);
+    scheduler.setOutputLatency(&slow, int(PresentationDelayUs));
+    check(scheduler.getPresentationDelayUs() == PresentationDelayUs, "Vorlauf entspricht der Latenz");
+
+    QElapsedTimer clock;
+    QVector<qint64> submitTimes;
+    QVector<Output> outputs;
+    QObject::connect(&scheduler, &OutputScheduler::frameDue, [&](IRGBDevice *device, const QVector<QRgb> &frame) {
+        if (device == &fast) {
+            outputs.append(Output{ clock.nsecsElapsed() / 1000, frameNumber(frame) });
+        }
+    });
+
+    // Frames im Takt von 1 kHz übergeben und dazwischen die Ereignisschleife bedienen
+    clock.start();
+    qint64 nextSubmitUs = 0;
+    while (nextSubmitUs < SubmitDurationUs) {
+        qint64 time = clock.nsecsElapsed() / 1000;
+        if (time >= nextSubmitUs) {
+            submitTimes.append(time);
+            scheduler.submit(&fast, numberedFrame(submitTimes.size() - 1));
+            nextSubmitUs += SubmitIntervalUs;
+        }
+        QCoreApplication::processEvents();
+    }
+
+    // Vorlauf abarbeiten lassen
+    const int lastNumber = submitTimes.size() - 1;
+    QElapsedTimer drain;
+    drain.start();
+    while ((outputs.isEmpty() || outputs.last().number != lastNumber) && drain.elapsed() < 2000) {
+        QCoreApplication::processEvents(QEventLoop::AllEvents, 5);
+    }
+
+    if (outputs.isEmpty()) {
+        qWarning() << "Keine Ausgabe für das schnelle Gerät";
+        return EXIT_FAILURE;
+    }
+
+    check(outputs.first().timeUs <= PresentationDelayUs + MaxGapUs, "Erste Ausgabe nach dem Vorlauf");
+    check(outputs.last().number == lastNumber, "Letzter übergebener Frame ausgegeben");
+
+    qint64 maxGapUs = 0;
+    qint64 maxLatenessUs = 0;
+    bool ordered = true;
+    bool early = false;
+    for (int i = 0; i < outputs.size(); ++i) {
+        const Output &output = outputs.at(i);
+        if (i > 0) {
+            maxGapUs = qMax(maxGapUs, output.timeUs - outputs.at(i - 1).timeUs);
+            ordered = ordered && output.number > outputs.at(i - 1).number;
+        }
+
+        // Jeder Frame erscheint um den Vorlauf verzögert, weder früher noch deutlich später
+        qint64 dueUs = submitTimes.at(output.number) + PresentationDelayUs;
+        early = early || output.timeUs < dueUs;
+        maxLatenessUs = qMax(maxLatenessUs, output.timeUs - dueUs);
+    }
+
+    check(ordered, "Frames in Übergabereihenfolge ausgegeben");
+    check(!early, "Kein Frame vor seinem Zeitpunkt ausgegeben");
+    check(maxGapUs <= MaxGapUs, "Ausgabe stockt nicht");
+    check(maxLatenessUs <= MaxGapUs, "Frames pünktlich ausgegeben");
+
+    OutputScheduler::Statistics statistics = scheduler.getStatistics(&fast);
+    check(statistics.overflowFrames > 0, "Vorlauf wurde ausgedünnt");
+    check(statistics.submittedFrames == quint64(submitTimes.size()), "Alle Frames übergeben");
+
+    qInfo() << "Übergeben:" << statistics.submittedFrames
+            << "Ausgegeben:" << outputs.size()
+            << "Ausgedünnt:" << statistics.overflowFrames
+            << "Größte Pause:" << maxGapUs << "us"
+            << "Größte Verspätung:" << maxLatenessUs << "us";
+
+    scheduler.removeDevice(&fast);
+    scheduler.removeDevice(&slow);
+    return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
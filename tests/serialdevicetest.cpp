@@ -0,0 +1,239 @@
+#include "devices/serialrgbdevice.h"
+#include <QCoreApplication>
+#include <QLoggingCategory>
+#include <QElapsedTimer>
+#include <QDebug>
+#include <functional>
+#include <cstdlib>
+
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#ifdef Q_OS_MACOS
+#include <util.h>
+#else
+#include <pty.h>
+#endif
+
+namespace {
+
+const int TimeoutMs = 5000;
+
+// 300 LEDs: die LED-Anzahl belegt beide Bytes des Kopfes
+const int LedCount = 300;
+const int HeaderSize = 6;
+const int FrameSize = HeaderSize + LedCount * 3;
+const int BaudRate = 230400;
+
+// Dauer des Streaming-Abschnitts
+const int StreamMs = 600;
+
+bool failed = false;
+
+void check(bool condition, const char *message)
+{
+    if (!condition) {
+        qWarning() << "Fehlgeschlagen:" << message;
+        failed = true;
+    }
+}
+
+/**
+ * @brief Lässt die Ereignisschleife laufen, bis die Bedingung erfüllt ist
+ * @return false bei Zeitüberschreitung
+ */
+bool waitFor(const std::function<bool()> &condition)
+{
+    QElapsedTimer timer;
+    timer.start();
+    while (!condition()) {
+        if (timer.elapsed() > TimeoutMs) {
+            return false;
+        }
+        QCoreApplication::processEvents(QEventLoop::AllEvents, 10);
+    }
+    return true;
+}
+
+QVector<QRgb> testFrame(int frame)
+{
+    QVector<QRgb> colors(LedCount);
+    for (int led = 0; led < LedCount; ++led) {
+        colors[led] = qRgb((frame * 13 + led) & 0xFF, frame & 0xFF, (led * 3) & 0xFF);
+    }
+    return colors;
+}
+
+QByteArray adalightFrame(const QVector<QRgb> &colors)
+{
+    quint8 high = quint8((LedCount - 1) >> 8);
+    quint8 low = quint8((LedCount - 1) & 0xFF);
+    QByteArray frame("Ada");
+    frame.append(char(high));
+    frame.append(char(low));
+    frame.append(char(high ^ low ^ 0x55));
+    for (QRgb rgb : colors) {
+        frame.append(char(qRed(rgb)));
+        frame.append(char(qGreen(rgb)));
+        frame.append(char(qBlue(rgb)));
+    }
+    return frame;
+}
+
+/**
+ * @brief Pseudo-Terminal, dessen Gegenseite das Gerät als serielle Schnittstelle öffnet
+ */
+class PtyReceiver
+{
+public:
+    PtyReceiver()
+        : m_master(-1)
+        , m_slave(-1)
+    {
+    }
+
+    ~PtyReceiver()
+    {
+        if (m_master >= 0) {
+            ::close(m_master);
+        }
+        if (m_slave >= 0) {
+            ::close(m_slave);
+        }
+    }
+
+    bool open()
+    {
+        char name[256] = {};
+        if (openpty(&m_master, &m_slave, name, nullptr, nullptr) != 0) {
+            qWarning() << "openpty fehlgeschlagen:" << strerror(errno);
+            return false;
+        }
+        m_portName = QString::fromLocal8Bit(name);
+        return fcntl(m_master, F_SETFL, fcntl(m_master, F_GETFL) | O_NONBLOCK) == 0;
+    }
+
+    QString portName() const
+    {
+        return m_portName;
+    }
+
+    /**
+     * @brief Liest alles, was das Gerät bisher geschrieben hat
+     * @return Anzahl der insgesamt empfangenen Bytes
+     */
+    int poll()
+    {
+        char buffer[4096];
+        ssize_t count;
+        while ((count = ::read(m_master, buffer, sizeof(buffer))) > 0) {
+            m_received.append(buffer, int(count));
+        }
+        return m_received.size();
+    }
+
+    QByteArray takeReceived()
+    {
+        poll();
+        QByteArray received = m_received;
+        m_received.clear();
+        return received;
+    }
+
+private:
+    int m_master;
+    int m_slave;
+    QString m_portName;
+    QByteArray m_received;
+};
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QLoggingCategory::setFilterRules("*.debug=false");
+
+    PtyReceiver pty;
+    if (!pty.open()) {
+        return EXIT_FAILURE;
+    }
+
+    SerialRGBDevice::Config config;
+    config.id = "pty-strip";
+    config.name = "Pty";
+    config.portName = pty.portName();
+    config.baudRate = BaudRate;
+    config.ledCount = LedCount;
+
+    SerialRGBDevice device(config);
+    if (!device.open()) {
+        qWarning() << "Gerät konnte" << pty.portName() << "nicht öffnen";
+        return EXIT_FAILURE;
+    }
+    check(device.getFrameDurationUs() == qint64(FrameSize) * 10 * 1000000 / BaudRate, "Frame-Dauer aus der Baudrate");
+
+    // Kopf, Prüfsumme und Farbwerte eines einzelnen Frames
+    device.setLedColors(testFrame(0));
+    waitFor([&]() { return pty.poll() >= FrameSize; });
+    QByteArray received = pty.takeReceived();
+    check(received == adalightFrame(testFrame(0)), "Adalight-Kopf, Prüfsumme und Farbwerte");
+    check(quint8(received.at(3)) == 0x01 && quint8(received.at(4)) == 0x2B && quint8(received.at(5)) == 0x7F,
+          "LED-Anzahl minus eins und Prüfsumme 0x55");
+
+    // Innerhalb einer Frame-Dauer: der erste Frame wird geschrieben, die folgenden ersetzen
+    // sich gegenseitig und nur der neueste folgt nach Ablauf der Frame-Dauer
+    QElapsedTimer idle;
+    idle.start();
+    waitFor([&]() { return idle.nsecsElapsed() / 1000 > device.getFrameDurationUs(); });
+    quint64 written = device.getWrittenFrameCount();
+    quint64 replaced = device.getReplacedFrameCount();
+    for (int frame = 1; frame <= 4; ++frame) {
+        device.setLedColors(testFrame(frame));
+    }
+    check(device.getReplacedFrameCount() == replaced + 2, "Neuester Frame ersetzt den wartenden");
+    waitFor([&]() { return device.getWrittenFrameCount() == written + 2; });
+    waitFor([&]() { return pty.poll() >= 2 * FrameSize; });
+    received = pty.takeReceived();
+    check(received == adalightFrame(testFrame(1)) + adalightFrame(testFrame(4)),
+          "Nur der erste und der neueste Frame geschrieben");
+
+    // Streaming deutlich schneller als die Leitung: zu keinem Zeitpunkt mehr Frames
+    // begonnen, als die Leitung seit Beginn übertragen konnte, plus der laufende
+    QElapsedTimer stream;
+    stream.start();
+    written = device.getWrittenFrameCount();
+    replaced = device.getReplacedFrameCount();
+    int submitted = 0;
+    bool paced = true;
+    while (stream.elapsed() < StreamMs) {
+        device.setLedColors(testFrame(100 + submitted++));
+        QCoreApplication::processEvents(QEventLoop::AllEvents, 1);
+        pty.poll();
+
+        qint64 allowed = stream.nsecsElapsed() / 1000 / device.getFrameDurationUs() + 1;
+        if (qint64(device.getWrittenFrameCount() - written) > allowed) {
+            paced = false;
+        }
+    }
+    check(paced, "Pacing: höchstens ein Frame unterwegs");
+
+    // Der zuletzt übergebene Frame kommt immer an, alle übrigen wurden ersetzt
+    waitFor([&]() { return device.getWrittenFrameCount() - written + device.getReplacedFrameCount() - replaced
+                           == quint64(submitted); });
+    quint64 streamed = device.getWrittenFrameCount() - written;
+    check(streamed + device.getReplacedFrameCount() - replaced == quint64(submitted),
+          "Jeder Frame geschrieben oder ersetzt");
+    waitFor([&]() { return pty.poll() >= int(streamed) * FrameSize; });
+    received = pty.takeReceived();
+    check(received.size() == int(streamed) * FrameSize, "Empfangene Bytes entsprechen den geschriebenen Frames");
+    check(received.endsWith(adalightFrame(testFrame(100 + submitted - 1))), "Letzter Frame geschrieben");
+
+    qInfo() << "Übergeben:" << submitted << "Geschrieben:" << streamed
+            << "Ersetzt:" << device.getReplacedFrameCount() - replaced
+            << "Frame-Dauer:" << device.getFrameDurationUs() << "us";
+
+    device.close();
+    return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
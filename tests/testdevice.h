@@ -0,0 +1,74 @@
+#pragma once
+
+#include "devices/irgbdevice.h"
+#include <QString>
+#include <QColor>
+#include <QVector>
+#include <QVariantMap>
+
+/**
+ * @brief Gerät ohne Hardware für Tests
+ *
+ * Merkt sich den zuletzt geschriebenen Frame und zählt die Schreibvorgänge.
+ */
+class TestDevice : public IRGBDevice
+{
+public:
+    TestDevice(const QString &id, int ledCount, const QString &type = QStringLiteral("Test"))
+        : m_id(id)
+        , m_type(type)
+        , m_ledCount(ledCount)
+        , m_writes(0)
+    {
+    }
+
+    QString getId() const override { return m_id; }
+    QString getDisplayName() const override { return m_id; }
+    QString getType() const override { return m_type; }
+    int getLedCount() const override { return m_ledCount; }
+
+    bool setColor(const QColor &color) override
+    {
+        m_color = color;
+        m_frame.fill(color.rgb(), m_ledCount);
+        m_writes++;
+        return true;
+    }
+
+    bool setLedColors(const QVector<QRgb> &colors) override
+    {
+        if (colors.isEmpty()) {
+            return false;
+        }
+        m_color = QColor::fromRgb(colors.first());
+        m_frame = colors;
+        m_writes++;
+        return true;
+    }
+
+    QColor getColor() const override { return m_color; }
+    bool setEffect(const QString &, const QVariantMap &) override { return false; }
+    QString getActiveEffect() const override { return QString(); }
+    QVariantMap getEffectParameters() const override { return QVariantMap(); }
+    bool isConnected() const override { return true; }
+
+    /**
+     * @brief Gibt den zuletzt geschriebenen Frame zurück
+     * @return Eine Farbe pro LED
+     */
+    const QVector<QRgb> &getFrame() const { return m_frame; }
+
+    /**
+     * @brief Gibt die Anzahl der Schreibvorgänge zurück
+     * @return Anzahl der Aufrufe von setColor() und setLedColors()
+     */
+    quint64 getWrites() const { return m_writes; }
+
+private:
+    QString m_id;
+    QString m_type;
+    int m_ledCount;
+    QColor m_color;
+    QVector<QRgb> m_frame;
+    quint64 m_writes;
+};